@@ -25,6 +25,7 @@
 #include "FrameBufferGL.hxx"
 #include "TIA.hxx"
 #include "NTSCFilter.hxx"
+#include "PaletteExpand.hxx"
 
 #include "FBSurfaceTIA.hxx"
 
@@ -36,6 +37,7 @@ FBSurfaceTIA::FBSurfaceTIA(FrameBufferGL& buffer)
     myVBOID(0),
     myBaseW(0),
     myBaseH(0),
+    myRedrawTIA(true),
     myScanlinesEnabled(false),
     myScanlineIntensityI(50),
     myScanlineIntensityF(0.5)
@@ -82,62 +84,72 @@ void FBSurfaceTIA::translateCoords(Int32& x, Int32& y) const
 void FBSurfaceTIA::update()
 {
   // Copy the mediasource framebuffer to the RGB texture
-  // In OpenGL mode, it's faster to just assume that the screen is dirty
-  // and always do an update
+  // The texture is still redrawn to the screen every frame, but only those
+  // lines which have changed are converted and uploaded again
 
   uInt8* currentFrame  = myTIA->currentFrameBuffer();
-  uInt8* previousFrame = myTIA->previousFrameBuffer();
   uInt32 width         = myTIA->width();
   uInt32 height        = myTIA->height();
   uInt32* buffer       = (uInt32*) myTexture->pixels;
 
-  // TODO - Eventually 'phosphor' won't be a separate mode, and will become
-  //        a post-processing filter by blending several frames.
+  // The range of lines changed in the texture (top inclusive, bottom not)
+  uInt32 top = 0, bottom = height;
+
+  // The phosphor modes draw the frame as usual, then blend it with the
+  // previous ones; since every pixel may fade, all lines are redrawn
   switch(myFB.myFilterType)
   {
     case FrameBufferGL::kNormal:
     {
-      uInt32 bufofsY    = 0;
-      uInt32 screenofsY = 0;
-      for(uInt32 y = 0; y < height; ++y)
+      if(myRedrawTIA)
       {
-        uInt32 pos = screenofsY;
-        for(uInt32 x = 0; x < width; ++x)
-          buffer[pos++] = (uInt32) myFB.myDefPalette[currentFrame[bufofsY + x]];
-
-        bufofsY    += width;
-        screenofsY += myPitch;
+        Common::PaletteExpand::expand(buffer, myPitch, currentFrame, width,
+                                      width, height, myFB.myDefPalette);
+        break;
+      }
+      top = height;  bottom = 0;
+      for(uInt32 y = 0, n; (n = myTIA->nextDirtyLines(y)) > 0; y += n)
+      {
+        Common::PaletteExpand::expand(buffer + y * myPitch, myPitch,
+                                      currentFrame + y * width, width,
+                                      width, n, myFB.myDefPalette);
+        top = BSPF_min(top, y);  bottom = y + n;
       }
       break;
     }
     case FrameBufferGL::kPhosphor:
     {
-      uInt32 bufofsY    = 0;
-      uInt32 screenofsY = 0;
-      for(uInt32 y = 0; y < height; ++y)
-      {
-        uInt32 pos = screenofsY;
-        for(uInt32 x = 0; x < width; ++x)
-        {
-          const uInt32 bufofs = bufofsY + x;
-          buffer[pos++] = (uInt32)
-            myFB.myAvgPalette[currentFrame[bufofs]][previousFrame[bufofs]];
-        }
-        bufofsY    += width;
-        screenofsY += myPitch;
-      }
+      Common::PaletteExpand::expand(buffer, myPitch, currentFrame, width,
+                                    width, height, myFB.myDefPalette);
+      myFB.myPhosphor.blend(buffer, myPitch, width, height);
+      myRedrawTIA = true;
       break;
     }
     case FrameBufferGL::kBlarggNormal:
     {
-      myFB.myNTSCFilter.blit_single(currentFrame, width, height,
-                                    buffer, myTexture->pitch);
+      // The filter works on each line independently, so it can also be
+      // applied to only the lines which have changed
+      if(myRedrawTIA)
+      {
+        myFB.myNTSCFilter.blit_single(currentFrame, width, height,
+                                      buffer, myTexture->pitch);
+        break;
+      }
+      top = height;  bottom = 0;
+      for(uInt32 y = 0, n; (n = myTIA->nextDirtyLines(y)) > 0; y += n)
+      {
+        myFB.myNTSCFilter.blit_single(currentFrame + y * width, width, n,
+                                      buffer + y * myPitch, myTexture->pitch);
+        top = BSPF_min(top, y);  bottom = y + n;
+      }
       break;
     }
     case FrameBufferGL::kBlarggPhosphor:
     {
-      myFB.myNTSCFilter.blit_double(currentFrame, previousFrame, width, height,
+      myFB.myNTSCFilter.blit_single(currentFrame, width, height,
                                     buffer, myTexture->pitch);
+      myFB.myPhosphor.blend(buffer, myPitch, ATARI_NTSC_OUT_WIDTH(width), height);
+      myRedrawTIA = true;
       break;
     }
   }
@@ -150,9 +162,15 @@ void FBSurfaceTIA::update()
   myGL.BindTexture(GL_TEXTURE_2D, myTexID[0]);
   myGL.PixelStorei(GL_UNPACK_ALIGNMENT, 1);
   myGL.PixelStorei(GL_UNPACK_ROW_LENGTH, myPitch);
-  myGL.TexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, myBaseW, myBaseH,
-                    GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV,
-                    myTexture->pixels);
+  if(myRedrawTIA)
+    myGL.TexSubImage2D(GL_TEXTURE_2D, 0, 0, 0, myBaseW, myBaseH,
+                      GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV,
+                      myTexture->pixels);
+  else if(top < bottom)
+    myGL.TexSubImage2D(GL_TEXTURE_2D, 0, 0, top, myBaseW, bottom - top,
+                      GL_BGRA, GL_UNSIGNED_INT_8_8_8_8_REV,
+                      (uInt32*)myTexture->pixels + top * myPitch);
+  myRedrawTIA = false;
 
   if(myFB.myVBOAvailable)
   {
@@ -203,6 +221,7 @@ void FBSurfaceTIA::update()
 void FBSurfaceTIA::invalidate()
 {
   SDL_FillRect(myTexture, NULL, 0);
+  myRedrawTIA = true;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -224,6 +243,7 @@ void FBSurfaceTIA::reload()
   // to be regenerated)
   // Basically, all that needs to be done is to re-call glTexImage2D with a
   // new texture ID, so that's what we do here
+  myRedrawTIA = true;
 
   myGL.ActiveTexture(GL_TEXTURE0);
   myGL.Enable(GL_TEXTURE_2D);
@@ -314,6 +334,7 @@ void FBSurfaceTIA::updateCoords()
   // Normal TIA rendering and TV effects use different widths
   // We use the same buffer, and only pick the width we need
   myBaseW = myFB.ntscEnabled() ? ATARI_NTSC_OUT_WIDTH(160) : 160;
+  myRedrawTIA = true;
 
   myTexCoordW = (GLfloat) myBaseW / myTexWidth;
   myTexCoordH = (GLfloat) myBaseH / myTexHeight;
@@ -386,10 +407,23 @@ void FBSurfaceTIA::updateCoords()
   }
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool FBSurfaceTIA::phosphorPixel(uInt32 idx, uInt32& pixel) const
+{
+  // Only the unfiltered image can be read back at TIA resolution
+  if(myFB.myFilterType != FrameBufferGL::kPhosphor || myTIA == NULL)
+    return false;
+
+  uInt32 width = myTIA->width();
+  pixel = ((const uInt32*) myTexture->pixels)[idx / width * myPitch + idx % width];
+  return true;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void FBSurfaceTIA::setTIAPalette(const uInt32* palette)
 {
-  myFB.myNTSCFilter.setTIAPalette(myFB, palette);
+  myFB.myNTSCFilter.setTIAPalette(myFB.myPhosphor, palette);
+  myRedrawTIA = true;
 }
 
 #endif
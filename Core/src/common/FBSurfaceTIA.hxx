@@ -56,7 +56,9 @@ class FBSurfaceTIA : public FBSurface
 
   private:
     void setTIA(const TIA& tia) { myTIA = &tia; }
+    void setRedrawTIA() { myRedrawTIA = true; }
     void setTIAPalette(const uInt32* palette);
+    bool phosphorPixel(uInt32 idx, uInt32& pixel) const;
     void enableScanlines(bool enable) { myScanlinesEnabled = enable; }
     void setScanIntensity(uInt32 intensity);
     void setTexInterpolation(bool enable);
@@ -80,6 +82,10 @@ class FBSurfaceTIA : public FBSurface
     GLfloat myCoord[32];
     GLint myTexFilter[2];
 
+    // Indicates that the entire texture must be regenerated on the next
+    // update, rather than only the lines the TIA reports as changed
+    bool myRedrawTIA;
+
     bool myScanlinesEnabled;
     GLuint  myScanlineIntensityI;
     GLfloat myScanlineIntensityF;
@@ -340,6 +340,8 @@ void FrameBufferGL::invalidate()
 void FrameBufferGL::drawTIA(bool fullRedraw)
 {
   // The TIA surface takes all responsibility for drawing
+  if(fullRedraw)
+    myTiaSurface->setRedrawTIA();
   myTiaSurface->update();
 }
 
@@ -361,11 +363,20 @@ void FrameBufferGL::enablePhosphor(bool enable, int blend)
   {
     myUsePhosphor   = enable;
     myPhosphorBlend = blend;
+    myPhosphor.setBlend(blend);
+    myPhosphor.setMode(Common::PhosphorBlend::modeFromString(
+        myOSystem->settings().getString("tv_phosphor")));
     myFilterType = FilterType(enable ? myFilterType | 0x01 : myFilterType & 0x10);
     myRedrawEntireFrame = true;
   }
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool FrameBufferGL::phosphorPixel(uInt32 idx, uInt32& pixel) const
+{
+  return myTiaSurface && myTiaSurface->phosphorPixel(idx, pixel);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void FrameBufferGL::enableNTSC(bool enable)
 {
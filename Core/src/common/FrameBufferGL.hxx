@@ -33,6 +33,7 @@ class TIA;
 
 #include "bspf.hxx"
 #include "FrameBuffer.hxx"
+#include "PhosphorBlend.hxx"
 
 /**
   This class implements an SDL OpenGL framebuffer.
@@ -73,6 +74,12 @@ class FrameBufferGL : public FrameBuffer
     */
     void enablePhosphor(bool enable, int blend);
 
+    /**
+      Get the pixel at the given TIA buffer index as last shown with the
+      phosphor effect (only available without NTSC filtering).
+    */
+    bool phosphorPixel(uInt32 idx, uInt32& pixel) const;
+
     /**
       Enable/disable NTSC filtering effects.
     */
@@ -221,6 +228,9 @@ class FrameBufferGL : public FrameBuffer
     // since Dialog surfaces are allocated by the Dialog class directly).
     FBSurfaceTIA* myTiaSurface;
 
+    // Blends each TIA frame with the previous ones in the phosphor modes
+    Common::PhosphorBlend myPhosphor;
+
     // Used by mapRGB (when palettes are created)
     SDL_PixelFormat myPixelFormat;
 
@@ -28,6 +28,7 @@
 #include "RectList.hxx"
 #include "Settings.hxx"
 #include "TIA.hxx"
+#include "PaletteExpand.hxx"
 
 #include "FrameBufferSoft.hxx"
 
@@ -38,7 +39,8 @@ FrameBufferSoft::FrameBufferSoft(OSystem* osystem)
     myRenderType(kSoftZoom_16),
     myTiaDirty(false),
     myInUIMode(false),
-    myRectList(NULL)
+    myRectList(NULL),
+    myPhosphorBuffer(NULL)
 {
 }
 
@@ -46,6 +48,7 @@ FrameBufferSoft::FrameBufferSoft(OSystem* osystem)
 FrameBufferSoft::~FrameBufferSoft()
 {
   delete myRectList;
+  delete[] myPhosphorBuffer;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -172,6 +175,14 @@ void FrameBufferSoft::drawTIA(bool fullRedraw)
       uInt32 screenofsY = 0;
       for(uInt32 y = 0; y < height; ++y)
       {
+        // Lines the TIA reports as unchanged need not be examined at all
+        if(!fullRedraw && !tia.isLineDirty(y))
+        {
+          screenofsY += myPitch * myZoomLevel;
+          bufofsY += width;
+          continue;
+        }
+
         uInt32 ystride = myZoomLevel;
         while(ystride--)
         {
@@ -212,6 +223,14 @@ void FrameBufferSoft::drawTIA(bool fullRedraw)
       uInt32 screenofsY = 0;
       for(uInt32 y = 0; y < height; ++y)
       {
+        // Lines the TIA reports as unchanged need not be examined at all
+        if(!fullRedraw && !tia.isLineDirty(y))
+        {
+          screenofsY += myPitch * myZoomLevel;
+          bufofsY += width;
+          continue;
+        }
+
         uInt32 ystride = myZoomLevel;
         while(ystride--)
         {
@@ -252,10 +271,30 @@ void FrameBufferSoft::drawTIA(bool fullRedraw)
     {
       SDL_LockSurface(myScreen);
       uInt32* buffer    = (uInt32*)myScreen->pixels + myBaseOffset;
+
+      // At zoom level 1 each pixel is simply doubled horizontally, so a
+      // full redraw can use the faster palette expansion
+      if(fullRedraw && myZoomLevel == 1)
+      {
+        Common::PaletteExpand::expand(buffer, myPitch, currentFrame, width,
+                                      width, height, myDefPalette, true);
+        myTiaDirty = true;
+        SDL_UnlockSurface(myScreen);
+        break;
+      }
+
       uInt32 bufofsY    = 0;
       uInt32 screenofsY = 0;
       for(uInt32 y = 0; y < height; ++y)
       {
+        // Lines the TIA reports as unchanged need not be examined at all
+        if(!fullRedraw && !tia.isLineDirty(y))
+        {
+          screenofsY += myPitch * myZoomLevel;
+          bufofsY += width;
+          continue;
+        }
+
         uInt32 ystride = myZoomLevel;
         while(ystride--)
         {
@@ -290,6 +329,9 @@ void FrameBufferSoft::drawTIA(bool fullRedraw)
 
     case kPhosphor_16:
     {
+      // The 24-bit palette bytes are blended, and then mapped to 16 bits
+      const uInt32* blended = blendPhosphor(true);
+
       SDL_LockSurface(myScreen);
       uInt16* buffer    = (uInt16*)myScreen->pixels + myBaseOffset;
       uInt32 bufofsY    = 0;
@@ -300,18 +342,27 @@ void FrameBufferSoft::drawTIA(bool fullRedraw)
         while(ystride--)
         {
           uInt32 pos = screenofsY;
+          uInt32 lastRGB = ~0u;
+          uInt16 pixel = 0;
           for(uInt32 x = 0; x < width; ++x)
           {
-            const uInt32 bufofs = bufofsY + x;
             uInt32 xstride = myZoomLevel;
 
-            uInt8 v = currentFrame[bufofs];
-            uInt8 w = previousFrame[bufofs];
+            // Most pixels are the same color as the one before them, so
+            // only map each new color
+            uInt32 rgb = blended[bufofsY + x];
+            if(rgb != lastRGB)
+            {
+              uInt8 a = rgb & 0xff, b = (rgb >> 8) & 0xff, c = (rgb >> 16) & 0xff;
+              pixel = (uInt16) (SDL_BYTEORDER == SDL_LIL_ENDIAN ?
+                                mapRGB(c, b, a) : mapRGB(a, b, c));
+              lastRGB = rgb;
+            }
 
             while(xstride--)
             {
-              buffer[pos++] = (uInt16) myAvgPalette[v][w];
-              buffer[pos++] = (uInt16) myAvgPalette[v][w];
+              buffer[pos++] = pixel;
+              buffer[pos++] = pixel;
             }
           }
           screenofsY += myPitch;
@@ -325,6 +376,8 @@ void FrameBufferSoft::drawTIA(bool fullRedraw)
 
     case kPhosphor_24:
     {
+      const uInt32* blended = blendPhosphor(true);
+
       SDL_LockSurface(myScreen);
       uInt8* buffer     = (uInt8*)myScreen->pixels + myBaseOffset;
       uInt32 bufofsY    = 0;
@@ -337,25 +390,10 @@ void FrameBufferSoft::drawTIA(bool fullRedraw)
           uInt32 pos = screenofsY;
           for(uInt32 x = 0; x < width; ++x)
           {
-            const uInt32 bufofs = bufofsY + x;
             uInt32 xstride = myZoomLevel;
 
-            uInt8 v = currentFrame[bufofs];
-            uInt8 w = previousFrame[bufofs];
-            uInt8 a, b, c;
-            uInt32 pixel = myAvgPalette[v][w];
-            if(SDL_BYTEORDER == SDL_LIL_ENDIAN)
-            {
-              a = (pixel & myFormat->Bmask) >> myFormat->Bshift;
-              b = (pixel & myFormat->Gmask) >> myFormat->Gshift;
-              c = (pixel & myFormat->Rmask) >> myFormat->Rshift;
-            }
-            else
-            {
-              a = (pixel & myFormat->Rmask) >> myFormat->Rshift;
-              b = (pixel & myFormat->Gmask) >> myFormat->Gshift;
-              c = (pixel & myFormat->Bmask) >> myFormat->Bshift;
-            }
+            uInt32 pixel = blended[bufofsY + x];
+            uInt8 a = pixel & 0xff, b = (pixel >> 8) & 0xff, c = (pixel >> 16) & 0xff;
 
             while(xstride--)
             {
@@ -374,6 +412,8 @@ void FrameBufferSoft::drawTIA(bool fullRedraw)
 
     case kPhosphor_32:
     {
+      const uInt32* blended = blendPhosphor(false);
+
       SDL_LockSurface(myScreen);
       uInt32* buffer    = (uInt32*)myScreen->pixels + myBaseOffset;
       uInt32 bufofsY    = 0;
@@ -386,16 +426,13 @@ void FrameBufferSoft::drawTIA(bool fullRedraw)
           uInt32 pos = screenofsY;
           for(uInt32 x = 0; x < width; ++x)
           {
-            const uInt32 bufofs = bufofsY + x;
             uInt32 xstride = myZoomLevel;
-
-            uInt8 v = currentFrame[bufofs];
-            uInt8 w = previousFrame[bufofs];
+            uInt32 pixel = blended[bufofsY + x];
 
             while(xstride--)
             {
-              buffer[pos++] = (uInt32) myAvgPalette[v][w];
-              buffer[pos++] = (uInt32) myAvgPalette[v][w];
+              buffer[pos++] = pixel;
+              buffer[pos++] = pixel;
             }
           }
           screenofsY += myPitch;
@@ -425,11 +462,44 @@ void FrameBufferSoft::postFrameUpdate()
   myRectList->start();
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const uInt32* FrameBufferSoft::blendPhosphor(bool use24)
+{
+  const TIA& tia = myOSystem->console().tia();
+  uInt32 width  = tia.width();
+  uInt32 height = tia.height();
+
+  if(myPhosphorBuffer == NULL)
+    myPhosphorBuffer = new uInt32[160 * 320];
+
+  // The bytes of each 24-bit palette entry are blended as a 32-bit pixel,
+  // keeping the order in which they're written to the screen
+  uInt32 palette24[256];
+  const uInt32* palette = myDefPalette;
+  if(use24)
+  {
+    for(uInt32 i = 0; i < 256; ++i)
+      palette24[i] = myDefPalette24[i][0] | (myDefPalette24[i][1] << 8) |
+                     (myDefPalette24[i][2] << 16);
+    palette = palette24;
+  }
+
+  Common::PaletteExpand::expand(myPhosphorBuffer, width,
+                                tia.currentFrameBuffer(), width,
+                                width, height, palette);
+  myPhosphor.blend(myPhosphorBuffer, width, width, height);
+
+  return myPhosphorBuffer;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void FrameBufferSoft::enablePhosphor(bool enable, int blend)
 {
   myUsePhosphor   = enable;
   myPhosphorBlend = blend;
+  myPhosphor.setBlend(blend);
+  myPhosphor.setMode(Common::PhosphorBlend::modeFromString(
+      myOSystem->settings().getString("tv_phosphor")));
 
   // Make sure drawMediaSource() knows which renderer to use
   switch(myBytesPerPixel)
@@ -447,6 +517,22 @@ void FrameBufferSoft::enablePhosphor(bool enable, int blend)
   myRedrawEntireFrame = true;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool FrameBufferSoft::phosphorPixel(uInt32 idx, uInt32& pixel) const
+{
+  if(myPhosphorBuffer == NULL || myRenderType < kPhosphor_16)
+    return false;
+
+  // In 16 and 24-bit modes, the buffer holds the 24-bit palette bytes
+  pixel = myPhosphorBuffer[idx];
+  if(myRenderType != kPhosphor_32)
+  {
+    uInt8 a = pixel & 0xff, b = (pixel >> 8) & 0xff, c = (pixel >> 16) & 0xff;
+    pixel = SDL_BYTEORDER == SDL_LIL_ENDIAN ? mapRGB(c, b, a) : mapRGB(a, b, c);
+  }
+  return true;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 FBSurface* FrameBufferSoft::createSurface(int w, int h, bool isBase) const
 {
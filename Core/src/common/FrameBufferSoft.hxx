@@ -27,6 +27,7 @@ class RectList;
 
 #include "bspf.hxx"
 #include "FrameBuffer.hxx"
+#include "PhosphorBlend.hxx"
 
 
 /**
@@ -58,6 +59,12 @@ class FrameBufferSoft : public FrameBuffer
     */
     void enablePhosphor(bool enable, int blend);
 
+    /**
+      Get the pixel at the given TIA buffer index as last shown with the
+      phosphor effect.
+    */
+    bool phosphorPixel(uInt32 idx, uInt32& pixel) const;
+
     /**
       This method is called to retrieve the R/G/B data from the given pixel.
 
@@ -149,6 +156,11 @@ class FrameBufferSoft : public FrameBuffer
     */
     string about() const;
 
+  private:
+    // Convert the current TIA frame to 32-bit pixels, using either the
+    // normal or the 24-bit palette, and blend it with the previous frames
+    const uInt32* blendPhosphor(bool use24);
+
   private:
     int myZoomLevel;
     int myBytesPerPixel;
@@ -174,6 +186,13 @@ class FrameBufferSoft : public FrameBuffer
 
     // Used in the dirty update of rectangles in non-TIA modes
     RectList* myRectList;
+
+    // Blends each TIA frame with the previous ones in the phosphor modes
+    Common::PhosphorBlend myPhosphor;
+
+    // The blended TIA frame, as 32-bit pixels (in 16 and 24-bit modes,
+    // these hold the three bytes of the 24-bit palette)
+    uInt32* myPhosphorBuffer;
 };
 
 /**
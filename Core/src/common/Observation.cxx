@@ -0,0 +1,239 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2014 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//
+// $Id$
+//============================================================================
+
+#include <cstring>
+
+#include "Observation.hxx"
+
+// The vector versions are only built for x86 compilers that can generate
+// code for instruction sets not enabled for the rest of the program
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__clang__) || (defined(__GNUC__) && \
+     (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))))
+  #define OBSERVATION_X86
+  #include <immintrin.h>
+#endif
+
+namespace Common {
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+static void addLine(uInt16* sums, const uInt8* a, const uInt8* b, uInt32 width)
+{
+  for(uInt32 x = 0; x < width; ++x)
+    sums[x] += a[x] > b[x] ? a[x] : b[x];
+}
+
+#ifdef OBSERVATION_X86
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+__attribute__((target("sse2")))
+static void addLineSSE2(uInt16* sums, const uInt8* a, const uInt8* b,
+                        uInt32 width)
+{
+  const __m128i zero = _mm_setzero_si128();
+  uInt32 x = 0;
+  for(; x + 16 <= width; x += 16)
+  {
+    __m128i m = _mm_max_epu8(_mm_loadu_si128((const __m128i*)(a + x)),
+                             _mm_loadu_si128((const __m128i*)(b + x)));
+    __m128i lo = _mm_loadu_si128((const __m128i*)(sums + x));
+    __m128i hi = _mm_loadu_si128((const __m128i*)(sums + x + 8));
+
+    _mm_storeu_si128((__m128i*)(sums + x),
+                     _mm_add_epi16(lo, _mm_unpacklo_epi8(m, zero)));
+    _mm_storeu_si128((__m128i*)(sums + x + 8),
+                     _mm_add_epi16(hi, _mm_unpackhi_epi8(m, zero)));
+  }
+  addLine(sums + x, a + x, b + x, width - x);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+__attribute__((target("avx2")))
+static void addLineAVX2(uInt16* sums, const uInt8* a, const uInt8* b,
+                        uInt32 width)
+{
+  uInt32 x = 0;
+  for(; x + 16 <= width; x += 16)
+  {
+    // Widening 16 bytes to 16 words keeps them in order, unlike unpacking
+    // within the 128-bit lanes
+    __m128i m = _mm_max_epu8(_mm_loadu_si128((const __m128i*)(a + x)),
+                             _mm_loadu_si128((const __m128i*)(b + x)));
+    __m256i s = _mm256_loadu_si256((const __m256i*)(sums + x));
+
+    _mm256_storeu_si256((__m256i*)(sums + x),
+                        _mm256_add_epi16(s, _mm256_cvtepu8_epi16(m)));
+  }
+  addLine(sums + x, a + x, b + x, width - x);
+}
+#endif
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Observation::Observation()
+  : myWidth(0),
+    myHeight(0),
+    myMaxPool(false),
+    mySourceWidth(0)
+{
+  memset(myLuma, 0, sizeof(myLuma));
+  setSize(84, 84);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Observation::~Observation()
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Observation::setPalette(const uInt32* palette)
+{
+  for(uInt32 i = 0; i < 256; ++i)
+  {
+    uInt32 r = (palette[i] >> 16) & 0xff,
+           g = (palette[i] >> 8) & 0xff,
+           b = palette[i] & 0xff;
+    myLuma[i] = (r * 299 + g * 587 + b * 114 + 500) / 1000;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Observation::setSize(uInt32 width, uInt32 height)
+{
+  // At least two lines, so that the sums of a pixel's lines fit 16 bits
+  myWidth  = BSPF_max(width, 1u);
+  myHeight = BSPF_max(height, 2u);
+
+  // The columns are worked out again on the next render
+  mySourceWidth = 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Observation::setSourceWidth(uInt32 srcWidth)
+{
+  mySourceWidth = srcWidth;
+  myColumns.resize(myWidth + 1);
+  for(uInt32 x = 0; x <= myWidth; ++x)
+    myColumns[x] = x * srcWidth / myWidth;
+
+  // When enlarging, each pixel still covers at least one column
+  for(uInt32 x = 0; x < myWidth; ++x)
+    if(myColumns[x] >= srcWidth)
+      myColumns[x] = srcWidth - 1;
+
+  myLine.resize(srcWidth);
+  myPreviousLine.resize(srcWidth);
+  mySums.resize(srcWidth);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Observation::render(uInt8* out, const uInt8* frame, const uInt8* previous,
+                         uInt32 srcWidth, uInt32 srcHeight)
+{
+  if(myAddLine == NULL)
+    selectImplementation();
+
+  if(srcWidth != mySourceWidth)
+    setSourceWidth(srcWidth);
+
+  bool pool = myMaxPool && previous != NULL;
+  uInt32 line = 0;
+
+  for(uInt32 y = 0; y < myHeight; ++y, out += myWidth)
+  {
+    // The lines covered by this row of pixels (at least one)
+    uInt32 first = y * srcHeight / myHeight,
+           last  = BSPF_max((y + 1) * srcHeight / myHeight, first + 1);
+    if(last > srcHeight)
+    {
+      memset(out, 0, myWidth);
+      continue;
+    }
+
+    memset(&mySums[0], 0, srcWidth * sizeof(uInt16));
+    for(line = first; line < last; ++line)
+    {
+      const uInt8* src = frame + line * srcWidth;
+      for(uInt32 x = 0; x < srcWidth; ++x)
+        myLine[x] = myLuma[src[x]];
+
+      if(pool)
+      {
+        src = previous + line * srcWidth;
+        for(uInt32 x = 0; x < srcWidth; ++x)
+          myPreviousLine[x] = myLuma[src[x]];
+        myAddLine(&mySums[0], &myLine[0], &myPreviousLine[0], srcWidth);
+      }
+      else
+        myAddLine(&mySums[0], &myLine[0], &myLine[0], srcWidth);
+    }
+
+    // Average the columns covered by each pixel
+    uInt32 lines = last - first;
+    for(uInt32 x = 0; x < myWidth; ++x)
+    {
+      uInt32 start = myColumns[x],
+             end   = BSPF_max(myColumns[x + 1], start + 1),
+             sum   = 0;
+      for(uInt32 c = start; c < end; ++c)
+        sum += mySums[c];
+
+      uInt32 count = (end - start) * lines;
+      out[x] = (sum + count / 2) / count;
+    }
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const char* Observation::implementation()
+{
+  if(myAddLine == NULL)
+    selectImplementation();
+
+  return myImplementation;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Observation::selectImplementation()
+{
+  AddLine add = addLine;
+  const char* name = "C++";
+
+#ifdef OBSERVATION_X86
+  __builtin_cpu_init();
+  if(__builtin_cpu_supports("avx2"))
+  {
+    add = addLineAVX2;
+    name = "AVX2";
+  }
+  else if(__builtin_cpu_supports("sse2"))
+  {
+    add = addLineSSE2;
+    name = "SSE2";
+  }
+#endif
+
+  // myAddLine is set last, since it indicates that a selection was made
+  myImplementation = name;
+  myAddLine        = add;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Observation::AddLine Observation::myAddLine = NULL;
+const char* Observation::myImplementation = "";
+
+} // Namespace Common
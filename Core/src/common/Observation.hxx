@@ -0,0 +1,145 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2014 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//
+// $Id$
+//============================================================================
+
+
+#ifndef OBSERVATION_HXX
+#define OBSERVATION_HXX
+
+#include <vector>
+
+#include "bspf.hxx"
+
+namespace Common {
+
+/**
+  This class renders the frames generated by the TIA as small grayscale
+  images (ie, 84x84 or 80x105), as used by machine learning agents.
+
+  The luminance of each palette index is looked up in a table derived
+  from the palette in use (ie, Console::currentPalette()), so the frame
+  is never converted to RGB.  Each observation is optionally the maximum
+  of the current and previous frames (which removes the flicker of
+  objects drawn on alternate frames), and is reduced to its final size
+  by averaging the area of the frame covered by each of its pixels.
+  Everything is done in a single pass over the frame, into a buffer
+  supplied by the caller.
+
+  Pooling and summing the lines use AVX2 or SSE2 instructions when the
+  CPU supports them (detected at runtime), and plain C++ otherwise.
+*/
+class Observation
+{
+  public:
+    Observation();
+    virtual ~Observation();
+
+  public:
+    /**
+      Derive the luminance of each palette index from the given palette
+      (using the Rec. 601 weights).
+
+      @param palette  256 entries of 0x00RRGGBB
+    */
+    void setPalette(const uInt32* palette);
+
+    /**
+      Set the size of the observations (84x84 by default).
+
+      @param width   The number of pixels per line
+      @param height  The number of lines (at least 2, so that the lines
+                     averaged into a pixel never overflow 16-bit sums)
+    */
+    void setSize(uInt32 width, uInt32 height);
+
+    /**
+      Set whether each observation is the maximum of the current and the
+      previous frame.
+    */
+    void setMaxPool(bool enable) { myMaxPool = enable; }
+
+    uInt32 width() const  { return myWidth;  }
+    uInt32 height() const { return myHeight; }
+    bool maxPool() const  { return myMaxPool; }
+
+    /**
+      Answers the luminance of each palette index.
+    */
+    const uInt8* luma() const { return myLuma; }
+
+    /**
+      Render an observation of the given frame.
+
+      @param out       Receives 'width() * height()' bytes
+      @param frame     The palette indices of the frame (ie, the TIA's
+                       frameBuffer(0))
+      @param previous  Those of the previous frame (ie, frameBuffer(1)),
+                       only used when pooling; NULL to pool nothing
+      @param srcWidth  The width of the frames
+      @param srcHeight The height of the frames
+    */
+    void render(uInt8* out, const uInt8* frame, const uInt8* previous,
+                uInt32 srcWidth, uInt32 srcHeight);
+
+    /**
+      Get the name of the implementation in use (for informational
+      purposes only).
+    */
+    static const char* implementation();
+
+  private:
+    // Adds the maximum of two lines of 'width' luminances to the sums
+    typedef void (*AddLine)(uInt16* sums, const uInt8* a, const uInt8* b,
+                            uInt32 width);
+
+    // Determine the fastest implementation supported by this CPU
+    static void selectImplementation();
+
+    // Work out the source columns covered by each pixel of a line
+    void setSourceWidth(uInt32 srcWidth);
+
+  private:
+    uInt8 myLuma[256];
+
+    uInt32 myWidth, myHeight;
+    bool myMaxPool;
+
+    // The first source column of each pixel (and the end of the last one)
+    uInt32 mySourceWidth;
+    vector<uInt32> myColumns;
+
+    // The luminances of the current lines, and the sums of those covered
+    // by the line being rendered
+    vector<uInt8> myLine, myPreviousLine;
+    vector<uInt16> mySums;
+
+    // The line adder in use
+    static AddLine myAddLine;
+
+    // Name of the selected implementation
+    static const char* myImplementation;
+
+  private:
+    // Following constructors and assignment operators not supported
+    Observation(const Observation&);
+    Observation& operator = (const Observation&);
+};
+
+} // Namespace Common
+
+#endif
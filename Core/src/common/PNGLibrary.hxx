@@ -29,6 +29,7 @@ class TIA;
 
 #include <fstream>
 #include "bspf.hxx"
+#include "PNGWriter.hxx"
 
 /**
   This class implements a thin wrapper around the libpng library, and
@@ -40,7 +41,11 @@ class TIA;
 class PNGLibrary
 {
   public:
-    PNGLibrary();
+    /**
+      Create a PNG handler, using the given number of threads and images
+      for snapshots which are written in the background.
+    */
+    PNGLibrary(uInt32 threads = 1, uInt32 images = 8);
     virtual ~PNGLibrary();
 
     /**
@@ -64,9 +69,11 @@ class PNGLibrary
       @param filename    The filename to save the PNG image
       @param framebuffer The framebuffer containing the image data
       @param props       The properties object containing info about the ROM
+      @param queue       Write the image in the background, rather than
+                         before returning
     */
     string saveImage(const string& filename, const FrameBuffer& framebuffer,
-                     const Properties& props);
+                     const Properties& props, bool queue = false);
 
     /**
       Save the current TIA image to a PNG file using data directly from
@@ -76,9 +83,25 @@ class PNGLibrary
       @param framebuffer The framebuffer containing the image data
       @param mediasrc    Source of the raw TIA data
       @param props       The properties object containing info about the ROM
+      @param queue       Write the image in the background, rather than
+                         before returning
     */
     string saveImage(const string& filename, const FrameBuffer& framebuffer,
-                     const TIA& tia, const Properties& props);
+                     const TIA& tia, const Properties& props,
+                     bool queue = false);
+
+    /**
+      Set the zlib compression level used for saved images.
+
+      @param level  From 0 (no compression) to 9 (slowest, smallest)
+    */
+    void setCompressionLevel(int level) { myWriter.setCompressionLevel(level); }
+
+    /**
+      Answers the counters of the image writer; these indicate whether
+      images are being queued faster than they can be written.
+    */
+    Common::PNGWriter::Stats writerStats() const { return myWriter.stats(); }
 
   private:
     // The following data remains between invocations of allocateStorage,
@@ -112,18 +135,23 @@ class PNGLibrary
     */
     void scaleImagetoSurface(const FrameBuffer& fb, FBSurface& surface);
 
-    string saveBufferToPNG(ofstream& out, uInt8* buffer,
-                           uInt32 width, uInt32 height,
-                           const Properties& props,
-                           const string& effectsInfo);
-    void writePNGChunk(ofstream& out, const char* type, uInt8* data, int size);
-    void writePNGText(ofstream& out, const string& key, const string& text);
+    /**
+      Add information about the ROM to a filled image, and either write
+      or queue it.
+    */
+    string saveImage(Common::PNGWriter::Image* image, const string& filename,
+                     const Properties& props, const string& effectsInfo,
+                     bool queue);
 
     static void png_read_data(png_structp ctx, png_bytep area, png_size_t size);
     static void png_write_data(png_structp ctx, png_bytep area, png_size_t size);
     static void png_io_flush(png_structp ctx);
     static void png_user_warn(png_structp ctx, png_const_charp str);
     static void png_user_error(png_structp ctx, png_const_charp str);
+
+  private:
+    // Compresses and writes saved images
+    Common::PNGWriter myWriter;
 };
 
 #endif
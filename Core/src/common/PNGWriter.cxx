@@ -0,0 +1,367 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2014 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//
+// $Id$
+//============================================================================
+
+#include <sys/time.h>
+#include <zlib.h>
+
+#include "PNGWriter.hxx"
+
+namespace Common {
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void PNGWriter::Image::reset(uInt32 width, uInt32 height)
+{
+  uInt32 size = (width * 3 + 1) * height;
+  if(size > myCapacity)
+  {
+    delete[] myData;
+    myData = new uInt8[size];
+    myCapacity = size;
+  }
+  myWidth  = width;
+  myHeight = height;
+
+  // The first byte of each line is its filter type (none)
+  for(uInt32 y = 0; y < height; ++y)
+    myData[y * (width * 3 + 1)] = 0;
+
+  myText.clear();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+PNGWriter::PNGWriter(uInt32 threads, uInt32 images)
+  : myThreads(NULL),
+    myNumThreads(0),
+    myMaxImages(images > 0 ? images : 1),
+    myNextSequence(0),
+    myNextWrite(0),
+    myLevel(Z_DEFAULT_COMPRESSION),
+    myQuit(false)
+{
+  memset(&myStats, 0, sizeof(myStats));
+
+  pthread_mutex_init(&myMutex, NULL);
+  pthread_cond_init(&myImageQueued, NULL);
+  pthread_cond_init(&myImageWritten, NULL);
+
+  myThreads = new pthread_t[threads > 0 ? threads : 1];
+  for(uInt32 i = 0; i < threads; ++i)
+  {
+    // If a thread can't be created, simply make do with fewer
+    if(pthread_create(&myThreads[myNumThreads], NULL, threadMain, this) == 0)
+      ++myNumThreads;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+PNGWriter::~PNGWriter()
+{
+  // The threads only exit once the queue is empty
+  pthread_mutex_lock(&myMutex);
+  myQuit = true;
+  pthread_cond_broadcast(&myImageQueued);
+  pthread_mutex_unlock(&myMutex);
+
+  for(uInt32 i = 0; i < myNumThreads; ++i)
+    pthread_join(myThreads[i], NULL);
+  delete[] myThreads;
+
+  for(uInt32 i = 0; i < myImages.size(); ++i)
+    delete myImages[i];
+
+  pthread_cond_destroy(&myImageWritten);
+  pthread_cond_destroy(&myImageQueued);
+  pthread_mutex_destroy(&myMutex);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void PNGWriter::setCompressionLevel(int level)
+{
+  pthread_mutex_lock(&myMutex);
+  myLevel = BSPF_clamp(level, 0, 9);
+  pthread_mutex_unlock(&myMutex);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+PNGWriter::Image* PNGWriter::getImage(uInt32 width, uInt32 height, bool wait)
+{
+  uInt64 start = 0;
+
+  pthread_mutex_lock(&myMutex);
+  while(myFreeImages.empty() && myImages.size() >= myMaxImages)
+  {
+    if(!wait)
+    {
+      ++myStats.dropped;
+      pthread_mutex_unlock(&myMutex);
+      return NULL;
+    }
+    if(start == 0)
+      start = getTicks();
+    pthread_cond_wait(&myImageWritten, &myMutex);
+  }
+  if(start != 0)
+    myStats.waitTime += getTicks() - start;
+
+  Image* image;
+  if(!myFreeImages.empty())
+  {
+    image = myFreeImages.back();
+    myFreeImages.pop_back();
+  }
+  else
+  {
+    image = new Image();
+    myImages.push_back(image);
+  }
+  pthread_mutex_unlock(&myMutex);
+
+  image->reset(width, height);
+  return image;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string PNGWriter::write(Image* image, const string& filename)
+{
+  pthread_mutex_lock(&myMutex);
+  int level = myLevel;
+  pthread_mutex_unlock(&myMutex);
+
+  uInt64 start = getTicks();
+  image->myFilename = filename;
+  vector<uInt8> compressed;
+  string error = compress(*image, level, compressed);
+  if(error == "")
+    error = writeFile(*image, compressed);
+  uInt64 time = getTicks() - start;
+
+  pthread_mutex_lock(&myMutex);
+  myStats.encodeTime += time;
+  if(error == "")  ++myStats.written;
+  else             ++myStats.failed;
+  myFreeImages.push_back(image);
+  pthread_cond_broadcast(&myImageWritten);
+  pthread_mutex_unlock(&myMutex);
+
+  return error;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void PNGWriter::queue(Image* image, const string& filename)
+{
+  if(myNumThreads == 0)
+  {
+    pthread_mutex_lock(&myMutex);
+    ++myStats.queued;
+    pthread_mutex_unlock(&myMutex);
+
+    const string& error = write(image, filename);
+    if(error != "")
+      cerr << error << ": " << filename << endl;
+    return;
+  }
+
+  image->myFilename = filename;
+
+  pthread_mutex_lock(&myMutex);
+  image->mySequence = myNextSequence++;
+  myQueue.push_back(image);
+  ++myStats.queued;
+  if(++myStats.pending > myStats.maxPending)
+    myStats.maxPending = myStats.pending;
+  pthread_cond_signal(&myImageQueued);
+  pthread_mutex_unlock(&myMutex);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void PNGWriter::flush()
+{
+  pthread_mutex_lock(&myMutex);
+  while(myNextWrite != myNextSequence)
+    pthread_cond_wait(&myImageWritten, &myMutex);
+  pthread_mutex_unlock(&myMutex);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+PNGWriter::Stats PNGWriter::stats() const
+{
+  pthread_mutex_lock(&myMutex);
+  Stats stats = myStats;
+  pthread_mutex_unlock(&myMutex);
+
+  return stats;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void* PNGWriter::threadMain(void* writer)
+{
+  PNGWriter& self = *static_cast<PNGWriter*>(writer);
+
+  // Each thread keeps its own buffer for compressed data
+  vector<uInt8> compressed;
+
+  pthread_mutex_lock(&self.myMutex);
+  for(;;)
+  {
+    while(!self.myQuit && self.myQueue.empty())
+      pthread_cond_wait(&self.myImageQueued, &self.myMutex);
+    if(self.myQueue.empty())
+      break;
+
+    Image* image = self.myQueue.front();
+    self.myQueue.pop_front();
+    int level = self.myLevel;
+    pthread_mutex_unlock(&self.myMutex);
+
+    // Images are compressed in parallel ...
+    uInt64 start = getTicks();
+    string error = compress(*image, level, compressed);
+    uInt64 time = getTicks() - start;
+
+    // ... but written in the order they were queued
+    pthread_mutex_lock(&self.myMutex);
+    while(self.myNextWrite != image->mySequence)
+      pthread_cond_wait(&self.myImageWritten, &self.myMutex);
+    pthread_mutex_unlock(&self.myMutex);
+
+    start = getTicks();
+    if(error == "")
+      error = writeFile(*image, compressed);
+    time += getTicks() - start;
+    if(error != "")
+      cerr << error << ": " << image->myFilename << endl;
+
+    pthread_mutex_lock(&self.myMutex);
+    ++self.myNextWrite;
+    --self.myStats.pending;
+    self.myStats.encodeTime += time;
+    if(error == "")  ++self.myStats.written;
+    else             ++self.myStats.failed;
+    self.myFreeImages.push_back(image);
+    pthread_cond_broadcast(&self.myImageWritten);
+  }
+  pthread_mutex_unlock(&self.myMutex);
+
+  return NULL;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string PNGWriter::compress(const Image& image, int level, vector<uInt8>& out)
+{
+  uLong size = (image.myWidth * 3 + 1) * image.myHeight;
+  uLongf compressedSize = compressBound(size);
+  out.resize(compressedSize);
+
+  if(compress2(&out[0], &compressedSize, image.myData, size, level) != Z_OK)
+    return "ERROR: Couldn't compress PNG";
+
+  out.resize(compressedSize);
+  return "";
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string PNGWriter::writeFile(const Image& image, const vector<uInt8>& compressed)
+{
+  ofstream out(image.myFilename.c_str(), ios_base::binary);
+  if(!out.is_open())
+    return "ERROR: Couldn't create snapshot file";
+
+  // PNG file header
+  uInt8 header[8] = { 137, 80, 78, 71, 13, 10, 26, 10 };
+  out.write((const char*)header, 8);
+
+  // PNG IHDR
+  uInt32 width = image.myWidth, height = image.myHeight;
+  uInt8 ihdr[13];
+  ihdr[0]  = width >> 24;   // width
+  ihdr[1]  = width >> 16;
+  ihdr[2]  = width >> 8;
+  ihdr[3]  = width & 0xFF;
+  ihdr[4]  = height >> 24;  // height
+  ihdr[5]  = height >> 16;
+  ihdr[6]  = height >> 8;
+  ihdr[7]  = height & 0xFF;
+  ihdr[8]  = 8;  // 8 bits per sample (24 bits per pixel)
+  ihdr[9]  = 2;  // PNG_COLOR_TYPE_RGB
+  ihdr[10] = 0;  // PNG_COMPRESSION_TYPE_DEFAULT
+  ihdr[11] = 0;  // PNG_FILTER_TYPE_DEFAULT
+  ihdr[12] = 0;  // PNG_INTERLACE_NONE
+  writeChunk(out, "IHDR", ihdr, 13);
+
+  // The compressed image data
+  writeChunk(out, "IDAT", &compressed[0], compressed.size());
+
+  // Each text chunk is the key and the text, separated by a zero byte
+  for(uInt32 i = 0; i < image.myText.size(); ++i)
+  {
+    const string& text = image.myText[i].first + '\0' + image.myText[i].second;
+    writeChunk(out, "tEXt", (const uInt8*)text.data(), text.length());
+  }
+
+  // Finish up
+  writeChunk(out, "IEND", 0, 0);
+  out.close();
+
+  return out.fail() ? "ERROR: Couldn't write snapshot file" : "";
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void PNGWriter::writeChunk(ofstream& out, const char* type,
+                           const uInt8* data, uInt32 size)
+{
+  // Stuff the length/type into the buffer
+  uInt8 temp[8];
+  temp[0] = size >> 24;
+  temp[1] = size >> 16;
+  temp[2] = size >> 8;
+  temp[3] = size;
+  temp[4] = type[0];
+  temp[5] = type[1];
+  temp[6] = type[2];
+  temp[7] = type[3];
+
+  // Write the header
+  out.write((const char*)temp, 8);
+
+  // Append the actual data
+  uInt32 crc = crc32(0, temp + 4, 4);
+  if(size > 0)
+  {
+    out.write((const char*)data, size);
+    crc = crc32(crc, data, size);
+  }
+
+  // Write the CRC
+  temp[0] = crc >> 24;
+  temp[1] = crc >> 16;
+  temp[2] = crc >> 8;
+  temp[3] = crc;
+  out.write((const char*)temp, 4);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt64 PNGWriter::getTicks()
+{
+  timeval now;
+  gettimeofday(&now, 0);
+
+  return uInt64(now.tv_sec) * 1000000 + now.tv_usec;
+}
+
+} // Namespace Common
@@ -0,0 +1,226 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2014 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//
+// $Id$
+//============================================================================
+
+#ifndef PNG_WRITER_HXX
+#define PNG_WRITER_HXX
+
+#include <pthread.h>
+#include <deque>
+#include <fstream>
+#include <utility>
+#include <vector>
+
+#include "bspf.hxx"
+
+namespace Common {
+
+/**
+  This class encodes RGB images as PNG files, either immediately or on a
+  set of background threads.
+
+  Images are taken from a pool owned by the writer, filled in by the
+  caller, and then either written at once or queued.  Queued images are
+  compressed in parallel, but their files are always written in the order
+  in which they were queued.  Once written, an image goes back to the
+  pool, so no memory is allocated once the pool is full.
+
+  The pool holds a fixed number of images, which bounds both the memory
+  used and the number of images waiting to be written.  When all of them
+  are in use, the caller either waits for one to be written, or gives up
+  on the image (which is then counted as dropped); the time spent waiting
+  is recorded, so a caller can tell when it's producing images faster
+  than they can be written.
+*/
+class PNGWriter
+{
+  public:
+    /**
+      An RGB image (three bytes per pixel), to be written as a PNG file.
+    */
+    class Image
+    {
+      friend class PNGWriter;
+
+      public:
+        uInt32 width() const  { return myWidth;  }
+        uInt32 height() const { return myHeight; }
+
+        /**
+          Answers the pixels of the given line, to be filled by the caller.
+        */
+        uInt8* row(uInt32 y) { return myData + y * (myWidth * 3 + 1) + 1; }
+
+        /**
+          Add a text chunk to the image (ie, a description of its contents).
+        */
+        void addText(const string& key, const string& text)
+          { myText.push_back(make_pair(key, text)); }
+
+      private:
+        Image() : myData(NULL), myCapacity(0), myWidth(0), myHeight(0) { }
+        ~Image() { delete[] myData; }
+
+        // Prepare the image for reuse with the given size
+        void reset(uInt32 width, uInt32 height);
+
+      private:
+        // The PNG scanlines, each starting with its filter type
+        uInt8* myData;
+        uInt32 myCapacity;
+        uInt32 myWidth, myHeight;
+
+        vector< pair<string, string> > myText;
+
+        // Where and in which order the image is to be written
+        string myFilename;
+        uInt32 mySequence;
+    };
+
+    /**
+      Counters describing the work done by the writer.  The times are
+      given in microseconds.
+    */
+    struct Stats {
+      uInt32 queued;      // Images passed to 'queue'
+      uInt32 written;     // Images successfully written (queued or not)
+      uInt32 failed;      // Images which couldn't be written
+      uInt32 dropped;     // Images not given out since the pool was full
+      uInt32 pending;     // Images queued but not yet written
+      uInt32 maxPending;  // The largest value of 'pending' so far
+      uInt64 waitTime;    // Total time spent waiting for a free image
+      uInt64 encodeTime;  // Total time spent compressing and writing
+    };
+
+  public:
+    /**
+      Create a writer with the given number of threads and images.
+
+      @param threads  The number of threads used for queued images
+                      (0 writes them when they're queued)
+      @param images   The maximum number of images in use at once
+    */
+    PNGWriter(uInt32 threads = 1, uInt32 images = 8);
+
+    /**
+      Destructor; waits for all queued images to be written.
+    */
+    virtual ~PNGWriter();
+
+  public:
+    /**
+      Set the zlib compression level for the following images.
+
+      @param level  From 0 (no compression) to 9 (slowest, smallest)
+    */
+    void setCompressionLevel(int level);
+
+    /**
+      Get an image of the given size from the pool.  When every image is
+      in use, either wait for one to be written, or return NULL.
+
+      @param width   The width of the image
+      @param height  The height of the image
+      @param wait    Whether to wait when no image is available
+
+      @return  The image, which must be passed to 'write' or 'queue'
+    */
+    Image* getImage(uInt32 width, uInt32 height, bool wait = true);
+
+    /**
+      Write the image immediately, and return it to the pool.
+
+      @param image     The image, obtained from 'getImage'
+      @param filename  The file to create
+
+      @return  An error message, or the empty string on success
+    */
+    string write(Image* image, const string& filename);
+
+    /**
+      Queue the image to be written by the background threads; it returns
+      to the pool once written.
+
+      @param image     The image, obtained from 'getImage'
+      @param filename  The file to create
+    */
+    void queue(Image* image, const string& filename);
+
+    /**
+      Wait until all queued images have been written.
+    */
+    void flush();
+
+    /**
+      Answers a copy of the current counters.
+    */
+    Stats stats() const;
+
+  private:
+    // Entry point for each worker thread
+    static void* threadMain(void* writer);
+
+    // Compress the image data, and write the PNG file from the compressed
+    // data; both return an error message, or the empty string on success
+    static string compress(const Image& image, int level, vector<uInt8>& out);
+    static string writeFile(const Image& image, const vector<uInt8>& compressed);
+
+    // Write a single PNG chunk, including its length and CRC
+    static void writeChunk(ofstream& out, const char* type,
+                           const uInt8* data, uInt32 size);
+
+    // Get the current time, in microseconds
+    static uInt64 getTicks();
+
+  private:
+    // The worker threads
+    pthread_t* myThreads;
+    uInt32 myNumThreads;
+
+    // Protects all of the following, and signals the threads
+    mutable pthread_mutex_t myMutex;
+    pthread_cond_t myImageQueued;
+    pthread_cond_t myImageWritten;
+
+    // All the images allocated, and those not in use
+    vector<Image*> myImages;
+    vector<Image*> myFreeImages;
+    uInt32 myMaxImages;
+
+    // The images waiting for a thread to compress them
+    deque<Image*> myQueue;
+
+    // Sequence numbers of the next image queued and the next to be written
+    uInt32 myNextSequence;
+    uInt32 myNextWrite;
+
+    int myLevel;
+    Stats myStats;
+
+    // Indicates that the threads should exit
+    bool myQuit;
+
+  private:
+    // Following constructors and assignment operators not supported
+    PNGWriter(const PNGWriter&);
+    PNGWriter& operator = (const PNGWriter&);
+};
+
+} // Namespace Common
+
+#endif
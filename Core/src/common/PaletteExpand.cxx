@@ -0,0 +1,155 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2014 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//
+// $Id$
+//============================================================================
+
+#include "PaletteExpand.hxx"
+
+// The AVX2 versions are only built for x86 compilers that can generate
+// code for instruction sets not enabled for the rest of the program.
+// Without a gather instruction (ie, with SSE2 to SSE4), the table lookups
+// dominate, and a vector version is no faster than the plain C++ one.
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__clang__) || (defined(__GNUC__) && \
+     (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))))
+  #define PALETTE_EXPAND_X86
+  #include <immintrin.h>
+#endif
+
+namespace Common {
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+static void expandLine(uInt32* dst, const uInt8* src, uInt32 width,
+                       const uInt32* palette)
+{
+  for(uInt32 x = 0; x < width; ++x)
+    dst[x] = palette[src[x]];
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+static void expandLineDouble(uInt32* dst, const uInt8* src, uInt32 width,
+                             const uInt32* palette)
+{
+  for(uInt32 x = 0; x < width; ++x)
+    dst[2*x] = dst[2*x+1] = palette[src[x]];
+}
+
+#ifdef PALETTE_EXPAND_X86
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+__attribute__((target("avx2")))
+static void expandLineAVX2(uInt32* dst, const uInt8* src, uInt32 width,
+                           const uInt32* palette)
+{
+  const int* table = reinterpret_cast<const int*>(palette);
+  uInt32 x = 0;
+  for(; x + 8 <= width; x += 8)
+  {
+    // Zero-extend eight indices, and look them all up at once
+    __m256i idx = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(src + x)));
+    _mm256_storeu_si256((__m256i*)(dst + x), _mm256_i32gather_epi32(table, idx, 4));
+  }
+  for(; x < width; ++x)
+    dst[x] = palette[src[x]];
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+__attribute__((target("avx2")))
+static void expandLineDoubleAVX2(uInt32* dst, const uInt8* src, uInt32 width,
+                                 const uInt32* palette)
+{
+  const int* table = reinterpret_cast<const int*>(palette);
+  uInt32 x = 0;
+  for(; x + 8 <= width; x += 8)
+  {
+    __m256i idx = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i*)(src + x)));
+    __m256i p   = _mm256_i32gather_epi32(table, idx, 4);
+
+    // The unpack instructions work within each 128-bit lane, giving
+    // pixels 0,1 / 4,5 and 2,3 / 6,7; the lanes are then put in order
+    __m256i lo = _mm256_unpacklo_epi32(p, p);
+    __m256i hi = _mm256_unpackhi_epi32(p, p);
+    _mm256_storeu_si256((__m256i*)(dst + 2*x), _mm256_permute2x128_si256(lo, hi, 0x20));
+    _mm256_storeu_si256((__m256i*)(dst + 2*x + 8), _mm256_permute2x128_si256(lo, hi, 0x31));
+  }
+  for(; x < width; ++x)
+    dst[2*x] = dst[2*x+1] = palette[src[x]];
+}
+#endif
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void PaletteExpand::expand(uInt32* dst, uInt32 dstPitch,
+                           const uInt8* src, uInt32 srcPitch,
+                           uInt32 width, uInt32 height,
+                           const uInt32* palette, bool doubleWidth)
+{
+  if(myExpandLine == NULL)
+    selectImplementation();
+
+  ExpandLine line = doubleWidth ? myExpandLineDouble : myExpandLine;
+
+  // Contiguous buffers are converted as one long line
+  if(!doubleWidth && dstPitch == width && srcPitch == width)
+  {
+    line(dst, src, width * height, palette);
+    return;
+  }
+
+  for(uInt32 y = 0; y < height; ++y)
+  {
+    line(dst, src, width, palette);
+    dst += dstPitch;
+    src += srcPitch;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const char* PaletteExpand::implementation()
+{
+  if(myExpandLine == NULL)
+    selectImplementation();
+
+  return myImplementation;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void PaletteExpand::selectImplementation()
+{
+  ExpandLine line = expandLine, lineDouble = expandLineDouble;
+  const char* name = "C++";
+
+#ifdef PALETTE_EXPAND_X86
+  __builtin_cpu_init();
+  if(__builtin_cpu_supports("avx2"))
+  {
+    line = expandLineAVX2;
+    lineDouble = expandLineDoubleAVX2;
+    name = "AVX2";
+  }
+#endif
+
+  // myExpandLine is set last, since it indicates that a selection was made
+  myImplementation   = name;
+  myExpandLineDouble = lineDouble;
+  myExpandLine       = line;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+PaletteExpand::ExpandLine PaletteExpand::myExpandLine = NULL;
+PaletteExpand::ExpandLine PaletteExpand::myExpandLineDouble = NULL;
+const char* PaletteExpand::myImplementation = "";
+
+} // Namespace Common
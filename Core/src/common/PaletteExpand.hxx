@@ -0,0 +1,85 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2014 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//
+// $Id$
+//============================================================================
+
+#ifndef PALETTE_EXPAND_HXX
+#define PALETTE_EXPAND_HXX
+
+#include "bspf.hxx"
+
+namespace Common {
+
+/**
+  This class converts the 8-bit palette indices generated by the TIA
+  into 32-bit pixels, as needed by every video backend.
+
+  The conversion uses AVX2 gather instructions when the CPU supports them
+  (detected at runtime), and plain C++ otherwise.
+*/
+class PaletteExpand
+{
+  public:
+    /**
+      Convert a rectangle of palette indices to 32-bit pixels.
+
+      @param dst          The destination pixels
+      @param dstPitch     Number of pixels between the start of each
+                          destination line
+      @param src          The palette indices (ie, a TIA framebuffer)
+      @param srcPitch     Number of bytes between the start of each
+                          source line
+      @param width        The number of indices per line to convert
+      @param height       The number of lines to convert
+      @param palette      The 256-entry table of 32-bit pixels
+      @param doubleWidth  Write each pixel twice (the destination must
+                          then hold 2 * width pixels per line)
+    */
+    static void expand(uInt32* dst, uInt32 dstPitch,
+                       const uInt8* src, uInt32 srcPitch,
+                       uInt32 width, uInt32 height,
+                       const uInt32* palette, bool doubleWidth = false);
+
+    /**
+      Get the name of the implementation in use (for informational
+      purposes only).
+    */
+    static const char* implementation();
+
+  private:
+    // Converts a single line of 'width' indices
+    typedef void (*ExpandLine)(uInt32* dst, const uInt8* src, uInt32 width,
+                               const uInt32* palette);
+
+    // Determine the fastest implementation supported by this CPU
+    static void selectImplementation();
+
+  private:      // Make sure this class is never instantiated
+    PaletteExpand() { }
+
+  private:
+    // The line converters in use, for normal and double-width output
+    static ExpandLine myExpandLine;
+    static ExpandLine myExpandLineDouble;
+
+    // Name of the selected implementation
+    static const char* myImplementation;
+};
+
+} // Namespace Common
+
+#endif
@@ -0,0 +1,239 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2014 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//
+// $Id$
+//============================================================================
+
+#include <cstring>
+
+#include "PhosphorBlend.hxx"
+
+// The vector versions are only built for x86 compilers that can generate
+// code for instruction sets not enabled for the rest of the program
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__clang__) || (defined(__GNUC__) && \
+     (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))))
+  #define PHOSPHOR_BLEND_X86
+  #include <immintrin.h>
+#endif
+
+namespace Common {
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+static void blendLine(uInt32* pixels, uInt32* history, uInt32 width,
+                      uInt32 decay)
+{
+  for(uInt32 x = 0; x < width; ++x)
+  {
+    uInt32 cur = pixels[x], prev = history[x], out = 0;
+    for(int shift = 0; shift < 32; shift += 8)
+    {
+      uInt32 c = (cur >> shift) & 0xff;
+      uInt32 p = (((prev >> shift) & 0xff) * decay) >> 8;
+      out |= (c > p ? c : p) << shift;
+    }
+    pixels[x] = history[x] = out;
+  }
+}
+
+#ifdef PHOSPHOR_BLEND_X86
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+__attribute__((target("sse2")))
+static void blendLineSSE2(uInt32* pixels, uInt32* history, uInt32 width,
+                          uInt32 decay)
+{
+  const __m128i zero = _mm_setzero_si128();
+  const __m128i d = _mm_set1_epi16(decay);
+  uInt32 x = 0;
+  for(; x + 4 <= width; x += 4)
+  {
+    __m128i cur  = _mm_loadu_si128((const __m128i*)(pixels + x));
+    __m128i prev = _mm_loadu_si128((const __m128i*)(history + x));
+
+    // Widen each channel to 16 bits, so it can be scaled by the decay
+    __m128i lo = _mm_srli_epi16(_mm_mullo_epi16(_mm_unpacklo_epi8(prev, zero), d), 8);
+    __m128i hi = _mm_srli_epi16(_mm_mullo_epi16(_mm_unpackhi_epi8(prev, zero), d), 8);
+    __m128i out = _mm_max_epu8(cur, _mm_packus_epi16(lo, hi));
+
+    _mm_storeu_si128((__m128i*)(pixels + x), out);
+    _mm_storeu_si128((__m128i*)(history + x), out);
+  }
+  blendLine(pixels + x, history + x, width - x, decay);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+__attribute__((target("avx2")))
+static void blendLineAVX2(uInt32* pixels, uInt32* history, uInt32 width,
+                          uInt32 decay)
+{
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i d = _mm256_set1_epi16(decay);
+  uInt32 x = 0;
+  for(; x + 8 <= width; x += 8)
+  {
+    __m256i cur  = _mm256_loadu_si256((const __m256i*)(pixels + x));
+    __m256i prev = _mm256_loadu_si256((const __m256i*)(history + x));
+
+    // Unpacking and packing both work within each 128-bit lane, so
+    // the channels end up back in their original order
+    __m256i lo = _mm256_srli_epi16(_mm256_mullo_epi16(_mm256_unpacklo_epi8(prev, zero), d), 8);
+    __m256i hi = _mm256_srli_epi16(_mm256_mullo_epi16(_mm256_unpackhi_epi8(prev, zero), d), 8);
+    __m256i out = _mm256_max_epu8(cur, _mm256_packus_epi16(lo, hi));
+
+    _mm256_storeu_si256((__m256i*)(pixels + x), out);
+    _mm256_storeu_si256((__m256i*)(history + x), out);
+  }
+  blendLine(pixels + x, history + x, width - x, decay);
+}
+#endif
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+PhosphorBlend::PhosphorBlend()
+  : myHistory(NULL),
+    myWidth(0),
+    myHeight(0),
+    myHistoryValid(false),
+    myPercent(0),
+    myDecay(0),
+    myMode(kPeakHold)
+{
+  setBlend(77);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+PhosphorBlend::~PhosphorBlend()
+{
+  delete[] myHistory;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void PhosphorBlend::setBlend(int percent)
+{
+  percent = BSPF_clamp(percent, 0, 100);
+  myPercent = percent;
+  myDecay = (percent * 256 + 50) / 100;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt8 PhosphorBlend::blendChannel(uInt8 current, uInt8 previous) const
+{
+  if(myMode == kAverage)
+  {
+    uInt8 hi = BSPF_max(current, previous), lo = BSPF_min(current, previous);
+    return lo + ((hi - lo) * myPercent) / 100;
+  }
+
+  uInt8 faded = (previous * myDecay) >> 8;
+  return current > faded ? current : faded;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void PhosphorBlend::averageLine(uInt32* pixels, uInt32* history,
+                                uInt32 width) const
+{
+  for(uInt32 x = 0; x < width; ++x)
+  {
+    uInt32 cur = pixels[x], prev = history[x], out = 0;
+    for(int shift = 0; shift < 32; shift += 8)
+      out |= uInt32(blendChannel((cur >> shift) & 0xff,
+                                 (prev >> shift) & 0xff)) << shift;
+    history[x] = cur;
+    pixels[x] = out;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void PhosphorBlend::blend(uInt32* pixels, uInt32 pitch,
+                          uInt32 width, uInt32 height)
+{
+  if(myBlendLine == NULL)
+    selectImplementation();
+
+  if(width != myWidth || height != myHeight)
+  {
+    delete[] myHistory;
+    myHistory = new uInt32[width * height];
+    myWidth  = width;
+    myHeight = height;
+    myHistoryValid = false;
+  }
+
+  // Without any history, the frame is simply shown as-is
+  if(!myHistoryValid)
+  {
+    for(uInt32 y = 0; y < height; ++y)
+      memcpy(myHistory + y * width, pixels + y * pitch, width * sizeof(uInt32));
+    myHistoryValid = true;
+    return;
+  }
+
+  if(myMode == kAverage)
+  {
+    for(uInt32 y = 0; y < height; ++y)
+      averageLine(pixels + y * pitch, myHistory + y * width, width);
+    return;
+  }
+
+  // Contiguous frames are blended as one long line
+  if(pitch == width)
+  {
+    myBlendLine(pixels, myHistory, width * height, myDecay);
+    return;
+  }
+
+  for(uInt32 y = 0; y < height; ++y)
+    myBlendLine(pixels + y * pitch, myHistory + y * width, width, myDecay);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+const char* PhosphorBlend::implementation()
+{
+  if(myBlendLine == NULL)
+    selectImplementation();
+
+  return myImplementation;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void PhosphorBlend::selectImplementation()
+{
+  BlendLine line = blendLine;
+  const char* name = "C++";
+
+#ifdef PHOSPHOR_BLEND_X86
+  __builtin_cpu_init();
+  if(__builtin_cpu_supports("avx2"))
+  {
+    line = blendLineAVX2;
+    name = "AVX2";
+  }
+  else if(__builtin_cpu_supports("sse2"))
+  {
+    line = blendLineSSE2;
+    name = "SSE2";
+  }
+#endif
+
+  // myBlendLine is set last, since it indicates that a selection was made
+  myImplementation = name;
+  myBlendLine      = line;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+PhosphorBlend::BlendLine PhosphorBlend::myBlendLine = NULL;
+const char* PhosphorBlend::myImplementation = "";
+
+} // Namespace Common
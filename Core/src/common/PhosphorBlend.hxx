@@ -0,0 +1,168 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2014 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//
+// $Id$
+//============================================================================
+
+#ifndef PHOSPHOR_BLEND_HXX
+#define PHOSPHOR_BLEND_HXX
+
+#include "bspf.hxx"
+
+namespace Common {
+
+/**
+  This class implements the phosphor effect as a post-processing stage,
+  applied to frames which have already been converted to 32-bit pixels.
+
+  By default (kPeakHold), each channel of each pixel fades by a fixed
+  percentage per frame, and is raised again as soon as a brighter value
+  is drawn over it; ie,
+
+    out = max(current, previous out * blend / 100)
+
+  so every earlier frame contributes to the result, with exponentially
+  decreasing weight, much like a real phosphor.  Objects drawn on
+  alternate frames therefore pulse slightly as they fade.
+
+  The original Stella effect (kAverage) is also available; it only takes
+  the previous frame into account, mixing it with the current one:
+
+    out = min(current, previous) + |current - previous| * blend / 100
+
+  which shows such objects as a steady average.
+
+  The channels are treated as four independent bytes,
+  so any 32-bit pixel format may be used (and the alpha channel, if any,
+  is passed through unchanged when it is always opaque).
+
+  The peak-hold blend uses AVX2 or SSE2 instructions when the CPU
+  supports them (detected at runtime), and plain C++ otherwise; the
+  average is always done in plain C++.
+*/
+class PhosphorBlend
+{
+  public:
+    enum Mode {
+      kPeakHold,  // Fade all previous frames, keeping the brightest value
+      kAverage    // Mix the previous frame with the current one
+    };
+
+  public:
+    PhosphorBlend();
+    virtual ~PhosphorBlend();
+
+  public:
+    /**
+      Set how much of each frame remains visible in the next one.
+
+      @param percent  The percentage of brightness kept from one frame
+                      to the next (0 disables the effect, 100 never fades)
+    */
+    void setBlend(int percent);
+
+    /**
+      Set how the frames are combined; this also forgets all previous
+      frames.
+
+      @param mode  The blending mode (see above)
+    */
+    void setMode(Mode mode) { myMode = mode;  reset(); }
+
+    /**
+      Get the blending mode named by the given string, as used in the
+      settings ("peak" or "average"; anything else is peak-hold).
+    */
+    static Mode modeFromString(const string& name)
+    {
+      return name == "average" ? kAverage : kPeakHold;
+    }
+
+    /**
+      Blend a single channel of a pixel, when only the previous frame
+      is known (ie, to build a palette indexed by the colors of both
+      frames).  This is exact in average mode, and the effect of the
+      last two frames only in peak-hold mode.
+
+      @param current   The channel in the current frame
+      @param previous  The channel in the previous frame
+      @return  The blended value
+    */
+    uInt8 blendChannel(uInt8 current, uInt8 previous) const;
+
+    /**
+      Forget all previous frames, so the next frame is shown as-is.
+    */
+    void reset() { myHistoryValid = false; }
+
+    /**
+      Blend the given frame with the previous ones, in place.  The size
+      of the frame must be the same each time; when it changes, the
+      previous frames are forgotten.
+
+      @param pixels  The pixels of the frame (in any 32-bit format)
+      @param pitch   Number of pixels between the start of each line
+      @param width   The number of pixels per line
+      @param height  The number of lines
+    */
+    void blend(uInt32* pixels, uInt32 pitch, uInt32 width, uInt32 height);
+
+    /**
+      Get the name of the implementation in use (for informational
+      purposes only).
+    */
+    static const char* implementation();
+
+  private:
+    // Blends a single line of 'width' pixels with the previous frame,
+    // in average mode
+    void averageLine(uInt32* pixels, uInt32* history, uInt32 width) const;
+
+    // Blends a single line of 'width' pixels with the history
+    typedef void (*BlendLine)(uInt32* pixels, uInt32* history, uInt32 width,
+                              uInt32 decay);
+
+    // Determine the fastest implementation supported by this CPU
+    static void selectImplementation();
+
+  private:
+    // The blended result of all previous frames (in average mode, simply
+    // the previous frame)
+    uInt32* myHistory;
+    uInt32 myWidth, myHeight;
+    bool myHistoryValid;
+
+    // Fraction of each channel kept per frame, as a percentage and in
+    // 1/256ths
+    uInt32 myPercent, myDecay;
+
+    Mode myMode;
+
+    // The line blender in use
+    static BlendLine myBlendLine;
+
+    // Name of the selected implementation
+    static const char* myImplementation;
+
+  private:
+    // Following constructors and assignment operators not supported
+    PhosphorBlend(const PhosphorBlend&);
+    PhosphorBlend& operator = (const PhosphorBlend&);
+};
+
+} // Namespace Common
+
+#endif
@@ -259,6 +259,10 @@ void SoundSDL::setFrameRate(float framerate)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void SoundSDL::set(uInt16 addr, uInt8 value, Int32 cycle)
 {
+  // Nothing would ever take the writes out of the queue
+  if(!myIsEnabled)
+    return;
+
   //SDL_LockAudio();
 
   // First, calculate how many seconds would have past since the last
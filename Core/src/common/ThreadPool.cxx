@@ -0,0 +1,132 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2014 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//
+// $Id$
+//============================================================================
+
+#include "ThreadPool.hxx"
+
+namespace Common {
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+ThreadPool::ThreadPool(uInt32 threads)
+  : myThreads(NULL),
+    myNumThreads(0),
+    myJob(NULL),
+    myParts(0),
+    myNextPart(0),
+    myPartsDone(0),
+    myJobCount(0),
+    myQuit(false)
+{
+  pthread_mutex_init(&myMutex, NULL);
+  pthread_cond_init(&myJobReady, NULL);
+  pthread_cond_init(&myJobDone, NULL);
+
+  myThreads = new pthread_t[threads > 0 ? threads : 1];
+  for(uInt32 i = 0; i < threads; ++i)
+  {
+    // If a thread can't be created, simply make do with fewer
+    if(pthread_create(&myThreads[myNumThreads], NULL, threadMain, this) == 0)
+      ++myNumThreads;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+ThreadPool::~ThreadPool()
+{
+  pthread_mutex_lock(&myMutex);
+  myQuit = true;
+  pthread_cond_broadcast(&myJobReady);
+  pthread_mutex_unlock(&myMutex);
+
+  for(uInt32 i = 0; i < myNumThreads; ++i)
+    pthread_join(myThreads[i], NULL);
+  delete[] myThreads;
+
+  pthread_cond_destroy(&myJobDone);
+  pthread_cond_destroy(&myJobReady);
+  pthread_mutex_destroy(&myMutex);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ThreadPool::run(Job& job, uInt32 parts)
+{
+  // There's no point in waking the threads for a single part
+  if(myNumThreads == 0 || parts <= 1)
+  {
+    for(uInt32 part = 0; part < parts; ++part)
+      job.execute(part, parts);
+    return;
+  }
+
+  pthread_mutex_lock(&myMutex);
+  myJob       = &job;
+  myParts     = parts;
+  myNextPart  = 0;
+  myPartsDone = 0;
+  ++myJobCount;
+  pthread_cond_broadcast(&myJobReady);
+
+  processParts();
+
+  // Parts may still be running in other threads
+  while(myPartsDone < myParts)
+    pthread_cond_wait(&myJobDone, &myMutex);
+  myJob = NULL;
+  pthread_mutex_unlock(&myMutex);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void ThreadPool::processParts()
+{
+  while(myNextPart < myParts)
+  {
+    uInt32 part = myNextPart++;
+
+    pthread_mutex_unlock(&myMutex);
+    myJob->execute(part, myParts);
+    pthread_mutex_lock(&myMutex);
+
+    if(++myPartsDone == myParts)
+      pthread_cond_signal(&myJobDone);
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void* ThreadPool::threadMain(void* pool)
+{
+  ThreadPool& self = *static_cast<ThreadPool*>(pool);
+  uInt32 jobCount = 0;
+
+  pthread_mutex_lock(&self.myMutex);
+  for(;;)
+  {
+    while(!self.myQuit && self.myJobCount == jobCount)
+      pthread_cond_wait(&self.myJobReady, &self.myMutex);
+    if(self.myQuit)
+      break;
+
+    jobCount = self.myJobCount;
+    if(self.myJob)
+      self.processParts();
+  }
+  pthread_mutex_unlock(&self.myMutex);
+
+  return NULL;
+}
+
+} // Namespace Common
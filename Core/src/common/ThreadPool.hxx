@@ -0,0 +1,126 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2014 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//
+// $Id$
+//============================================================================
+
+#ifndef THREAD_POOL_HXX
+#define THREAD_POOL_HXX
+
+#include <pthread.h>
+
+#include "bspf.hxx"
+
+namespace Common {
+
+/**
+  A small pool of persistent worker threads, used to split a piece of
+  work into independent parts and process them in parallel.
+
+  The threads are created once and sleep between jobs, so that the cost
+  of starting a job is only that of waking them.  The calling thread
+  also processes parts, so a pool created with 'n' threads runs at most
+  'n + 1' parts at once.
+
+  Parts may be processed in any order, and by any thread; a job whose
+  parts write to separate memory produces the same result no matter how
+  many threads are used.
+*/
+class ThreadPool
+{
+  public:
+    /**
+      Interface for the work done by the pool.
+    */
+    class Job
+    {
+      public:
+        virtual ~Job() { }
+
+        /**
+          Process one part of the job.
+
+          @param part   The part to process, from 0 to 'parts - 1'
+          @param parts  The total number of parts in the job
+        */
+        virtual void execute(uInt32 part, uInt32 parts) = 0;
+    };
+
+  public:
+    /**
+      Create a pool with the given number of worker threads.
+
+      @param threads  The number of threads to create, in addition
+                      to the calling thread
+    */
+    ThreadPool(uInt32 threads);
+    virtual ~ThreadPool();
+
+  public:
+    /**
+      Run the given job, split into the given number of parts, returning
+      once all the parts have been processed.  This must only be called
+      from one thread at a time.
+
+      @param job    The job to run
+      @param parts  The number of parts to split the job into
+    */
+    void run(Job& job, uInt32 parts);
+
+    /**
+      Answers the number of worker threads (not including the caller).
+    */
+    uInt32 threads() const { return myNumThreads; }
+
+  private:
+    // Entry point for each worker thread
+    static void* threadMain(void* pool);
+
+    // Process parts of the current job until none are left
+    // (must be called with the mutex held)
+    void processParts();
+
+  private:
+    // The worker threads
+    pthread_t* myThreads;
+    uInt32 myNumThreads;
+
+    // Protects all of the following, and signals the threads
+    pthread_mutex_t myMutex;
+    pthread_cond_t myJobReady;
+    pthread_cond_t myJobDone;
+
+    // The job currently being run, and its progress
+    Job* myJob;
+    uInt32 myParts;
+    uInt32 myNextPart;
+    uInt32 myPartsDone;
+
+    // Incremented for each job, so threads know when a new one is ready
+    uInt32 myJobCount;
+
+    // Indicates that the threads should exit
+    bool myQuit;
+
+  private:
+    // Following constructors and assignment operators not supported
+    ThreadPool(const ThreadPool&);
+    ThreadPool& operator = (const ThreadPool&);
+};
+
+} // Namespace Common
+
+#endif
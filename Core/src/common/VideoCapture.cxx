@@ -0,0 +1,411 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2014 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//
+// $Id$
+//============================================================================
+
+#include "VideoCapture.hxx"
+
+namespace Common {
+
+static const char ourMagic[8] = { 'S', 't', 'e', 'l', 'V', 'C', 'a', 'p' };
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+static inline void putInt(uInt8* buf, uInt32 value)
+{
+  buf[0] = value;
+  buf[1] = value >> 8;
+  buf[2] = value >> 16;
+  buf[3] = value >> 24;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+static inline uInt32 getInt(const uInt8* buf)
+{
+  return buf[0] | (buf[1] << 8) | (buf[2] << 16) | (uInt32(buf[3]) << 24);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+static inline uInt8* putLiteral(uInt8* out, const uInt8* data, uInt32 count)
+{
+  while(count > 0)
+  {
+    uInt32 n = BSPF_min(count, 128u);
+    *out++ = n - 1;
+    memcpy(out, data, n);
+    out += n;  data += n;  count -= n;
+  }
+  return out;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 VideoCapture::encode(const uInt8* data, uInt32 size, uInt8* out)
+{
+  uInt8* start = out;
+  uInt32 literal = 0;  // start of the bytes not yet written
+  uInt32 i = 0;
+
+  while(i < size)
+  {
+    // Find the length of the run starting here; long runs (typically of
+    // zeros in a delta) are checked eight bytes at a time
+    uInt8 b = data[i];
+    uInt32 j = i + 1;
+    if(j < size && data[j] == b)
+    {
+      uInt64 pattern = 0x0101010101010101ULL * b, word;
+      while(j + 8 <= size && (memcpy(&word, data + j, 8), word == pattern))
+        j += 8;
+      while(j < size && data[j] == b)
+        ++j;
+    }
+
+    uInt32 run = j - i;
+    if(run < 3)
+    {
+      i = j;
+      continue;
+    }
+
+    out = putLiteral(out, data + literal, i - literal);
+    while(run >= 3)
+    {
+      if(run >= 130)
+      {
+        uInt32 n = BSPF_min(run, 65535u);
+        *out++ = 0xff;
+        *out++ = n & 0xff;
+        *out++ = n >> 8;
+        *out++ = b;
+        run -= n;
+      }
+      else
+      {
+        *out++ = 0x80 + run - 3;
+        *out++ = b;
+        run = 0;
+      }
+    }
+    // Any one or two bytes left over are written with what follows
+    literal = j - run;
+    i = j;
+  }
+  out = putLiteral(out, data + literal, size - literal);
+
+  return out - start;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool VideoCapture::decode(const uInt8* data, uInt32 length,
+                          uInt8* out, uInt32 size)
+{
+  const uInt8* end = data + length;
+  uInt32 pos = 0;
+
+  while(data < end)
+  {
+    uInt8 c = *data++;
+    if(c < 0x80)
+    {
+      uInt32 n = c + 1;
+      if(uInt32(end - data) < n || size - pos < n)
+        return false;
+      memcpy(out + pos, data, n);
+      data += n;  pos += n;
+    }
+    else
+    {
+      uInt32 n = c - 0x80 + 3;
+      if(c == 0xff)
+      {
+        if(end - data < 2)
+          return false;
+        n = data[0] | (data[1] << 8);
+        data += 2;
+      }
+      if(data == end || size - pos < n)
+        return false;
+      memset(out + pos, *data++, n);
+      pos += n;
+    }
+  }
+
+  return pos == size;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+VideoCaptureWriter::VideoCaptureWriter()
+  : myWidth(0),
+    myKeyInterval(0),
+    myPreviousHeight(0),
+    myFrames(0),
+    myFramesSinceKey(0),
+    myBytes(0)
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+VideoCaptureWriter::~VideoCaptureWriter()
+{
+  close();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool VideoCaptureWriter::open(const string& filename, const uInt32* palette,
+                              uInt32 width, uInt32 keyInterval)
+{
+  close();
+
+  myOut.open(filename.c_str(), ios_base::binary | ios_base::trunc);
+  if(!myOut.is_open())
+    return false;
+
+  myWidth = width;
+  myKeyInterval = keyInterval > 0 ? keyInterval : 1;
+  myPreviousHeight = 0;
+  myFrames = myFramesSinceKey = 0;
+
+  uInt8 header[VideoCapture::kHeaderSize];
+  memcpy(header, ourMagic, 8);
+  putInt(header + 8, VideoCapture::kVersion);
+  putInt(header + 12, myWidth);
+  putInt(header + 16, myKeyInterval);
+  for(uInt32 i = 0; i < 256; ++i)
+  {
+    header[20 + i*3]     = (palette[i] >> 16) & 0xff;
+    header[20 + i*3 + 1] = (palette[i] >> 8) & 0xff;
+    header[20 + i*3 + 2] = palette[i] & 0xff;
+  }
+  myOut.write((const char*)header, sizeof(header));
+  myBytes = sizeof(header);
+
+  return myOut.good();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool VideoCaptureWriter::addFrame(const uInt8* frame, uInt32 height)
+{
+  if(!myOut.is_open())
+    return false;
+
+  uInt32 size = myWidth * height;
+  if(myDelta.size() < size)
+  {
+    myDelta.resize(size);
+    myEncoded.resize(size + size / 64 + 16);
+  }
+
+  // A keyframe is needed at the start, at each interval, and when the
+  // size changes (since a delta must be the same size as its reference)
+  uInt32 type = VideoCapture::kDeltaFrame;
+  if(myFrames == 0 || height != myPreviousHeight ||
+     myFramesSinceKey >= myKeyInterval)
+  {
+    type = VideoCapture::kKeyFrame;
+    myFramesSinceKey = 0;
+  }
+
+  const uInt8* data = frame;
+  if(type == VideoCapture::kDeltaFrame)
+  {
+    const uInt8* previous = &myPrevious[0];
+    for(uInt32 i = 0; i < size; ++i)
+      myDelta[i] = frame[i] ^ previous[i];
+    data = &myDelta[0];
+  }
+  uInt32 length = VideoCapture::encode(data, size, &myEncoded[0]);
+
+  uInt8 header[VideoCapture::kFrameHeaderSize];
+  putInt(header, height);
+  putInt(header + 4, type);
+  putInt(header + 8, length);
+  myOut.write((const char*)header, sizeof(header));
+  myOut.write((const char*)&myEncoded[0], length);
+
+  myPrevious.assign(frame, frame + size);
+  myPreviousHeight = height;
+  ++myFrames;
+  ++myFramesSinceKey;
+  myBytes += sizeof(header) + length;
+
+  return myOut.good();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void VideoCaptureWriter::close()
+{
+  if(myOut.is_open())
+    myOut.close();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+VideoCaptureReader::VideoCaptureReader()
+  : myWidth(0),
+    myHeight(0),
+    myPosition(0)
+{
+  memset(myPalette, 0, sizeof(myPalette));
+  myFrame.resize(1);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+VideoCaptureReader::~VideoCaptureReader()
+{
+  close();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool VideoCaptureReader::open(const string& filename)
+{
+  close();
+
+  myIn.open(filename.c_str(), ios_base::binary);
+  if(!myIn.is_open())
+    return false;
+
+  uInt8 header[VideoCapture::kHeaderSize];
+  myIn.read((char*)header, sizeof(header));
+  if(!myIn.good() || memcmp(header, ourMagic, 8) != 0 ||
+     getInt(header + 8) != VideoCapture::kVersion)
+  {
+    close();
+    return false;
+  }
+  myWidth = getInt(header + 12);
+  for(uInt32 i = 0; i < 256; ++i)
+    myPalette[i] = (header[20 + i*3] << 16) | (header[20 + i*3 + 1] << 8) |
+                    header[20 + i*3 + 2];
+
+  // Locate each frame; a partly written frame at the end is ignored
+  uInt64 offset = sizeof(header);
+  for(;;)
+  {
+    uInt8 frame[VideoCapture::kFrameHeaderSize];
+    myIn.seekg(offset);
+    myIn.read((char*)frame, sizeof(frame));
+    if(!myIn.good())
+      break;
+
+    FrameInfo info;
+    info.offset = offset + sizeof(frame);
+    info.height = getInt(frame);
+    info.type   = getInt(frame + 4);
+    info.size   = getInt(frame + 8);
+
+    // The first frame must be a keyframe, or nothing can be decoded
+    if(info.type > VideoCapture::kDeltaFrame ||
+       (myIndex.empty() && info.type != VideoCapture::kKeyFrame))
+      break;
+
+    myIn.seekg(info.offset + info.size - 1);
+    if(info.size > 0 && myIn.get() == EOF)
+      break;
+
+    myIndex.push_back(info);
+    offset = info.offset + info.size;
+  }
+  myIn.clear();
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void VideoCaptureReader::close()
+{
+  if(myIn.is_open())
+    myIn.close();
+  myIn.clear();
+  myIndex.clear();
+  myHeight = myPosition = 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool VideoCaptureReader::nextFrame()
+{
+  if(myPosition >= myIndex.size())
+    return false;
+
+  const FrameInfo& info = myIndex[myPosition];
+  uInt32 size = myWidth * info.height;
+
+  // A delta must be applied to a frame of the same size
+  if(info.type == VideoCapture::kDeltaFrame && info.height != myHeight)
+    return false;
+
+  if(myEncoded.size() < info.size)
+    myEncoded.resize(info.size);
+  if(myDelta.size() < size)
+    myDelta.resize(size);
+  if(myFrame.size() < size)
+    myFrame.resize(size);
+
+  myIn.seekg(info.offset);
+  myIn.read((char*)&myEncoded[0], info.size);
+  if(!myIn.good())
+  {
+    myIn.clear();
+    return false;
+  }
+
+  if(info.type == VideoCapture::kKeyFrame)
+  {
+    if(!VideoCapture::decode(&myEncoded[0], info.size, &myFrame[0], size))
+      return false;
+  }
+  else
+  {
+    if(!VideoCapture::decode(&myEncoded[0], info.size, &myDelta[0], size))
+      return false;
+    for(uInt32 i = 0; i < size; ++i)
+      myFrame[i] ^= myDelta[i];
+  }
+
+  myHeight = info.height;
+  ++myPosition;
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool VideoCaptureReader::seek(uInt32 frame)
+{
+  if(frame >= myIndex.size())
+    return false;
+
+  // Decoding continues from the current frame when possible, and
+  // otherwise from the last keyframe before the requested frame
+  if(frame < myPosition || frame == 0)
+  {
+    myPosition = frame;
+    while(myIndex[myPosition].type != VideoCapture::kKeyFrame)
+      --myPosition;
+  }
+  for(uInt32 key = frame; key > myPosition; --key)
+  {
+    if(myIndex[key].type == VideoCapture::kKeyFrame)
+    {
+      myPosition = key;
+      break;
+    }
+  }
+
+  while(myPosition < frame)
+    if(!nextFrame())
+      return false;
+
+  return true;
+}
+
+} // Namespace Common
@@ -0,0 +1,243 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2014 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//
+// $Id$
+//============================================================================
+
+#ifndef VIDEO_CAPTURE_HXX
+#define VIDEO_CAPTURE_HXX
+
+#include <fstream>
+#include <vector>
+
+#include "bspf.hxx"
+
+namespace Common {
+
+/**
+  Lossless capture of every frame generated by the TIA, as the 8-bit
+  palette indices of TIA::currentFrameBuffer() (not as RGB pixels).
+
+  A capture file starts with a header and the palette used by the whole
+  stream, followed by one record per frame.  Each frame is either a
+  keyframe, holding the indices themselves, or a delta, holding the XOR
+  of the indices with those of the previous frame; either way, the bytes
+  are then run-length encoded.  Since most of the screen is unchanged
+  from one frame to the next, a delta is mostly zeros, and compresses to
+  a few hundred bytes.  Keyframes are written at a regular interval (and
+  whenever the height of the frame changes), so that a reader can start
+  decoding from them.
+
+  File layout (all numbers are 32-bit little-endian):
+
+    Header:   "StelVCap", version, width, keyframe interval
+    Palette:  256 entries of 3 bytes (R, G, B)
+    Frames:   height, type (0 = keyframe, 1 = delta), size, 'size' bytes
+
+  The run-length encoding uses a control byte 'c', followed by:
+
+    0x00 - 0x7f:  'c + 1' bytes to copy
+    0x80 - 0xfe:  one byte, repeated 'c - 0x80 + 3' times
+    0xff:         a 16-bit count, then one byte repeated 'count' times
+*/
+class VideoCapture
+{
+  public:
+    enum {
+      kVersion = 1,
+      kHeaderSize = 20 + 256 * 3,
+      kFrameHeaderSize = 12,
+      kKeyFrame = 0,
+      kDeltaFrame = 1
+    };
+
+    /**
+      Run-length encode the given data, returning the encoded size.
+      The output must have room for 'size + size / 64 + 16' bytes.
+    */
+    static uInt32 encode(const uInt8* data, uInt32 size, uInt8* out);
+
+    /**
+      Decode run-length encoded data, which must expand to exactly 'size'
+      bytes.  Returns false if the data is invalid.
+    */
+    static bool decode(const uInt8* data, uInt32 length,
+                       uInt8* out, uInt32 size);
+
+  private:      // Make sure this class is never instantiated
+    VideoCapture() { }
+};
+
+/**
+  Writes a capture file, one frame at a time.
+*/
+class VideoCaptureWriter
+{
+  public:
+    VideoCaptureWriter();
+    virtual ~VideoCaptureWriter();
+
+  public:
+    /**
+      Create a capture file, replacing any existing file.
+
+      @param filename     The file to create
+      @param palette      The 256 colors used by the frames (as 0x00RRGGBB)
+      @param width        The width of each frame (the TIA width)
+      @param keyInterval  The maximum number of frames between keyframes
+
+      @return  True if the file was created
+    */
+    bool open(const string& filename, const uInt32* palette,
+              uInt32 width = 160, uInt32 keyInterval = 60);
+
+    /**
+      Append a frame to the file.
+
+      @param frame   The palette indices of the frame (ie, the TIA's
+                     currentFrameBuffer())
+      @param height  The number of lines in the frame
+
+      @return  False if the frame couldn't be written
+    */
+    bool addFrame(const uInt8* frame, uInt32 height);
+
+    /**
+      Finish writing the file, and close it.
+    */
+    void close();
+
+    bool isOpen() const     { return myOut.is_open(); }
+    uInt32 frames() const   { return myFrames; }
+    uInt64 bytes() const    { return myBytes; }
+
+  private:
+    ofstream myOut;
+    uInt32 myWidth;
+    uInt32 myKeyInterval;
+
+    // The previous frame (deltas are relative to it) and its height
+    vector<uInt8> myPrevious;
+    uInt32 myPreviousHeight;
+
+    // Buffers for the XOR'ed and the encoded data
+    vector<uInt8> myDelta;
+    vector<uInt8> myEncoded;
+
+    uInt32 myFrames;
+    uInt32 myFramesSinceKey;
+    uInt64 myBytes;
+
+  private:
+    // Following constructors and assignment operators not supported
+    VideoCaptureWriter(const VideoCaptureWriter&);
+    VideoCaptureWriter& operator = (const VideoCaptureWriter&);
+};
+
+/**
+  Reads a capture file, either sequentially or starting from any frame.
+*/
+class VideoCaptureReader
+{
+  public:
+    VideoCaptureReader();
+    virtual ~VideoCaptureReader();
+
+  public:
+    /**
+      Open a capture file, and locate all of its frames.
+
+      @param filename  The file to open
+
+      @return  True if the file is a valid capture file
+    */
+    bool open(const string& filename);
+
+    /**
+      Close the file.
+    */
+    void close();
+
+    /**
+      Decode the next frame, which is then available from 'frame()'.
+
+      @return  False at the end of the file, or if the frame is invalid
+    */
+    bool nextFrame();
+
+    /**
+      Move to the given frame, so that it's the next one decoded; this
+      decodes the frames from the previous keyframe onwards.
+
+      @param frame  The frame number, starting at 0
+
+      @return  False if there's no such frame, or it can't be decoded
+    */
+    bool seek(uInt32 frame);
+
+    /**
+      Answers the palette indices of the last frame decoded.
+    */
+    const uInt8* frame() const { return &myFrame[0]; }
+
+    /**
+      Answers the palette of the stream (as 0x00RRGGBB).
+    */
+    const uInt32* palette() const { return myPalette; }
+
+    uInt32 width() const  { return myWidth; }
+    uInt32 height() const { return myHeight; }
+    uInt32 frames() const { return myIndex.size(); }
+
+    /**
+      Answers the number of the next frame to be decoded.
+    */
+    uInt32 position() const { return myPosition; }
+
+  private:
+    // The location of each frame in the file
+    struct FrameInfo {
+      uInt64 offset;
+      uInt32 height;
+      uInt32 type;
+      uInt32 size;
+    };
+
+    ifstream myIn;
+    vector<FrameInfo> myIndex;
+    uInt32 myPalette[256];
+    uInt32 myWidth;
+
+    // The last frame decoded, and its height
+    vector<uInt8> myFrame;
+    uInt32 myHeight;
+
+    // The next frame to decode
+    uInt32 myPosition;
+
+    // Buffers for the encoded and the XOR'ed data
+    vector<uInt8> myEncoded;
+    vector<uInt8> myDelta;
+
+  private:
+    // Following constructors and assignment operators not supported
+    VideoCaptureReader(const VideoCaptureReader&);
+    VideoCaptureReader& operator = (const VideoCaptureReader&);
+};
+
+} // Namespace Common
+
+#endif
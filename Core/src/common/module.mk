@@ -6,12 +6,18 @@ MODULE_OBJS := \
 	src/common/SoundSDL.o \
 	src/common/FrameBufferSoft.o \
 	src/common/FrameBufferGL.o \
+	src/common/PaletteExpand.o \
+	src/common/PhosphorBlend.o \
+	src/common/Observation.o \
 	src/common/FBSurfaceGL.o \
 	src/common/FBSurfaceTIA.o \
 	src/common/FSNodeZIP.o \
 	src/common/PNGLibrary.o \
+	src/common/PNGWriter.o \
 	src/common/MouseControl.o \
 	src/common/RectList.o \
+	src/common/ThreadPool.o \
+	src/common/VideoCapture.o \
 	src/common/ZipHandler.o
 
 MODULE_DIRS += \
@@ -17,7 +17,13 @@
 // $Id: NTSCFilter.cxx 2838 2014-01-17 23:34:03Z stephena $
 //============================================================================
 
-#include "FrameBuffer.hxx"
+#include <fstream>
+#include <sstream>
+#include <cstddef>
+#include <cstdio>
+#include <unistd.h>
+
+#include "PhosphorBlend.hxx"
 #include "Settings.hxx"
 
 #include "NTSCFilter.hxx"
@@ -29,17 +35,214 @@
 NTSCFilter::NTSCFilter()
   : mySetup(atari_ntsc_composite),
     myPreset(PRESET_OFF),
-    myCurrentAdjustable(0)
+    myCurrentAdjustable(0),
+    myThreadPool(NULL)
 {
+  for(int i = 0; i < kKernelCacheSize; ++i)
+    myKernelCache[i] = NULL;
+
+  // Until the first palette is set, use an entry that won't match any key
+  myKernelCache[0] = new CachedKernel;
+  memset(myKernelCache[0], 0, sizeof(CachedKernel));
+  myKernelCache[0]->hasDecoder = 2;
+  myFilter = &myKernelCache[0]->filter;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 NTSCFilter::~NTSCFilter()
 {
+  delete myThreadPool;
+  for(int i = 0; i < kKernelCacheSize; ++i)
+    delete myKernelCache[i];
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void NTSCFilter::setTIAPalette(const FrameBuffer& fb, const uInt32* palette)
+void NTSCFilter::updateFilter()
+{
+  CachedKernel* kernel = new CachedKernel;
+  makeKey(*kernel);
+
+  // Recently used kernels are simply moved to the front of the cache
+  int i;
+  for(i = 0; i < kKernelCacheSize - 1; ++i)
+    if(myKernelCache[i] == NULL || sameKey(*myKernelCache[i], *kernel))
+      break;
+
+  if(myKernelCache[i] && sameKey(*myKernelCache[i], *kernel))
+  {
+    delete kernel;
+    kernel = myKernelCache[i];
+  }
+  else
+  {
+    if(!loadKernel(*kernel))
+    {
+      atari_ntsc_init(&kernel->filter, &mySetup, myTIAPalette);
+      saveKernel(*kernel);
+    }
+    // The last entry (or the first unused one) is replaced
+    delete myKernelCache[i];
+  }
+
+  for(; i > 0; --i)
+    myKernelCache[i] = myKernelCache[i-1];
+  myKernelCache[0] = kernel;
+  myFilter = &kernel->filter;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void NTSCFilter::makeKey(CachedKernel& key) const
+{
+  // Zero everything first, so that keys may be compared bytewise
+  memset(&key, 0, offsetof(CachedKernel, filter));
+
+  key.setup[0] = mySetup.hue;        key.setup[1] = mySetup.saturation;
+  key.setup[2] = mySetup.contrast;   key.setup[3] = mySetup.brightness;
+  key.setup[4] = mySetup.sharpness;  key.setup[5] = mySetup.gamma;
+  key.setup[6] = mySetup.resolution; key.setup[7] = mySetup.artifacts;
+  key.setup[8] = mySetup.fringing;   key.setup[9] = mySetup.bleed;
+  if(mySetup.decoder_matrix)
+  {
+    memcpy(key.decoder, mySetup.decoder_matrix, sizeof(key.decoder));
+    key.hasDecoder = 1;
+  }
+  memcpy(key.palette, myTIAPalette, sizeof(key.palette));
+
+  // FNV-1a, over everything except the hash itself
+  const uInt8* data = (const uInt8*)&key;
+  uInt32 hash = 2166136261u;
+  for(size_t i = 0; i < offsetof(CachedKernel, filter); ++i)
+  {
+    if(i == offsetof(CachedKernel, hash))
+      i += sizeof(key.hash);
+    hash = (hash ^ data[i]) * 16777619u;
+  }
+  key.hash = hash;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool NTSCFilter::sameKey(const CachedKernel& a, const CachedKernel& b)
+{
+  return a.hash == b.hash &&
+         memcmp(&a, &b, offsetof(CachedKernel, filter)) == 0;
+}
+
+// The cache file consists of a header, followed by 'count' records, each
+// one a CachedKernel
+static const char ourCacheMagic[8] = { 'S','t','e','l','N','T','S','C' };
+struct NTSCFilter::CacheFileHeader
+{
+  char magic[8];
+  uInt32 version;     // NTSCFilter::kKernelCacheVersion
+  uInt32 recordSize;  // sizeof(CachedKernel), as a check on the version
+  uInt32 count;       // Number of records in the file
+  uInt32 next;        // Record to replace when the file is full
+};
+
+// Each record is almost 2MB, so only a limited number are kept; when
+// the file fills up, the records are replaced in turn
+static const uInt32 ourCacheMaxRecords = 8;
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool NTSCFilter::readCacheHeader(istream& in, CacheFileHeader& header)
+{
+  return in.read((char*)&header, sizeof(header)) &&
+         memcmp(header.magic, ourCacheMagic, sizeof(ourCacheMagic)) == 0 &&
+         header.version == kKernelCacheVersion &&
+         header.recordSize == sizeof(CachedKernel) &&
+         header.count <= ourCacheMaxRecords && header.next <= header.count &&
+         header.next < ourCacheMaxRecords;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool NTSCFilter::loadKernel(CachedKernel& kernel) const
+{
+  if(myCacheFile == "")
+    return false;
+
+  ifstream in(myCacheFile.c_str(), ios::in | ios::binary);
+  CacheFileHeader header;
+  if(!readCacheHeader(in, header))
+    return false;
+
+  // Only the key is read from each record until a match is found
+  CachedKernel* record = new CachedKernel;
+  bool found = false;
+  for(uInt32 i = 0; i < header.count && !found; ++i)
+  {
+    in.seekg(sizeof(header) + streamoff(i) * sizeof(CachedKernel));
+    if(!in.read((char*)record, offsetof(CachedKernel, filter)))
+      break;
+    if(sameKey(*record, kernel))
+      found = bool(in.read((char*)&kernel.filter, sizeof(kernel.filter)));
+  }
+  delete record;
+
+  // Prepare the blitters, as would have been done when generating them
+  if(found)
+    atari_ntsc_init(NULL, NULL, NULL);
+
+  return found;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void NTSCFilter::saveKernel(const CachedKernel& kernel) const
+{
+  if(myCacheFile == "")
+    return;
+
+  // The file is never modified in place; a new one is written next to it
+  // (named after this process, so several instances don't collide) and
+  // then renamed over it, so that readers only ever see a complete file
+  // (when two instances save at the same time, the last one wins)
+  ostringstream buf;
+  buf << myCacheFile << "." << getpid() << ".tmp";
+  string tempFile = buf.str();
+
+  ifstream in(myCacheFile.c_str(), ios::in | ios::binary);
+  CacheFileHeader header;
+  if(!readCacheHeader(in, header))
+  {
+    memcpy(header.magic, ourCacheMagic, sizeof(ourCacheMagic));
+    header.version = kKernelCacheVersion;
+    header.recordSize = sizeof(CachedKernel);
+    header.count = header.next = 0;
+  }
+
+  // The new kernels go in place of record 'next', which is added at the
+  // end while the file isn't full yet
+  uInt32 replace = header.next;
+  if(header.next == header.count)
+    header.count++;
+  header.next = (header.next + 1) % ourCacheMaxRecords;
+
+  ofstream out(tempFile.c_str(), ios::out | ios::trunc | ios::binary);
+  out.write((const char*)&header, sizeof(header));
+  CachedKernel* record = new CachedKernel;
+  for(uInt32 i = 0; i < header.count && out; ++i)
+  {
+    if(i == replace)
+      out.write((const char*)&kernel, sizeof(CachedKernel));
+    else if(in.seekg(sizeof(header) + streamoff(i) * sizeof(CachedKernel)) &&
+            in.read((char*)record, sizeof(CachedKernel)))
+      out.write((const char*)record, sizeof(CachedKernel));
+    else
+      out.setstate(ios::failbit);
+  }
+  delete record;
+  in.close();
+  out.close();
+
+  if(!out || std::rename(tempFile.c_str(), myCacheFile.c_str()) != 0)
+  {
+    std::remove(tempFile.c_str());
+    cerr << "WARNING: Couldn't save NTSC filter cache file " << myCacheFile << endl;
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void NTSCFilter::setTIAPalette(const Common::PhosphorBlend& phosphor,
+                               const uInt32* palette)
 {
   // Normal TIA palette contains 256 colours, where every odd indexed colour
   // is used for PAL colour-loss effect
@@ -61,9 +264,9 @@ void NTSCFilter::setTIAPalette(const FrameBuffer& fb, const uInt32* palette)
       uInt8 gj = (palette[j] >> 8) & 0xff;
       uInt8 bj = palette[j] & 0xff;
 
-      *ptr++ = fb.getPhosphor(ri, rj);
-      *ptr++ = fb.getPhosphor(gi, gj);
-      *ptr++ = fb.getPhosphor(bi, bj);
+      *ptr++ = phosphor.blendChannel(ri, rj);
+      *ptr++ = phosphor.blendChannel(gi, gj);
+      *ptr++ = phosphor.blendChannel(bi, bj);
     }
   }
   // Set palette for normal fill
@@ -204,6 +407,55 @@ void NTSCFilter::loadConfig(const Settings& settings)
   myCustomSetup.artifacts = BSPF_clamp(settings.getFloat("tv_artifacts"), -1.0f, 1.0f);
   myCustomSetup.fringing = BSPF_clamp(settings.getFloat("tv_fringing"), -1.0f, 1.0f);
   myCustomSetup.bleed = BSPF_clamp(settings.getFloat("tv_bleed"), -1.0f, 1.0f);
+
+  setThreads(BSPF_clamp(settings.getInt("tv_threads"), 0, 16));
+  myCacheFile = settings.getString("tv_cachefile");
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void NTSCFilter::setThreads(uInt32 threads)
+{
+  if(myThreadPool && myThreadPool->threads() == threads)
+    return;
+
+  delete myThreadPool;
+  myThreadPool = NULL;
+  if(threads > 0)
+    myThreadPool = new Common::ThreadPool(threads);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void NTSCFilter::blit(uInt8* src_buf, uInt8* src_back_buf, int src_width,
+                      int src_height, uInt32* dest_buf, long dest_pitch)
+{
+  BlitJob job;
+  job.filter  = myFilter;
+  job.src     = src_buf;
+  job.srcBack = src_back_buf;
+  job.width   = src_width;
+  job.height  = src_height;
+  job.dest    = dest_buf;
+  job.pitch   = dest_pitch;
+
+  // One band per thread; there's little to gain from finer division,
+  // since every line takes the same amount of time to filter
+  myThreadPool->run(job, myThreadPool->threads() + 1);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void NTSCFilter::BlitJob::execute(uInt32 part, uInt32 parts)
+{
+  int first = height * part / parts, last = height * (part + 1) / parts;
+  if(first == last)
+    return;
+
+  uInt8* out = (uInt8*)dest + first * pitch;
+  if(srcBack)
+    atari_ntsc_blit_double(filter, src + first * width, srcBack + first * width,
+                           width, width, last - first, out, pitch);
+  else
+    atari_ntsc_blit_single(filter, src + first * width,
+                           width, width, last - first, out, pitch);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -20,10 +20,13 @@
 #ifndef NTSC_FILTER_HXX
 #define NTSC_FILTER_HXX
 
-class FrameBuffer;
+namespace Common {
+  class PhosphorBlend;
+}
 class Settings;
 
 #include "bspf.hxx"
+#include "ThreadPool.hxx"
 #include "atari_ntsc.h"
 
 /**
@@ -62,9 +65,11 @@ class NTSCFilter
   public:
     /* Informs the NTSC filter about the current TIA palette.  The filter
        uses this as a baseline for calculating its own internal palette
-       in YIQ format.
+       in YIQ format.  The colours used by blit_double() are blended from
+       both frames by the given phosphor stage.
     */
-    void setTIAPalette(const FrameBuffer& fb, const uInt32* palette);
+    void setTIAPalette(const Common::PhosphorBlend& phosphor,
+                       const uInt32* palette);
 
     // The following are meant to be used strictly for toggling from the GUI
     string setPreset(Preset preset);
@@ -74,10 +79,10 @@ class NTSCFilter
 
     // Reinitialises the NTSC filter (automatically called after settings
     // have changed)
-    inline void updateFilter()
-    {
-      atari_ntsc_init(&myFilter, &mySetup, myTIAPalette);
-    }
+    // Generating the filter kernels is slow, so the most recently used
+    // ones are cached (and optionally saved to disk), and reused whenever
+    // the same palette and settings are selected again
+    void updateFilter();
 
     // Get adjustables for the given preset
     // Values will be scaled to 0 - 100 range, independent of how
@@ -104,22 +109,35 @@ class NTSCFilter
     void loadConfig(const Settings& settings);
     void saveConfig(Settings& settings) const;
 
+    // Set the number of extra threads used when filtering (0 disables
+    // threading, and filters entirely in the calling thread)
+    void setThreads(uInt32 threads);
+
     // Perform Blargg filtering on input buffer, place results in
     // output buffer
     // In the current implementation, the source pitch is always the
     // same as the actual width
+    // When threading is enabled, the frame is split into bands of lines
+    // which are filtered in parallel; since each line is filtered
+    // independently, the output is identical either way
     inline void blit_single(uInt8* src_buf, int src_width, int src_height,
                             uInt32* dest_buf, long dest_pitch)
     {
-      atari_ntsc_blit_single(&myFilter, src_buf, src_width, src_width, src_height,
-                             dest_buf, dest_pitch);
+      if(myThreadPool)
+        blit(src_buf, NULL, src_width, src_height, dest_buf, dest_pitch);
+      else
+        atari_ntsc_blit_single(myFilter, src_buf, src_width, src_width,
+                               src_height, dest_buf, dest_pitch);
     }
     inline void blit_double(uInt8* src_buf, uInt8* src_back_buf,
                             int src_width, int src_height,
                             uInt32* dest_buf, long dest_pitch)
     {
-      atari_ntsc_blit_double(&myFilter, src_buf, src_back_buf, src_width, src_width,
-                             src_height, dest_buf, dest_pitch);
+      if(myThreadPool)
+        blit(src_buf, src_back_buf, src_width, src_height, dest_buf, dest_pitch);
+      else
+        atari_ntsc_blit_double(myFilter, src_buf, src_back_buf, src_width,
+                               src_width, src_height, dest_buf, dest_pitch);
     }
 
   private:
@@ -127,9 +145,75 @@ class NTSCFilter
     void convertToAdjustable(Adjustable& adjustable,
                              const atari_ntsc_setup_t& setup) const;
 
+    // Version of the kernels in the cache file; this must be increased
+    // whenever atari_ntsc_init() generates different kernels for the same
+    // palette and setup, or the layout of CachedKernel changes, so that
+    // files written by older versions are ignored
+    enum { kKernelCacheVersion = 1 };
+
+    // Kernels generated for a given palette and setup; the layout is also
+    // used for the records of the cache file, so that they may be read
+    // (or mapped) directly into memory
+    struct CachedKernel
+    {
+      double setup[10];     // atari_ntsc_setup_t values, in order
+      float decoder[6];     // Decoder matrix (all 0 when none is used)
+      uInt32 hasDecoder;
+      uInt32 hash;          // Hash of everything above, and the palette
+      uInt8 palette[atari_ntsc_palette_size * 3];
+      atari_ntsc_t filter;
+    };
+
+    // Fill in the key fields (everything but the filter) for the current
+    // palette and setup
+    void makeKey(CachedKernel& key) const;
+
+    // Answers whether the given entries are for the same palette and setup
+    static bool sameKey(const CachedKernel& a, const CachedKernel& b);
+
+    // Header of the cache file (defined in NTSCFilter.cxx)
+    struct CacheFileHeader;
+
+    // Read the header of the cache file, answering whether it's valid
+    // for this version
+    static bool readCacheHeader(istream& in, CacheFileHeader& header);
+
+    // Look for kernels in the cache file, returning true (and filling in
+    // 'kernel') if they were found
+    bool loadKernel(CachedKernel& kernel) const;
+
+    // Add kernels to the cache file
+    void saveKernel(const CachedKernel& kernel) const;
+
+    // Filter the frame using the thread pool (blit_double when
+    // 'src_back_buf' is non-null, otherwise blit_single)
+    void blit(uInt8* src_buf, uInt8* src_back_buf, int src_width,
+              int src_height, uInt32* dest_buf, long dest_pitch);
+
+    // Filters one band of lines of a frame, as part of a threaded blit
+    class BlitJob : public Common::ThreadPool::Job
+    {
+      public:
+        void execute(uInt32 part, uInt32 parts);
+
+        const atari_ntsc_t* filter;
+        uInt8 *src, *srcBack;
+        int width, height;
+        uInt32* dest;
+        long pitch;
+    };
+
   private:
-    // The NTSC filter structure
-    atari_ntsc_t myFilter;
+    // The NTSC filter structure currently in use (part of myKernelCache[0])
+    atari_ntsc_t* myFilter;
+
+    // The most recently used kernels, most recent first (unused entries
+    // are NULL)
+    enum { kKernelCacheSize = 4 };
+    CachedKernel* myKernelCache[kKernelCacheSize];
+
+    // File used to keep kernels across runs (empty to disable)
+    string myCacheFile;
 
     // Contains controls used to adjust the palette in the NTSC filter
     // This is the main setup object used by the underlying ntsc code
@@ -160,6 +244,14 @@ class NTSCFilter
     };
     uInt32 myCurrentAdjustable;
     static const AdjustableTag ourCustomAdjustables[10];
+
+    // Threads used for filtering (NULL when threading is disabled)
+    Common::ThreadPool* myThreadPool;
+
+  private:
+    // Following constructors and assignment operators not supported
+    NTSCFilter(const NTSCFilter&);
+    NTSCFilter& operator = (const NTSCFilter&);
 };
 
 #endif
@@ -19,6 +19,15 @@
 
 #include "atari_ntsc.h"
 
+/* The SIMD blitters are only built for x86 compilers that can generate code
+   for instruction sets not enabled for the rest of the program */
+#if (defined(__x86_64__) || defined(__i386__)) && \
+    (defined(__clang__) || (defined(__GNUC__) && \
+     (__GNUC__ > 4 || (__GNUC__ == 4 && __GNUC_MINOR__ >= 9))))
+  #define ATARI_NTSC_X86 1
+  #include <immintrin.h>
+#endif
+
 /* Copyright (C) 2006-2009 Shay Green. This module is free software; you
    can redistribute it and/or modify it under the terms of the GNU Lesser
    General Public License as published by the Free Software Foundation; either
@@ -68,11 +77,177 @@ static void correct_errors( atari_ntsc_rgb_t color, atari_ntsc_rgb_t* out )
   }
 }
 
+#ifdef ATARI_NTSC_X86
+
+/* Vector versions of the blitter inner loop. Every chunk of two input pixels
+   generates seven output pixels, each the sum of four kernel entries:
+
+     out 0-3:  a [0-3]  + b1 [17-20] + ax [ 7-10] + bx [24-27]
+     out 4-6:  a [4-6]  + b  [14-16] + ax [11-13] + b1 [21-23]
+
+   where 'a' and 'b' are the kernels of the chunk's two input pixels, 'ax' is
+   'a' from the previous chunk, and 'b1' and 'bx' are 'b' from the previous
+   two chunks (this is exactly what the ATARI_NTSC_* macros compute). The sums
+   are then clamped and converted to 8888 format, as in the macros.
+
+   The caller provides the kernels for the whole row: the black kernel, the
+   first input pixel, and then two per chunk (including the final chunk). */
+typedef void (*atari_ntsc_row_t)( atari_ntsc_rgb_t const* const* kernels,
+    int chunks, atari_ntsc_out_t* out );
+
+__attribute__((target("sse2")))
+static __m128i atari_ntsc_finish_sse2( __m128i raw )
+{
+  __m128i const mask = _mm_set1_epi32( atari_ntsc_clamp_mask );
+  __m128i sub   = _mm_and_si128( _mm_srli_epi32( raw, 9 ), mask );
+  __m128i clamp = _mm_sub_epi32( _mm_set1_epi32( atari_ntsc_clamp_add ), sub );
+  raw   = _mm_or_si128( raw, clamp );
+  clamp = _mm_sub_epi32( clamp, sub );
+  raw   = _mm_and_si128( raw, clamp );
+
+  return _mm_or_si128( _mm_or_si128(
+      _mm_and_si128( _mm_srli_epi32( raw, 5 ), _mm_set1_epi32( 0x00FF0000 ) ),
+      _mm_and_si128( _mm_srli_epi32( raw, 3 ), _mm_set1_epi32( 0x0000FF00 ) ) ),
+      _mm_and_si128( _mm_srli_epi32( raw, 1 ), _mm_set1_epi32( 0x000000FF ) ) );
+}
+
+#define LOAD4( p ) _mm_loadu_si128( (__m128i const*) (p) )
+
+__attribute__((target("sse2")))
+static void atari_ntsc_row_sse2( atari_ntsc_rgb_t const* const* kernels,
+    int chunks, atari_ntsc_out_t* out )
+{
+  atari_ntsc_rgb_t const* ax = kernels [0];
+  atari_ntsc_rgb_t const* bx = kernels [0];
+  atari_ntsc_rgb_t const* b1 = kernels [1];
+  kernels += 2;
+
+  while ( chunks-- )
+  {
+    atari_ntsc_rgb_t const* a = kernels [0];
+    atari_ntsc_rgb_t const* b = kernels [1];
+    __m128i lo, hi;
+    kernels += 2;
+
+    /* the fourth lane of 'hi' is junk, but is still within the entries */
+    lo = _mm_add_epi32( _mm_add_epi32( LOAD4( a     ), LOAD4( b1 + 17 ) ),
+                        _mm_add_epi32( LOAD4( ax + 7 ), LOAD4( bx + 24 ) ) );
+    hi = _mm_add_epi32( _mm_add_epi32( LOAD4( a + 4  ), LOAD4( b  + 14 ) ),
+                        _mm_add_epi32( LOAD4( ax + 11 ), LOAD4( b1 + 21 ) ) );
+    lo = atari_ntsc_finish_sse2( lo );
+    hi = atari_ntsc_finish_sse2( hi );
+
+    _mm_storeu_si128( (__m128i*) out, lo );
+    _mm_storel_epi64( (__m128i*) (out + 4), hi );
+    out [6] = (atari_ntsc_out_t) _mm_cvtsi128_si32( _mm_srli_si128( hi, 8 ) );
+    out += 7;
+
+    ax = a;
+    bx = b1;
+    b1 = b;
+  }
+}
+
+__attribute__((target("avx2")))
+static void atari_ntsc_row_avx2( atari_ntsc_rgb_t const* const* kernels,
+    int chunks, atari_ntsc_out_t* out )
+{
+  __m256i const mask    = _mm256_set1_epi32( atari_ntsc_clamp_mask );
+  __m256i const add     = _mm256_set1_epi32( atari_ntsc_clamp_add );
+  __m256i const store7  = _mm256_setr_epi32( -1, -1, -1, -1, -1, -1, -1, 0 );
+  atari_ntsc_rgb_t const* ax = kernels [0];
+  atari_ntsc_rgb_t const* bx = kernels [0];
+  atari_ntsc_rgb_t const* b1 = kernels [1];
+  kernels += 2;
+
+  while ( chunks-- )
+  {
+    atari_ntsc_rgb_t const* a = kernels [0];
+    atari_ntsc_rgb_t const* b = kernels [1];
+    __m256i raw, sub, clamp, rgb;
+    kernels += 2;
+
+    /* all seven outputs at once; the 'b' terms come from two kernels each,
+       one for each half of the vector */
+    raw = _mm256_add_epi32(
+        _mm256_add_epi32( _mm256_loadu_si256( (__m256i const*) a ),
+                          _mm256_loadu_si256( (__m256i const*) (ax + 7) ) ),
+        _mm256_add_epi32(
+          _mm256_inserti128_si256( _mm256_castsi128_si256( LOAD4( b1 + 17 ) ),
+                                   LOAD4( b + 14 ), 1 ),
+          _mm256_inserti128_si256( _mm256_castsi128_si256( LOAD4( bx + 24 ) ),
+                                   LOAD4( b1 + 21 ), 1 ) ) );
+
+    sub   = _mm256_and_si256( _mm256_srli_epi32( raw, 9 ), mask );
+    clamp = _mm256_sub_epi32( add, sub );
+    raw   = _mm256_or_si256( raw, clamp );
+    clamp = _mm256_sub_epi32( clamp, sub );
+    raw   = _mm256_and_si256( raw, clamp );
+
+    rgb = _mm256_or_si256( _mm256_or_si256(
+        _mm256_and_si256( _mm256_srli_epi32( raw, 5 ), _mm256_set1_epi32( 0x00FF0000 ) ),
+        _mm256_and_si256( _mm256_srli_epi32( raw, 3 ), _mm256_set1_epi32( 0x0000FF00 ) ) ),
+        _mm256_and_si256( _mm256_srli_epi32( raw, 1 ), _mm256_set1_epi32( 0x000000FF ) ) );
+    _mm256_maskstore_epi32( (int*) out, store7, rgb );
+    out += 7;
+
+    ax = a;
+    bx = b1;
+    b1 = b;
+  }
+}
+
+#undef LOAD4
+
+/* The row function in use, or NULL to use the macros */
+static atari_ntsc_row_t atari_ntsc_row = 0;
+
+#endif
+
+/* Whether the row function has been chosen yet */
+static int atari_ntsc_row_selected = 0;
+
+int atari_ntsc_set_simd( int level )
+{
+  int selected = atari_ntsc_simd_none;
+
+#ifdef ATARI_NTSC_X86
+  __builtin_cpu_init();
+  atari_ntsc_row = 0;
+  if ( level >= atari_ntsc_simd_avx2 && __builtin_cpu_supports( "avx2" ) )
+  {
+    atari_ntsc_row = atari_ntsc_row_avx2;
+    selected = atari_ntsc_simd_avx2;
+  }
+  else if ( level >= atari_ntsc_simd_sse2 && __builtin_cpu_supports( "sse2" ) )
+  {
+    atari_ntsc_row = atari_ntsc_row_sse2;
+    selected = atari_ntsc_simd_sse2;
+  }
+#else
+  (void) level;
+#endif
+
+  atari_ntsc_row_selected = 1;
+  return selected;
+}
+
 void atari_ntsc_init( atari_ntsc_t* ntsc, atari_ntsc_setup_t const* setup,
                       atari_ntsc_in_t const* palette )
 {
   int entry;
   init_t impl;
+
+  /* done here rather than in the blitters, since they may run in several
+     threads at once */
+  if ( !atari_ntsc_row_selected )
+    atari_ntsc_set_simd( atari_ntsc_simd_best );
+
+  /* without a palette there are no kernels to generate (the table may have
+     been filled in some other way), and only the blitters are prepared */
+  if ( !palette )
+    return;
+
   if ( !setup )
     setup = &atari_ntsc_composite;
   init( &impl, setup );
@@ -107,6 +282,28 @@ void atari_ntsc_blit_single( atari_ntsc_t const* ntsc,
   #define TO_SINGLE(pixel) ((1<<14)+(pixel>>1))
 
   int const chunk_count = (in_width - 1) / atari_ntsc_in_chunk;
+
+#ifdef ATARI_NTSC_X86
+  if ( atari_ntsc_row )
+  {
+    int const count = 2 + 2 * (chunk_count + 1);
+    atari_ntsc_rgb_t const* kernels [count];
+    while ( in_height-- )
+    {
+      int n;
+      kernels [0] = ATARI_NTSC_ENTRY_( ntsc, TO_SINGLE(atari_ntsc_black) );
+      for ( n = 1; n < count - 2; n++ )
+        kernels [n] = ATARI_NTSC_ENTRY_( ntsc, TO_SINGLE(atari_in[n - 1]) );
+      kernels [count - 2] = kernels [count - 1] = kernels [0];
+
+      atari_ntsc_row( kernels, chunk_count + 1, (atari_ntsc_out_t*) rgb_out );
+      atari_in += in_row_width;
+      rgb_out = (char*) rgb_out + out_pitch;
+    }
+    return;
+  }
+#endif
+
   while ( in_height-- )
   {
     atari_ntsc_in_t const* line_in = atari_in;
@@ -158,6 +355,31 @@ void atari_ntsc_blit_double( atari_ntsc_t const* ntsc,
   #define TO_DOUBLE(pixel1, pixel2) (((pixel1>>1)<<7)+(pixel2>>1))
 
   int const chunk_count = (in_width - 1) / atari_ntsc_in_chunk;
+
+#ifdef ATARI_NTSC_X86
+  if ( atari_ntsc_row )
+  {
+    int const count = 2 + 2 * (chunk_count + 1);
+    atari_ntsc_rgb_t const* kernels [count];
+    while ( in_height-- )
+    {
+      int n;
+      kernels [0] = ATARI_NTSC_ENTRY_( ntsc,
+          TO_DOUBLE(atari_ntsc_black, atari_ntsc_black) );
+      for ( n = 1; n < count - 2; n++ )
+        kernels [n] = ATARI_NTSC_ENTRY_( ntsc,
+            TO_DOUBLE(atari_in1[n - 1], atari_in2[n - 1]) );
+      kernels [count - 2] = kernels [count - 1] = kernels [0];
+
+      atari_ntsc_row( kernels, chunk_count + 1, (atari_ntsc_out_t*) rgb_out );
+      atari_in1 += in_row_width;
+      atari_in2 += in_row_width;
+      rgb_out = (char*) rgb_out + out_pitch;
+    }
+    return;
+  }
+#endif
+
   while ( in_height-- )
   {
     atari_ntsc_in_t const* line_in1 = atari_in1;
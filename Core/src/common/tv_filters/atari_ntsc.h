@@ -58,7 +58,9 @@ extern atari_ntsc_setup_t const atari_ntsc_bad;       /* badly adjusted TV */
 enum { atari_ntsc_palette_size = 129 * 128 };
 
 /* Initializes and adjusts parameters. Can be called multiple times on the same
-   atari_ntsc_t object. Can pass NULL for either parameter. */
+   atari_ntsc_t object. Can pass NULL for either of the first two parameters.
+   With a NULL palette, nothing is generated; this must still be called once
+   before blitting with a table obtained some other way (ie, a saved copy). */
 typedef struct atari_ntsc_t atari_ntsc_t;
 void atari_ntsc_init( atari_ntsc_t* ntsc, atari_ntsc_setup_t const* setup,
                       atari_ntsc_in_t const* palette );
@@ -75,6 +77,17 @@ void atari_ntsc_blit_double( atari_ntsc_t const* ntsc,
     long in_row_width, int in_width, int in_height,
     void* rgb_out, long out_pitch );
 
+/* Selects the version of the blitters' inner loop: atari_ntsc_simd_none for the
+   portable macros, atari_ntsc_simd_sse2 or atari_ntsc_simd_avx2, or
+   atari_ntsc_simd_best for the best one the CPU supports (the default, chosen
+   by the first atari_ntsc_init()). Returns the version actually selected,
+   which is lower than the one asked for when the CPU or compiler can't run it.
+   All versions produce identical output; this is meant for testing them, and
+   must not be called while blitting. */
+enum { atari_ntsc_simd_none = 0, atari_ntsc_simd_sse2 = 1,
+       atari_ntsc_simd_avx2 = 2, atari_ntsc_simd_best = 2 };
+int atari_ntsc_set_simd( int level );
+
 /* Number of output pixels written by blitter for given input width. Width might
    be rounded down slightly; use ATARI_NTSC_IN_WIDTH() on result to find rounded
    value. Guaranteed not to round 160 down at all. */
@@ -118,7 +131,10 @@ enum { atari_ntsc_black     = 0  }; /* palette index for black */
 
 /* private */
 enum { atari_ntsc_entry_size = 2 * 14 };
-typedef unsigned long atari_ntsc_rgb_t;
+/* Only the low 32 bits of the kernel entries (and of the sums made from them)
+   are ever significant, so a 32-bit type halves the size of the table without
+   changing the output, and lets the SIMD blitters work on 4 or 8 at once */
+typedef unsigned int atari_ntsc_rgb_t;
 struct atari_ntsc_t {
 	atari_ntsc_rgb_t table [atari_ntsc_palette_size] [atari_ntsc_entry_size];
 };
@@ -0,0 +1,266 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2014 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//
+// $Id$
+//============================================================================
+
+#include <cstring>
+
+#include "OSystem.hxx"
+#include "Console.hxx"
+#include "M6532.hxx"
+#include "Settings.hxx"
+#include "Switches.hxx"
+#include "System.hxx"
+#include "TIA.hxx"
+
+#include "BatchRunner.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+BatchRunner::BatchRunner(uInt32 threads)
+  : myPool(threads),
+    myReward(NULL),
+    myFrameSkip(1),
+    myMaxPool(false),
+    myObserve(true),
+    myFrames(0),
+    myRAMRing(NULL),
+    myRAMSlots(0),
+    myBuffer(NULL),
+    myBufferSize(0),
+    myRewardsOffset(0),
+    myFramesOffset(0),
+    myFrameWidth(0),
+    myFrameHeight(0),
+    myFrameSize(0)
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+BatchRunner::~BatchRunner()
+{
+  unload();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool BatchRunner::load(const uInt8* image, uInt32 size, uInt32 consoles,
+                       uInt32 width, uInt32 height)
+{
+  unload();
+
+  // Select the observation code before the threads get to it
+  Common::Observation::implementation();
+
+  // The consoles are created one at a time, since creating a TIA fills
+  // tables shared by all of them
+  for(uInt32 i = 0; i < consoles; ++i)
+  {
+    Instance instance;
+    instance.osystem = new OSystem();
+    instance.settings = new Settings(instance.osystem);
+
+    instance.console = Console::create(instance.osystem, *instance.settings,
+                                       image, size);
+    if(instance.console == NULL)
+    {
+      delete instance.settings;
+      delete instance.osystem;
+      unload();
+      return false;
+    }
+
+    // Sound is never opened, so the TIA doesn't generate any
+    instance.osystem->myConsole = instance.console;
+    instance.console->initializeVideo();
+
+    instance.observation = NULL;
+    instance.palette = NULL;
+    if(width > 0 && height > 0)
+    {
+      instance.observation = new Common::Observation();
+      instance.observation->setSize(width, height);
+      instance.observation->setMaxPool(myMaxPool);
+    }
+    instance.input.clear(instance.console->switches().positions());
+
+    myConsoles.push_back(instance);
+  }
+
+  if(myConsoles.size() > 0 && myConsoles[0].observation)
+  {
+    myFrameWidth = myConsoles[0].observation->width();
+    myFrameHeight = myConsoles[0].observation->height();
+  }
+  myFrameSize = myFrameWidth * myFrameHeight;
+
+  myRewardsOffset = consoles * 128;
+  myFramesOffset = myRewardsOffset + consoles * sizeof(float);
+  myBufferSize = myFramesOffset + consoles * myFrameSize;
+  myBuffer = new uInt8[myBufferSize];
+  memset(myBuffer, 0, myBufferSize);
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void BatchRunner::setMaxPool(bool enable)
+{
+  myMaxPool = enable;
+  for(uInt32 i = 0; i < myConsoles.size(); ++i)
+    if(myConsoles[i].observation)
+      myConsoles[i].observation->setMaxPool(enable);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void BatchRunner::setRAMRing(uInt8* ring, uInt32 slots)
+{
+  myRAMRing = slots > 0 ? ring : NULL;
+  myRAMSlots = slots;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void BatchRunner::reset()
+{
+  for(uInt32 i = 0; i < myConsoles.size(); ++i)
+    myConsoles[i].console->system().reset();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void BatchRunner::reset(const uInt32* seeds)
+{
+  for(uInt32 i = 0; i < myConsoles.size(); ++i)
+  {
+    System& system = myConsoles[i].console->system();
+    system.randGenerator().setState(seeds[i]);
+    system.reset();
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void BatchRunner::step(const uInt8* actions, bool observe)
+{
+  for(uInt32 i = 0; i < myConsoles.size(); ++i)
+    setAction(i, actions[i]);
+
+  stepAll(observe);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void BatchRunner::step(const FrameInput* inputs, bool observe)
+{
+  for(uInt32 i = 0; i < myConsoles.size(); ++i)
+    myConsoles[i].input = inputs[i];
+
+  stepAll(observe);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void BatchRunner::setAction(uInt32 index, uInt8 action)
+{
+  FrameInput& input = myConsoles[index].input;
+
+  input.joystick[0] = action & (kUp | kDown | kLeft | kRight | kFire);
+  input.paddleFire = (input.paddleFire & ~1) | ((action & kFire) ? 1 : 0);
+  input.switches &= ~(FrameInput::kSelect | FrameInput::kReset);
+  if(action & kSelect)
+    input.switches |= FrameInput::kSelect;
+  if(action & kReset)
+    input.switches |= FrameInput::kReset;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void BatchRunner::stepAll(bool observe)
+{
+  // Each console is a separate part, so that the threads which finish
+  // their consoles first take over the remaining ones
+  myObserve = observe;
+  StepJob job(*this);
+  myPool.run(job, myConsoles.size());
+
+  myFrames += myFrameSkip;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void BatchRunner::stepConsole(uInt32 index)
+{
+  Instance& instance = myConsoles[index];
+  Console& console = *instance.console;
+
+  console.applyInput(instance.input);
+
+  // Only the frames the observation is made from are drawn; when pooling,
+  // the last frame of a step is drawn even without an observation, as
+  // the next step may pool it with its own (ie, with a frame skip of 1)
+  TIA& tia = console.tia();
+  bool observe = myObserve && instance.observation != NULL;
+  uInt32 drawn = 0;
+  if(instance.observation != NULL)
+    drawn = myMaxPool ? (myObserve ? 2 : 1) : (myObserve ? 1 : 0);
+
+  uInt8* ram = myBuffer + index * 128;
+  float reward = 0;
+  for(uInt32 frame = 0; frame < myFrameSkip; ++frame)
+  {
+    tia.enableVideo(frame + drawn >= myFrameSkip);
+    tia.update();
+
+    memcpy(ram, console.riot().getRAM(), 128);
+    if(myRAMRing)
+      memcpy(myRAMRing + (index * myRAMSlots +
+             (myFrames + frame) % myRAMSlots) * 128, ram, 128);
+
+    if(myReward)
+      reward += myReward->reward(index, console, ram);
+  }
+  tia.enableVideo(true);
+
+  float* rewards = (float*)(myBuffer + myRewardsOffset);
+  rewards[index] = reward;
+
+  if(observe)
+  {
+    // The palette changes with the display format, ie, after a reset
+    if(instance.palette != console.currentPalette())
+    {
+      instance.palette = console.currentPalette();
+      instance.observation->setPalette(instance.palette);
+    }
+    instance.observation->render(
+        myBuffer + myFramesOffset + index * myFrameSize,
+        tia.frameBuffer(0), tia.frameBuffer(1), tia.width(), tia.height());
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void BatchRunner::unload()
+{
+  for(uInt32 i = 0; i < myConsoles.size(); ++i)
+  {
+    Instance& instance = myConsoles[i];
+    delete instance.observation;
+    delete instance.console;
+    instance.osystem->myConsole = 0;
+    delete instance.settings;
+    delete instance.osystem;
+  }
+  myConsoles.clear();
+  myFrames = 0;
+
+  delete[] myBuffer;
+  myBuffer = NULL;
+  myBufferSize = 0;
+  myFrameWidth = myFrameHeight = myFrameSize = 0;
+}
@@ -0,0 +1,286 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2014 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//
+// $Id$
+//============================================================================
+
+
+#ifndef BATCH_RUNNER_HXX
+#define BATCH_RUNNER_HXX
+
+class Console;
+class OSystem;
+class Settings;
+
+#include <vector>
+
+#include "bspf.hxx"
+#include "FrameInput.hxx"
+#include "Observation.hxx"
+#include "ThreadPool.hxx"
+
+/**
+  Runs many consoles of the same game in lockstep, one frame at a time,
+  ie, as the environments of a reinforcement learning agent.
+
+  Each console is fully independent: it has its own OSystem (and so its
+  own events, settings, random number generator and sound), and shares
+  nothing with the others apart from the (read-only) ROM image.  A step
+  sets the input of every console, either from an array of actions or of
+  complete frame inputs (see FrameInput), emulates a frame on each of
+  them across a pool of threads, and then collects the results into a
+  single buffer allocated once when the game is loaded:
+
+    RAM:      128 bytes per console (the RIOT RAM at the end of the frame)
+    Rewards:  one float per console (see Reward)
+    Frames:   a grayscale observation of each frame (optional; see
+              Common::Observation)
+
+  Sound is disabled, and the frames are never converted to RGB pixels.
+
+  A step may cover several frames emulated with the same action (see
+  setFrameSkip).  Video is then only generated for the frames the
+  observation is made from (the last one, or the last two when pooling),
+  and not at all for steps taken without an observation, which is all
+  that agents using only the RAM need.  When pooling, a step taken
+  without an observation still draws its last frame, so the next step
+  always pools with the frame just before its own.  The RAM can also be collected
+  after every single frame, into a ring supplied by the caller.
+*/
+class BatchRunner
+{
+  public:
+    /**
+      The actions accepted by 'step', as bits to be combined; the joystick
+      actions are those of the left joystick (and kFire is also the button
+      of paddle 0).  Any other input is left as the last frame input given
+      to the console.
+    */
+    enum Action {
+      kUp     = 1 << 0,
+      kDown   = 1 << 1,
+      kLeft   = 1 << 2,
+      kRight  = 1 << 3,
+      kFire   = 1 << 4,
+      kSelect = 1 << 5,
+      kReset  = 1 << 6
+    };
+
+    /**
+      Interface for computing the reward earned by a console on each step.
+    */
+    class Reward
+    {
+      public:
+        virtual ~Reward() { }
+
+        /**
+          Answers the reward earned during the frame just emulated; the
+          reward of a step is the sum of those of its frames.  This is
+          called from the threads of the pool, but never for the same
+          console on two threads at once.
+
+          @param index    The console, from 0 to 'consoles() - 1'
+          @param console  The console itself
+          @param ram      Its RIOT RAM at the end of the frame
+        */
+        virtual float reward(uInt32 index, const Console& console,
+                             const uInt8* ram) = 0;
+    };
+
+  public:
+    /**
+      Create a runner using the given number of threads.
+
+      @param threads  The number of worker threads, in addition to the
+                      thread calling 'step'
+    */
+    BatchRunner(uInt32 threads);
+    virtual ~BatchRunner();
+
+  public:
+    /**
+      Create the given number of consoles for a game, replacing any
+      previous ones, and allocate the buffer receiving their results.
+
+      @param image     The ROM image
+      @param size      The size of the image
+      @param consoles  The number of consoles to create
+      @param width     The width of the observations (ie, 84), or 0 for
+                       no observations
+      @param height    Their height (ie, 84)
+
+      @return  False if the ROM can't be loaded
+    */
+    bool load(const uInt8* image, uInt32 size, uInt32 consoles,
+              uInt32 width = 0, uInt32 height = 0);
+
+    /**
+      Set whether each observation is the maximum of the last two frames
+      (see Common::Observation::setMaxPool).
+    */
+    void setMaxPool(bool enable);
+
+    /**
+      Set the number of frames emulated by each step, all with the same
+      action (ie, 4).  This can be changed between any two steps.
+    */
+    void setFrameSkip(uInt32 frames) { myFrameSkip = BSPF_max(frames, 1u); }
+
+    /**
+      Set the ring receiving the RAM of every console after each frame
+      emulated, or NULL for none.  The RAM of console 'i' after frame 'f'
+      (counted by frames()) is at 'ring + (i * slots + f % slots) * 128',
+      so the ring needs 'consoles() * slots * 128' bytes.
+
+      @param ring   The ring, owned by the caller
+      @param slots  The number of frames kept for each console
+    */
+    void setRAMRing(uInt8* ring, uInt32 slots);
+
+    /**
+      Set the hook computing the rewards, or NULL for none (the rewards
+      are then all zero).
+    */
+    void setReward(Reward* reward) { myReward = reward; }
+
+    /**
+      Reset every console, as if it had just been switched on.
+    */
+    void reset();
+
+    /**
+      Reset every console as above, first seeding its random generator
+      (which is otherwise seeded from the time, and decides the initial
+      state of RAM and of some carts).  Consoles given the same seeds
+      then start out exactly alike.
+
+      @param seeds  The seed of each console
+    */
+    void reset(const uInt32* seeds);
+
+    /**
+      Emulate one step on every console, and collect the results.
+
+      @param actions  The action (a combination of Action bits) of each
+                      console
+      @param observe  Whether to render observations for this step; if
+                      not, no video is generated (apart from the last
+                      frame when pooling), and the frames of the previous
+                      observation are left in the buffer
+    */
+    void step(const uInt8* actions, bool observe = true);
+
+    /**
+      Emulate one step on every console, giving each the complete input
+      of its frames.
+
+      @param inputs   The input of each console
+      @param observe  As above
+    */
+    void step(const FrameInput* inputs, bool observe = true);
+
+    /**
+      Answers the number of frames emulated on each console since the
+      game was loaded.
+    */
+    uInt32 frames() const { return myFrames; }
+
+    uInt32 consoles() const { return myConsoles.size(); }
+    Console& console(uInt32 index) const { return *myConsoles[index].console; }
+
+    /**
+      Answers the buffer holding the results of the last step, and its
+      size in bytes.  The parts below point into it.
+    */
+    const uInt8* buffer() const { return myBuffer; }
+    uInt32 bufferSize() const   { return myBufferSize; }
+
+    const uInt8* ram(uInt32 index) const
+      { return myBuffer + index * 128; }
+    const float* rewards() const
+      { return (const float*)(myBuffer + myRewardsOffset); }
+    const uInt8* frame(uInt32 index) const
+      { return myBuffer + myFramesOffset + index * myFrameSize; }
+
+    uInt32 frameWidth() const  { return myFrameWidth; }
+    uInt32 frameHeight() const { return myFrameHeight; }
+
+  private:
+    // Emulate a step on the given console, and collect its results
+    void stepConsole(uInt32 index);
+
+    // Set the input of the given console from an action
+    void setAction(uInt32 index, uInt8 action);
+
+    // Emulate a step on every console, with the inputs already set
+    void stepAll(bool observe);
+
+    // Destroy all the consoles
+    void unload();
+
+  private:
+    // The job run by the pool, one part per console
+    class StepJob : public Common::ThreadPool::Job
+    {
+      public:
+        StepJob(BatchRunner& runner) : myRunner(runner) { }
+
+        void execute(uInt32 part, uInt32 parts)
+          { myRunner.stepConsole(part); }
+
+      private:
+        BatchRunner& myRunner;
+    };
+
+    // Everything making up one console
+    struct Instance {
+      OSystem* osystem;
+      Settings* settings;
+      Console* console;
+      Common::Observation* observation;
+      const uInt32* palette;    // The palette the observation was set to
+      FrameInput input;         // The input of the next step
+    };
+
+    Common::ThreadPool myPool;
+    vector<Instance> myConsoles;
+    Reward* myReward;
+
+    // How each step is emulated
+    uInt32 myFrameSkip;
+    bool myMaxPool;
+    bool myObserve;
+
+    // The frames emulated so far, and where their RAM goes
+    uInt32 myFrames;
+    uInt8* myRAMRing;
+    uInt32 myRAMSlots;
+
+    // The results, and the layout of the frames
+    uInt8* myBuffer;
+    uInt32 myBufferSize;
+    uInt32 myRewardsOffset;
+    uInt32 myFramesOffset;
+    uInt32 myFrameWidth, myFrameHeight, myFrameSize;
+
+  private:
+    // Following constructors and assignment operators not supported
+    BatchRunner(const BatchRunner&);
+    BatchRunner& operator = (const BatchRunner&);
+};
+
+#endif
@@ -178,19 +178,19 @@ Cartridge* Cartridge::create(const uInt8* image, uInt32 size, string& md5,
 
   // We should know the cart's type by now so let's create it
   if(type == "0840")
-    cartridge = new Cartridge0840(image, size, settings);
+    cartridge = new Cartridge0840(image, size, md5, settings);
   else if(type == "2K")
     cartridge = new Cartridge2K(image, size, settings);
   else if(type == "3E")
-    cartridge = new Cartridge3E(image, size, settings);
+    cartridge = new Cartridge3E(image, size, md5, settings);
   else if(type == "3F")
-    cartridge = new Cartridge3F(image, size, settings);
+    cartridge = new Cartridge3F(image, size, md5, settings);
   else if(type == "4A50")
     cartridge = new Cartridge4A50(image, size, settings);
   else if(type == "4K")
-    cartridge = new Cartridge4K(image, size, settings);
+    cartridge = new Cartridge4K(image, size, md5, settings);
   else if(type == "4KSC")
-    cartridge = new Cartridge4KSC(image, size, settings);
+    cartridge = new Cartridge4KSC(image, size, md5, settings);
   else if(type == "AR")
     cartridge = new CartridgeAR(image, size, settings);
   else if(type == "CM")
@@ -204,49 +204,49 @@ Cartridge* Cartridge::create(const uInt8* image, uInt32 size, string& md5,
   else if(type == "DPC+")
     cartridge = new CartridgeDPCPlus(image, size, settings);
   else if(type == "E0")
-    cartridge = new CartridgeE0(image, size, settings);
+    cartridge = new CartridgeE0(image, size, md5, settings);
   else if(type == "E7")
-    cartridge = new CartridgeE7(image, size, settings);
+    cartridge = new CartridgeE7(image, size, md5, settings);
   else if(type == "EF")
-    cartridge = new CartridgeEF(image, size, settings);
+    cartridge = new CartridgeEF(image, size, md5, settings);
   else if(type == "EFSC")
-    cartridge = new CartridgeEFSC(image, size, settings);
+    cartridge = new CartridgeEFSC(image, size, md5, settings);
   else if(type == "BF")
-    cartridge = new CartridgeBF(image, size, settings);
+    cartridge = new CartridgeBF(image, size, md5, settings);
   else if(type == "BFSC")
-    cartridge = new CartridgeBFSC(image, size, settings);
+    cartridge = new CartridgeBFSC(image, size, md5, settings);
   else if(type == "DF")
-    cartridge = new CartridgeDF(image, size, settings);
+    cartridge = new CartridgeDF(image, size, md5, settings);
   else if(type == "DFSC")
-    cartridge = new CartridgeDFSC(image, size, settings);
+    cartridge = new CartridgeDFSC(image, size, md5, settings);
   else if(type == "F0" || type == "MB")
-    cartridge = new CartridgeF0(image, size, settings);
+    cartridge = new CartridgeF0(image, size, md5, settings);
   else if(type == "F4")
-    cartridge = new CartridgeF4(image, size, settings);
+    cartridge = new CartridgeF4(image, size, md5, settings);
   else if(type == "F4SC")
-    cartridge = new CartridgeF4SC(image, size, settings);
+    cartridge = new CartridgeF4SC(image, size, md5, settings);
   else if(type == "F6")
-    cartridge = new CartridgeF6(image, size, settings);
+    cartridge = new CartridgeF6(image, size, md5, settings);
   else if(type == "F6SC")
-    cartridge = new CartridgeF6SC(image, size, settings);
+    cartridge = new CartridgeF6SC(image, size, md5, settings);
   else if(type == "F8")
     cartridge = new CartridgeF8(image, size, md5, settings);
   else if(type == "F8SC")
-    cartridge = new CartridgeF8SC(image, size, settings);
+    cartridge = new CartridgeF8SC(image, size, md5, settings);
   else if(type == "FA" || type == "FASC")
-    cartridge = new CartridgeFA(image, size, settings);
+    cartridge = new CartridgeFA(image, size, md5, settings);
   else if(type == "FA2")
     cartridge = new CartridgeFA2(image, size, osystem);
   else if(type == "FE")
-    cartridge = new CartridgeFE(image, size, settings);
+    cartridge = new CartridgeFE(image, size, md5, settings);
   else if(type == "MC")
     cartridge = new CartridgeMC(image, size, settings);
   else if(type == "UA")
-    cartridge = new CartridgeUA(image, size, settings);
+    cartridge = new CartridgeUA(image, size, md5, settings);
   else if(type == "SB")
-    cartridge = new CartridgeSB(image, size, settings);
+    cartridge = new CartridgeSB(image, size, md5, settings);
   else if(type == "X07")
-    cartridge = new CartridgeX07(image, size, settings);
+    cartridge = new CartridgeX07(image, size, md5, settings);
   else if(dtype == "WRONG_SIZE")
   {
     string err = "Invalid cart size for type '" + type + "'";
@@ -297,7 +297,10 @@ Cartridge::Cartridge(const Settings& settings)
     myStartBank(0),
     myBankChanged(true),
     myCodeAccessBase(NULL),
-    myBankLocked(false)
+    myBankPages(NULL),
+    myBankPageCount(0),
+    myBankLocked(false),
+    myPrivateImage(NULL)
 {
 }
 
@@ -306,6 +309,21 @@ Cartridge::~Cartridge()
 {
   if(myCodeAccessBase)
     delete[] myCodeAccessBase;
+  delete[] myBankPages;
+  delete[] myPrivateImage;
+
+  // Release the shared ROM image (if any) once nobody else uses it
+  if(mySharedImageKey != "")
+  {
+    pthread_mutex_lock(&ourSharedImagesMutex);
+    SharedImageMap::iterator iter = ourSharedImages.find(mySharedImageKey);
+    if(--iter->second.users == 0)
+    {
+      delete[] iter->second.image;
+      ourSharedImages.erase(iter);
+    }
+    pthread_mutex_unlock(&ourSharedImagesMutex);
+  }
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -374,6 +392,102 @@ void Cartridge::createCodeAccessBase(uInt32 size)
 #endif
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Cartridge::createBankPages(uInt32 size)
+{
+  delete[] myBankPages;
+  myBankPages = new System::PageAccess[size];
+  myBankPageCount = size;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt8* Cartridge::shareImage(const uInt8* image, uInt32 length,
+                             const string& md5, uInt32 size)
+{
+  // The MD5 was already computed by the caller of create(), and the size
+  // tells apart the copies padded differently, so the image needn't be
+  // hashed again (unless the caller didn't give its MD5)
+  ostringstream key;
+  key << (md5 != "" ? md5 : MD5(image, length)) << ":" << size;
+  mySharedImageKey = key.str();
+
+  // Use the existing copy if another cartridge has already shared this image
+  pthread_mutex_lock(&ourSharedImagesMutex);
+  SharedImageMap::iterator iter = ourSharedImages.find(mySharedImageKey);
+  uInt8* shared;
+  if(iter != ourSharedImages.end())
+  {
+    iter->second.users++;
+    shared = iter->second.image;
+  }
+  else
+  {
+    shared = new uInt8[size];
+    memset(shared, 0, size);
+    memcpy(shared, image, BSPF_min(length, size));
+
+    SharedImage entry;
+    entry.image = shared;
+    entry.size  = size;
+    entry.users = 1;
+    ourSharedImages.insert(make_pair(mySharedImageKey, entry));
+  }
+  pthread_mutex_unlock(&ourSharedImagesMutex);
+
+  return shared;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Cartridge::unshareImage(uInt8*& image)
+{
+  if(mySharedImageKey == "")
+    return;
+
+  pthread_mutex_lock(&ourSharedImagesMutex);
+  SharedImageMap::iterator iter = ourSharedImages.find(mySharedImageKey);
+  SharedImage& entry = iter->second;
+  mySharedImageKey = "";
+
+  // If we're the only user, we can simply take ownership of the image
+  if(entry.users == 1)
+  {
+    myPrivateImage = entry.image;
+    ourSharedImages.erase(iter);
+    pthread_mutex_unlock(&ourSharedImagesMutex);
+    return;
+  }
+
+  myPrivateImage = new uInt8[entry.size];
+  memcpy(myPrivateImage, entry.image, entry.size);
+  entry.users--;
+
+  // Any pages which directly access the old image must now use the copy
+  uInt8* oldImage = entry.image;
+  uInt32 size = entry.size;
+  pthread_mutex_unlock(&ourSharedImagesMutex);
+  if(mySystem)
+  {
+    for(uInt32 page = 0; page < mySystem->numberOfPages(); ++page)
+    {
+      System::PageAccess access = mySystem->getPageAccess(page);
+      if(access.device == this && access.directPeekBase >= oldImage &&
+         access.directPeekBase < oldImage + size)
+      {
+        access.directPeekBase = myPrivateImage + (access.directPeekBase - oldImage);
+        mySystem->setPageAccess(page, access);
+      }
+    }
+  }
+  for(uInt32 i = 0; i < myBankPageCount; ++i)
+  {
+    System::PageAccess& access = myBankPages[i];
+    if(access.directPeekBase >= oldImage && access.directPeekBase < oldImage + size)
+      access.directPeekBase = myPrivateImage + (access.directPeekBase - oldImage);
+  }
+
+  image = myPrivateImage;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 string Cartridge::autodetectType(const uInt8* image, uInt32 size)
 {
@@ -947,3 +1061,9 @@ Cartridge& Cartridge::operator = (const Cartridge&)
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 string Cartridge::myAboutString= "";
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Cartridge::SharedImageMap Cartridge::ourSharedImages;
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+pthread_mutex_t Cartridge::ourSharedImagesMutex = PTHREAD_MUTEX_INITIALIZER;
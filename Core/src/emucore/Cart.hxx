@@ -20,8 +20,11 @@
 #ifndef CARTRIDGE_HXX
 #define CARTRIDGE_HXX
 
+#include <pthread.h>
 #include <fstream>
 #include <sstream>
+#include <map>
+#include <vector>
 
 class Cartridge;
 class Properties;
@@ -30,7 +33,9 @@ class GuiObject;
 
 #include "bspf.hxx"
 #include "Array.hxx"
+#include "CartRAM.hxx"
 #include "Device.hxx"
+#include "System.hxx"
 #include "Settings.hxx"
 #include "Font.hxx"
 
@@ -124,6 +129,35 @@ class Cartridge : public Device
 
     const RamAreaList& ramAreas() { return myRamAreaList; }
 
+    /**
+      The state saved by save(), as plain data (see ConsoleSnapshot): the
+      banks (or slices) selected, any other registers of the scheme, and
+      the contents of the extended RAM.  Small RAM is copied in full, while
+      large RAM (a CartRAM) is saved as pages shared copy-on-write with the
+      cart.  Schemes with more registers than fit in here (ie, those with
+      a coprocessor) copy the rest of their state into 'state', as raw
+      bytes.  Only the schemes whose state fits in here support snapshots.
+    */
+    struct Snapshot {
+      uInt16 bank[4];
+      uInt16 registers[4];
+      uInt8 RAM[2048];
+      CartRAM::Pages pages;
+      vector<uInt8> state;
+    };
+
+    /**
+      Copy the current state of the cart to the given snapshot.
+
+      @return  False if this scheme doesn't support snapshots
+    */
+    virtual bool saveSnapshot(Snapshot& s) const { return false; }
+
+    /**
+      Restore the state of the cart from a snapshot taken by saveSnapshot().
+    */
+    virtual void loadSnapshot(const Snapshot& s) { }
+
   public:
     //////////////////////////////////////////////////////////////////////
     // The following methods are cart-specific and must be implemented
@@ -238,6 +272,48 @@ class Cartridge : public Device
     */
     void createCodeAccessBase(uInt32 size);
 
+    /**
+      Create an array to hold precomputed page accessing methods, so that
+      a scheme can install a complete bank with a single block copy
+      (see System::setPageAccess) rather than rebuilding each page on
+      every bankswitch.  Any previously created array is released.
+
+      @param size  The number of page access entries to create
+    */
+    void createBankPages(uInt32 size);
+
+    /**
+      Get a read-only copy of the given ROM image, padded with zeroes
+      to 'size' bytes.  Identical images are held only once and shared
+      by every cartridge using them, so that many instances of the same
+      ROM don't each keep their own copy.  The shared image is released
+      when the last cartridge using it is destroyed.
+
+      Since the image may be shared, it must never be modified directly;
+      call unshareImage() first.
+
+      @param image   The ROM image to share
+      @param length  The number of bytes in 'image'
+      @param md5     MD5sum of the ROM image (as computed by create())
+      @param size    The size of the shared image (at most 'length'
+                     bytes of 'image' are used)
+      @return  Pointer to the shared image
+    */
+    uInt8* shareImage(const uInt8* image, uInt32 length, const string& md5,
+                      uInt32 size);
+
+    /**
+      Make sure the image obtained from shareImage() is used only by this
+      cartridge, so that it can be modified (as done by patch()).  If the
+      image is in use by other cartridges, it is copied, and any page
+      accessing methods pointing into it (including those created by
+      createBankPages) are updated to use the copy.
+
+      @param image  The image from shareImage(); updated to point to the
+                    private copy (if one was made)
+    */
+    void unshareImage(uInt8*& image);
+
   private:
     /**
       Get an image pointer and size for a ROM that is part of a larger,
@@ -396,6 +472,13 @@ class Cartridge : public Device
     // whether it is used as code.
     uInt8* myCodeAccessBase;
 
+    // Precomputed page accessing methods for each bank (only used by
+    // schemes which call createBankPages)
+    System::PageAccess* myBankPages;
+
+    // Number of entries in the myBankPages array
+    uInt32 myBankPageCount;
+
   private:
     // Contains RamArea entries for those carts with accessible RAM.
     RamAreaList myRamAreaList;
@@ -404,9 +487,32 @@ class Cartridge : public Device
     // by the debugger, when disassembling/dumping ROM.
     bool myBankLocked;
 
+    // Key (in ourSharedImages) of the shared ROM image used by this
+    // cartridge, or empty if it doesn't use one
+    string mySharedImageKey;
+
+    // The copy of the ROM image made by unshareImage(), if any
+    uInt8* myPrivateImage;
+
     // Contains info about this cartridge in string format
     static string myAboutString;
 
+    // Information about a ROM image shared between cartridges
+    struct SharedImage
+    {
+      uInt8* image;
+      uInt32 size;
+      uInt32 users;
+    };
+    typedef map<string, SharedImage> SharedImageMap;
+
+    // All currently shared ROM images, indexed by the MD5 of the ROM image
+    // and the size of the shared copy;
+    // cartridges may be created and destroyed on any thread, so the map is
+    // protected by a mutex
+    static SharedImageMap ourSharedImages;
+    static pthread_mutex_t ourSharedImagesMutex;
+
     // Copy constructor isn't supported by cartridges so make it private
     Cartridge(const Cartridge&);
 
@@ -24,11 +24,12 @@
 #include "Cart0840.hxx"
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-Cartridge0840::Cartridge0840(const uInt8* image, uInt32 size, const Settings& settings)
+Cartridge0840::Cartridge0840(const uInt8* image, uInt32 size, const string& md5,
+                             const Settings& settings)
   : Cartridge(settings)
 {
-  // Copy the ROM image into my buffer
-  memcpy(myImage, image, BSPF_min(8192u, size));
+  // Get the (possibly shared) ROM image
+  myImage = shareImage(image, size, md5, 8192);
   createCodeAccessBase(8192);
 
   // Remember startup bank
@@ -181,6 +182,8 @@ uInt16 Cartridge0840::bankCount() const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool Cartridge0840::patch(uInt16 address, uInt8 value)
 {
+  unshareImage(myImage);
+
   myImage[(myCurrentBank << 12) + (address & 0x0fff)] = value;
   return myBankChanged = true;
 }
@@ -230,3 +233,17 @@ bool Cartridge0840::load(Serializer& in)
 
   return true;
 }
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Cartridge0840::saveSnapshot(Snapshot& s) const
+{
+  s.bank[0] = myCurrentBank;
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Cartridge0840::loadSnapshot(const Snapshot& s)
+{
+  bank(s.bank[0]);
+}
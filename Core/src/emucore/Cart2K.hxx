@@ -119,6 +119,13 @@ class Cartridge2K : public Cartridge
     */
     bool load(Serializer& in);
 
+    /**
+      Copy the current state of this cart to/from the given snapshot
+      (there's nothing to copy).
+    */
+    bool saveSnapshot(Snapshot& s) const { return true; }
+    void loadSnapshot(const Snapshot& s) { }
+
     /**
       Get a descriptor for the device name (used in error checking).
 
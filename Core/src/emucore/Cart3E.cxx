@@ -25,16 +25,15 @@
 #include "Cart3E.hxx"
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-Cartridge3E::Cartridge3E(const uInt8* image, uInt32 size,
+Cartridge3E::Cartridge3E(const uInt8* image, uInt32 size, const string& md5,
                          const Settings& settings)
   : Cartridge(settings),
+    myCurrentBank(0),
+    myRAM(32 * 1024),
     mySize(size)
 {
-  // Allocate array for the ROM image
-  myImage = new uInt8[mySize];
-
-  // Copy the ROM image into my buffer
-  memcpy(myImage, image, mySize);
+  // Get the (possibly shared) ROM image
+  myImage = shareImage(image, size, md5, mySize);
   createCodeAccessBase(mySize + 32768);
 
   // This cart can address a 1024 byte bank of RAM @ 0x1000
@@ -49,7 +48,6 @@ Cartridge3E::Cartridge3E(const uInt8* image, uInt32 size,
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Cartridge3E::~Cartridge3E()
 {
-  delete[] myImage;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -60,7 +58,8 @@ void Cartridge3E::reset()
     for(uInt32 i = 0; i < 32768; ++i)
       myRAM[i] = mySystem->randGenerator().next();
   else
-    memset(myRAM, 0, 32768);
+    memset(myRAM.data(), 0, 32768);
+  myRAM.touchAll();
 
   // We'll map the startup bank into the first segment upon reset
   bank(myStartBank);
@@ -122,7 +121,7 @@ uInt8 Cartridge3E::peek(uInt16 address)
         else
         {
           triggerReadFromWritePort(peekAddress);
-          return myRAM[(address & 0x03FF) + ((myCurrentBank - 256) << 10)] = value;
+          return myRAM.poke((address & 0x03FF) + ((myCurrentBank - 256) << 10), value);
         }
       }
     }
@@ -163,6 +162,9 @@ bool Cartridge3E::bank(uInt16 bank)
 { 
   if(bankLocked()) return false;
 
+  // Writes to the RAM bank being unmapped must be seen by the snapshots
+  touchMappedRAM();
+
   if(bank < 256)
   {
     // Make sure the bank they're asking for is reasonable
@@ -246,6 +248,8 @@ uInt16 Cartridge3E::bankCount() const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool Cartridge3E::patch(uInt16 address, uInt8 value)
 {
+  unshareImage(myImage);
+
   address &= 0x0FFF;
 
   if(address < 0x0800)
@@ -253,7 +257,7 @@ bool Cartridge3E::patch(uInt16 address, uInt8 value)
     if(myCurrentBank < 256)
       myImage[(address & 0x07FF) + (myCurrentBank << 11)] = value;
     else
-      myRAM[(address & 0x03FF) + ((myCurrentBank - 256) << 10)] = value;
+      myRAM.poke((address & 0x03FF) + ((myCurrentBank - 256) << 10), value);
   }
   else
     myImage[(address & 0x07FF) + mySize - 2048] = value;
@@ -275,7 +279,7 @@ bool Cartridge3E::save(Serializer& out) const
   {
     out.putString(name());
     out.putShort(myCurrentBank);
-    out.putByteArray(myRAM, 32768);
+    out.putByteArray(myRAM.data(), 32768);
   }
   catch(...)
   {
@@ -295,7 +299,8 @@ bool Cartridge3E::load(Serializer& in)
       return false;
 
     myCurrentBank = in.getShort();
-    in.getByteArray(myRAM, 32768);
+    in.getByteArray(myRAM.data(), 32768);
+    myRAM.touchAll();
   }
   catch(...)
   {
@@ -308,3 +313,23 @@ bool Cartridge3E::load(Serializer& in)
 
   return true;
 }
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Cartridge3E::saveSnapshot(Snapshot& s) const
+{
+  touchMappedRAM();
+
+  s.bank[0] = myCurrentBank;
+  myRAM.save(s.pages);
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Cartridge3E::loadSnapshot(const Snapshot& s)
+{
+  touchMappedRAM();
+  myRAM.load(s.pages);
+
+  bank(s.bank[0]);
+}
@@ -74,9 +74,11 @@ class Cartridge3E : public Cartridge
 
       @param image     Pointer to the ROM image
       @param size      The size of the ROM image
+      @param md5       MD5sum of the ROM image
       @param settings  A reference to the various settings (read-only)
     */
-    Cartridge3E(const uInt8* image, uInt32 size, const Settings& settings);
+    Cartridge3E(const uInt8* image, uInt32 size, const string& md5,
+                const Settings& settings);
  
     /**
       Destructor
@@ -147,6 +149,12 @@ class Cartridge3E : public Cartridge
     */
     bool load(Serializer& in);
 
+    /**
+      Copy the current state of this cart to/from the given snapshot.
+    */
+    bool saveSnapshot(Snapshot& s) const;
+    void loadSnapshot(const Snapshot& s);
+
     /**
       Get a descriptor for the device name (used in error checking).
 
@@ -183,15 +191,23 @@ class Cartridge3E : public Cartridge
     */
     bool poke(uInt16 address, uInt8 value);
 
+  private:
+    // Collect the writes to the RAM bank mapped in the write port, if any
+    void touchMappedRAM() const
+    {
+      if(myCurrentBank >= 256)
+        myRAM.touchMapped(*mySystem, 0x1400, (myCurrentBank - 256) << 10, 0x400);
+    }
+
   private:
     // Indicates which bank is currently active for the first segment
     uInt16 myCurrentBank;
 
-    // Pointer to a dynamically allocated ROM image of the cartridge
+    // Pointer to the (possibly shared) ROM image of the cartridge
     uInt8* myImage;
 
     // RAM contents. For now every ROM gets all 32K of potential RAM
-    uInt8 myRAM[32 * 1024];
+    CartRAM myRAM;
 
     // Size of the ROM image
     uInt32 mySize;
@@ -25,16 +25,13 @@
 #include "Cart3F.hxx"
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-Cartridge3F::Cartridge3F(const uInt8* image, uInt32 size,
+Cartridge3F::Cartridge3F(const uInt8* image, uInt32 size, const string& md5,
                          const Settings& settings)
   : Cartridge(settings),
     mySize(size)
 {
-  // Allocate array for the ROM image
-  myImage = new uInt8[mySize];
-
-  // Copy the ROM image into my buffer
-  memcpy(myImage, image, mySize);
+  // Get the (possibly shared) ROM image
+  myImage = shareImage(image, size, md5, mySize);
   createCodeAccessBase(mySize);
 
   // Remember startup bank
@@ -44,7 +41,6 @@ Cartridge3F::Cartridge3F(const uInt8* image, uInt32 size,
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 Cartridge3F::~Cartridge3F()
 {
-  delete[] myImage;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -82,6 +78,18 @@ void Cartridge3F::install(System& system)
     mySystem->setPageAccess(j >> shift, access);
   }
 
+  // Precompute the page access methods for each of the 2K banks
+  uInt16 pages = 0x0800 >> shift;
+  uInt32 size = uInt32(bankCount()) << 11;
+  createBankPages(bankCount() * pages);
+
+  for(uInt32 offset = 0; offset < size; offset += (1 << shift))
+  {
+    access.directPeekBase = &myImage[offset];
+    access.codeAccessBase = &myCodeAccessBase[offset];
+    myBankPages[offset >> shift] = access;
+  }
+
   // Install pages for startup bank into the first segment
   bank(myStartBank);
 }
@@ -138,19 +146,13 @@ bool Cartridge3F::bank(uInt16 bank)
     myCurrentBank = bank % (mySize >> 11);
   }
 
-  uInt32 offset = myCurrentBank << 11;
   uInt16 shift = mySystem->pageShift();
+  uInt16 pages = 0x0800 >> shift;
 
-  // Setup the page access methods for the current bank
-  System::PageAccess access(0, 0, 0, this, System::PA_READ);
+  // Install the precomputed page access methods for the current bank
+  mySystem->setPageAccess(0x1000 >> shift, &myBankPages[myCurrentBank * pages],
+                          pages);
 
-  // Map ROM image into the system
-  for(uInt32 address = 0x1000; address < 0x1800; address += (1 << shift))
-  {
-    access.directPeekBase = &myImage[offset + (address & 0x07FF)];
-    access.codeAccessBase = &myCodeAccessBase[offset + (address & 0x07FF)];
-    mySystem->setPageAccess(address >> shift, access);
-  }
   return myBankChanged = true;
 }
 
@@ -169,6 +171,8 @@ uInt16 Cartridge3F::bankCount() const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool Cartridge3F::patch(uInt16 address, uInt8 value)
 {
+  unshareImage(myImage);
+
   address &= 0x0FFF;
 
   if(address < 0x0800)
@@ -224,3 +228,17 @@ bool Cartridge3F::load(Serializer& in)
 
   return true;
 }
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Cartridge3F::saveSnapshot(Snapshot& s) const
+{
+  s.bank[0] = myCurrentBank;
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Cartridge3F::loadSnapshot(const Snapshot& s)
+{
+  bank(s.bank[0]);
+}
@@ -51,9 +51,11 @@ class Cartridge3F : public Cartridge
 
       @param image     Pointer to the ROM image
       @param size      The size of the ROM image
+      @param md5       MD5sum of the ROM image
       @param settings  A reference to the various settings (read-only)
     */
-    Cartridge3F(const uInt8* image, uInt32 size, const Settings& settings);
+    Cartridge3F(const uInt8* image, uInt32 size, const string& md5,
+                const Settings& settings);
  
     /**
       Destructor
@@ -124,6 +126,12 @@ class Cartridge3F : public Cartridge
     */
     bool load(Serializer& in);
 
+    /**
+      Copy the current state of this cart to/from the given snapshot.
+    */
+    bool saveSnapshot(Snapshot& s) const;
+    void loadSnapshot(const Snapshot& s);
+
     /**
       Get a descriptor for the device name (used in error checking).
 
@@ -164,7 +172,7 @@ class Cartridge3F : public Cartridge
     // Indicates which bank is currently active for the first segment
     uInt16 myCurrentBank;
 
-    // Pointer to a dynamically allocated ROM image of the cartridge
+    // Pointer to the (possibly shared) ROM image of the cartridge
     uInt8* myImage;
 
     // Size of the ROM image
@@ -29,6 +29,7 @@
 Cartridge4A50::Cartridge4A50(const uInt8* image, uInt32 size,
                              const Settings& settings)
   : Cartridge(settings),
+    myRAM(32768),
     mySize(size)
 {
   // Copy the ROM image into my buffer
@@ -62,7 +63,8 @@ void Cartridge4A50::reset()
     for(uInt32 i = 0; i < 32768; ++i)
       myRAM[i] = mySystem->randGenerator().next();
   else
-    memset(myRAM, 0, 32768);
+    memset(myRAM.data(), 0, 32768);
+  myRAM.touchAll();
 
   mySliceLow = mySliceMiddle = mySliceHigh = 0;
   myIsRomLow = myIsRomMiddle = myIsRomHigh = true;
@@ -164,7 +166,7 @@ bool Cartridge4A50::poke(uInt16 address, uInt8 value)
     {
       if(!myIsRomLow)
       {
-        myRAM[(address & 0x7ff) + mySliceLow] = value;
+        myRAM.poke((address & 0x7ff) + mySliceLow, value);
         myBankChanged = true;
       }
     }
@@ -173,7 +175,7 @@ bool Cartridge4A50::poke(uInt16 address, uInt8 value)
     {
       if(!myIsRomMiddle)
       {
-        myRAM[(address & 0x7ff) + mySliceMiddle] = value;
+        myRAM.poke((address & 0x7ff) + mySliceMiddle, value);
         myBankChanged = true;
       }
     }
@@ -181,7 +183,7 @@ bool Cartridge4A50::poke(uInt16 address, uInt8 value)
     {
       if(!myIsRomHigh)
       {
-        myRAM[(address & 0xff) + mySliceHigh] = value;
+        myRAM.poke((address & 0xff) + mySliceHigh, value);
         myBankChanged = true;
       }
     }
@@ -366,7 +368,7 @@ bool Cartridge4A50::patch(uInt16 address, uInt8 value)
     if(myIsRomLow)
       myImage[(address & 0x7ff) + mySliceLow] = value;
     else
-      myRAM[(address & 0x7ff) + mySliceLow] = value;
+      myRAM.poke((address & 0x7ff) + mySliceLow, value);
   }
   else if(((address & 0x1fff) >= 0x1800) &&  // 1.5K region from 0x1800 - 0x1dff
           ((address & 0x1fff) <= 0x1dff))
@@ -374,14 +376,14 @@ bool Cartridge4A50::patch(uInt16 address, uInt8 value)
     if(myIsRomMiddle)
       myImage[(address & 0x7ff) + mySliceMiddle + 0x10000] = value;
     else
-      myRAM[(address & 0x7ff) + mySliceMiddle] = value;
+      myRAM.poke((address & 0x7ff) + mySliceMiddle, value);
   }
   else if((address & 0x1f00) == 0x1e00)      // 256B region from 0x1e00 - 0x1eff
   {
     if(myIsRomHigh)
       myImage[(address & 0xff) + mySliceHigh + 0x10000] = value;
     else
-      myRAM[(address & 0xff) + mySliceHigh] = value;
+      myRAM.poke((address & 0xff) + mySliceHigh, value);
   }
   else if((address & 0x1f00) == 0x1f00)      // 256B region from 0x1f00 - 0x1fff
   {
@@ -405,7 +407,7 @@ bool Cartridge4A50::save(Serializer& out) const
     out.putString(name());
 
     // The 32K bytes of RAM
-    out.putByteArray(myRAM, 32768);
+    out.putByteArray(myRAM.data(), 32768);
 
     // Index pointers
     out.putShort(mySliceLow);
@@ -438,7 +440,8 @@ bool Cartridge4A50::load(Serializer& in)
     if(in.getString() != name())
       return false;
 
-    in.getByteArray(myRAM, 32768);
+    in.getByteArray(myRAM.data(), 32768);
+    myRAM.touchAll();
 
     // Index pointers
     mySliceLow = in.getShort();
@@ -462,3 +465,32 @@ bool Cartridge4A50::load(Serializer& in)
 
   return true;
 }
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Cartridge4A50::saveSnapshot(Snapshot& s) const
+{
+  s.bank[0] = mySliceLow;
+  s.bank[1] = mySliceMiddle;
+  s.bank[2] = mySliceHigh;
+  s.registers[0] = (myIsRomLow ? 1 : 0) | (myIsRomMiddle ? 2 : 0) |
+                   (myIsRomHigh ? 4 : 0);
+  s.registers[1] = myLastData;
+  s.registers[2] = myLastAddress;
+  myRAM.save(s.pages);
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Cartridge4A50::loadSnapshot(const Snapshot& s)
+{
+  mySliceLow = s.bank[0];
+  mySliceMiddle = s.bank[1];
+  mySliceHigh = s.bank[2];
+  myIsRomLow = s.registers[0] & 1;
+  myIsRomMiddle = s.registers[0] & 2;
+  myIsRomHigh = s.registers[0] & 4;
+  myLastData = s.registers[1];
+  myLastAddress = s.registers[2];
+  myRAM.load(s.pages);
+}
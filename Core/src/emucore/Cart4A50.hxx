@@ -132,6 +132,12 @@ class Cartridge4A50 : public Cartridge
     */
     bool load(Serializer& in);
 
+    /**
+      Copy the current state of this cart to/from the given snapshot.
+    */
+    bool saveSnapshot(Snapshot& s) const;
+    void loadSnapshot(const Snapshot& s);
+
     /**
       Get a descriptor for the device name (used in error checking).
 
@@ -233,7 +239,7 @@ class Cartridge4A50 : public Cartridge
     uInt8 myImage[131072];
 
     // The 32K of RAM on the cartridge
-    uInt8 myRAM[32768];
+    CartRAM myRAM;
 
     // (Actual) Size of the ROM image
     uInt32 mySize;
@@ -24,11 +24,12 @@
 #include "Cart4K.hxx"
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-Cartridge4K::Cartridge4K(const uInt8* image, uInt32 size, const Settings& settings)
+Cartridge4K::Cartridge4K(const uInt8* image, uInt32 size, const string& md5,
+                         const Settings& settings)
   : Cartridge(settings)
 {
-  // Copy the ROM image into my buffer
-  memcpy(myImage, image, BSPF_min(4096u, size));
+  // Get the (possibly shared) ROM image
+  myImage = shareImage(image, size, md5, 4096);
   createCodeAccessBase(4096);
 }
 
@@ -100,6 +101,8 @@ uInt16 Cartridge4K::bankCount() const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool Cartridge4K::patch(uInt16 address, uInt8 value)
 {
+  unshareImage(myImage);
+
   myImage[address & 0x0FFF] = value;
   return myBankChanged = true;
 } 
@@ -43,9 +43,11 @@ class Cartridge4K : public Cartridge
 
       @param image     Pointer to the ROM image
       @param size      The size of the ROM image
+      @param md5       MD5sum of the ROM image
       @param settings  A reference to the various settings (read-only)
     */
-    Cartridge4K(const uInt8* image, uInt32 size, const Settings& settings);
+    Cartridge4K(const uInt8* image, uInt32 size, const string& md5,
+                const Settings& settings);
  
     /**
       Destructor
@@ -116,6 +118,13 @@ class Cartridge4K : public Cartridge
     */
     bool load(Serializer& in);
 
+    /**
+      Copy the current state of this cart to/from the given snapshot
+      (there's nothing to copy).
+    */
+    bool saveSnapshot(Snapshot& s) const { return true; }
+    void loadSnapshot(const Snapshot& s) { }
+
     /**
       Get a descriptor for the device name (used in error checking).
 
@@ -153,8 +162,8 @@ class Cartridge4K : public Cartridge
     bool poke(uInt16 address, uInt8 value);
 
   private:
-    // The 4K ROM image for the cartridge
-    uInt8 myImage[4096];
+    // The 4K ROM image for the cartridge (possibly shared)
+    uInt8* myImage;
 };
 
 #endif
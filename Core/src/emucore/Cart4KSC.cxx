@@ -24,11 +24,12 @@
 #include "Cart4KSC.hxx"
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-Cartridge4KSC::Cartridge4KSC(const uInt8* image, uInt32 size, const Settings& settings)
+Cartridge4KSC::Cartridge4KSC(const uInt8* image, uInt32 size, const string& md5,
+                             const Settings& settings)
   : Cartridge(settings)
 {
-  // Copy the ROM image into my buffer
-  memcpy(myImage, image, BSPF_min(4096u, size));
+  // Get the (possibly shared) ROM image
+  myImage = shareImage(image, size, md5, 4096);
   createCodeAccessBase(4096);
 
   // This cart contains 128 bytes extended RAM @ 0x1000
@@ -146,6 +147,8 @@ uInt16 Cartridge4KSC::bankCount() const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool Cartridge4KSC::patch(uInt16 address, uInt8 value)
 {
+  unshareImage(myImage);
+
   address &= 0x0FFF;
 
   if(address < 0x0100)
@@ -208,3 +211,19 @@ bool Cartridge4KSC::load(Serializer& in)
 
   return true;
 }
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Cartridge4KSC::saveSnapshot(Snapshot& s) const
+{
+  s.bank[0] = myCurrentBank;
+  memcpy(s.RAM, myRAM, 128);
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Cartridge4KSC::loadSnapshot(const Snapshot& s)
+{
+  memcpy(myRAM, s.RAM, 128);
+  bank(s.bank[0]);
+}
@@ -43,9 +43,11 @@ class Cartridge4KSC : public Cartridge
 
       @param image     Pointer to the ROM image
       @param size      The size of the ROM image
+      @param md5       MD5sum of the ROM image
       @param settings  A reference to the various settings (read-only)
     */
-    Cartridge4KSC(const uInt8* image, uInt32 size, const Settings& settings);
+    Cartridge4KSC(const uInt8* image, uInt32 size, const string& md5,
+                  const Settings& settings);
  
     /**
       Destructor
@@ -116,6 +118,12 @@ class Cartridge4KSC : public Cartridge
     */
     bool load(Serializer& in);
 
+    /**
+      Copy the current state of this cart to/from the given snapshot.
+    */
+    bool saveSnapshot(Snapshot& s) const;
+    void loadSnapshot(const Snapshot& s);
+
     /**
       Get a descriptor for the device name (used in error checking).
 
@@ -156,8 +164,8 @@ class Cartridge4KSC : public Cartridge
     // Indicates which bank is currently active
     uInt16 myCurrentBank;
 
-    // The 8K ROM image of the cartridge
-    uInt8 myImage[4096];
+    // The 8K ROM image of the cartridge (possibly shared)
+    uInt8* myImage;
 
     // The 128 bytes of RAM
     uInt8 myRAM[128];
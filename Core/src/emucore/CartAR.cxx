@@ -29,7 +29,11 @@ CartridgeAR::CartridgeAR(const uInt8* image, uInt32 size,
                          const Settings& settings)
   : Cartridge(settings),
     my6502(0),
-    mySize(BSPF_max(size, 8448u))
+    mySize(BSPF_max(size, 8448u)),
+    myLastAccessAddress(0),
+    myAccessesTrapped(false),
+    mySystemPages(0),
+    myFastLoad(false)
 {
   // Create a load image buffer and copy the given image
   myLoadImages = new uInt8[mySize];
@@ -53,6 +57,7 @@ CartridgeAR::CartridgeAR(const uInt8* image, uInt32 size,
 CartridgeAR::~CartridgeAR()
 {
   delete[] myLoadImages;
+  delete[] mySystemPages;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -77,6 +82,7 @@ void CartridgeAR::reset()
   myDataHoldRegister = 0;
   myNumberOfDistinctAccesses = 0;
   myWritePending = false;
+  trapAccesses(false);
 
   // Set bank configuration upon reset so ROM is selected and powered up
   bankConfiguration(0);
@@ -110,54 +116,77 @@ void CartridgeAR::install(System& system)
   for(uInt32 i = 0x1000; i < 0x2000; i += (1 << shift))
     mySystem->setPageAccess(i >> shift, access);
 
+  delete[] mySystemPages;
+  mySystemPages = new System::PageAccess[0x1000 >> shift];
+  myAccessesTrapped = false;
+
   bankConfiguration(0);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt8 CartridgeAR::peek(uInt16 addr)
 {
+  // Accesses to the rest of the system only come here while they're
+  // being counted (see trapAccesses)
+  if(!(addr & 0x1000))
+  {
+    if(!bankLocked())
+      countAccess(addr);
+
+    const System::PageAccess& access =
+      mySystemPages[(addr & 0x0FFF) >> mySystem->pageShift()];
+    if(access.directPeekBase)
+      return *(access.directPeekBase + (addr & mySystem->pageMask()));
+    else
+      return access.device->peek(addr);
+  }
+
   // In debugger/bank-locked mode, we ignore all hotspots and in general
   // anything that can change the internal state of the cart
   if(bankLocked())
     return myImage[(addr & 0x07FF) + myImageOffset[(addr & 0x0800) ? 1 : 0]];
 
+  countAccess(addr);
+
   // Is the "dummy" SC BIOS hotspot for reading a load being accessed?
   if(((addr & 0x1FFF) == 0x1850) && (myImageOffset[1] == (3 << 11)))
   {
     // Get load that's being accessed (BIOS places load number at 0x80)
+    // Reading the load isn't done by the CPU, so it mustn't be counted
+    bool trapped = myAccessesTrapped;
+    trapAccesses(false);
     uInt8 load = mySystem->peek(0x0080);
 
     // Read the specified load into RAM
-    loadIntoRAM(load);
+    bool loaded = loadIntoRAM(load);
+    trapAccesses(trapped);
 
-    return myImage[(addr & 0x07FF) + myImageOffset[1]];
-  }
+    // Either run the rest of the "dummy" BIOS, or do its work right here
+    if(myFastLoad && loaded)
+      return startLoad();
 
-  // Cancel any pending write if more than 5 distinct accesses have occurred
-  // TODO: Modify to handle when the distinct counter wraps around...
-  if(myWritePending && 
-      (my6502->distinctAccesses() > myNumberOfDistinctAccesses + 5))
-  {
-    myWritePending = false;
+    return myImage[(addr & 0x07FF) + myImageOffset[1]];
   }
 
   // Is the data hold register being set?
   if(!(addr & 0x0F00) && (!myWriteEnabled || !myWritePending))
   {
     myDataHoldRegister = addr;
-    myNumberOfDistinctAccesses = my6502->distinctAccesses();
+    myNumberOfDistinctAccesses = 0;
     myWritePending = true;
+    trapAccesses(myWriteEnabled);
   }
   // Is the bank configuration hotspot being accessed?
   else if((addr & 0x1FFF) == 0x1FF8)
   {
     // Yes, so handle bank configuration
     myWritePending = false;
+    trapAccesses(false);
     bankConfiguration(myDataHoldRegister);
   }
   // Handle poke if writing enabled
   else if(myWriteEnabled && myWritePending && 
-      (my6502->distinctAccesses() == (myNumberOfDistinctAccesses + 5)))
+      (myNumberOfDistinctAccesses == 5))
   {
     if((addr & 0x0800) == 0)
     {
@@ -170,41 +199,56 @@ uInt8 CartridgeAR::peek(uInt16 addr)
       mySystem->setDirtyPage(addr);
     }
     myWritePending = false;
+    trapAccesses(false);
   }
 
   return myImage[(addr & 0x07FF) + myImageOffset[(addr & 0x0800) ? 1 : 0]];
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-bool CartridgeAR::poke(uInt16 addr, uInt8)
+bool CartridgeAR::poke(uInt16 addr, uInt8 value)
 {
-  bool modified = false;
-
-  // Cancel any pending write if more than 5 distinct accesses have occurred
-  // TODO: Modify to handle when the distinct counter wraps around...
-  if(myWritePending && 
-      (my6502->distinctAccesses() > myNumberOfDistinctAccesses + 5))
+  // Accesses to the rest of the system only come here while they're
+  // being counted (see trapAccesses)
+  if(!(addr & 0x1000))
   {
-    myWritePending = false;
+    if(!bankLocked())
+      countAccess(addr);
+
+    const System::PageAccess& access =
+      mySystemPages[(addr & 0x0FFF) >> mySystem->pageShift()];
+    if(access.directPokeBase)
+    {
+      *(access.directPokeBase + (addr & mySystem->pageMask())) = value;
+      return true;
+    }
+    else
+      return access.device->poke(addr, value);
   }
 
+  bool modified = false;
+
+  countAccess(addr);
+
   // Is the data hold register being set?
   if(!(addr & 0x0F00) && (!myWriteEnabled || !myWritePending))
   {
     myDataHoldRegister = addr;
-    myNumberOfDistinctAccesses = my6502->distinctAccesses();
+    myNumberOfDistinctAccesses = 0;
     myWritePending = true;
+    trapAccesses(myWriteEnabled);
   }
   // Is the bank configuration hotspot being accessed?
   else if((addr & 0x1FFF) == 0x1FF8)
   {
     // Yes, so handle bank configuration
     myWritePending = false;
+    trapAccesses(false);
     bankConfiguration(myDataHoldRegister);
   }
   // Handle poke if writing enabled
   else if(myWriteEnabled && myWritePending && 
-      (my6502->distinctAccesses() == (myNumberOfDistinctAccesses + 5)))
+      (myNumberOfDistinctAccesses == 5))
   {
     if((addr & 0x0800) == 0)
     {
@@ -217,14 +261,64 @@ bool CartridgeAR::poke(uInt16 addr, uInt8)
       modified = true;
     }
     myWritePending = false;
+    trapAccesses(false);
   }
 
   return modified;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeAR::countAccess(uInt16 address)
+{
+  if(address != myLastAccessAddress)
+  {
+    myNumberOfDistinctAccesses++;
+    myLastAccessAddress = address;
+
+    // Cancel any pending write if more than 5 distinct accesses have occurred
+    if(myWritePending && myNumberOfDistinctAccesses > 5)
+    {
+      myWritePending = false;
+      trapAccesses(false);
+    }
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeAR::trapAccesses(bool enable)
+{
+  if(enable == myAccessesTrapped)
+    return;
+
+  uInt16 shift = mySystem->pageShift();
+  uInt16 pages = 0x1000 >> shift;
+
+  if(enable)
+  {
+    // Route all accesses below the cart through our peek/poke methods
+    for(uInt16 page = 0; page < pages; ++page)
+    {
+      mySystemPages[page] = mySystem->getPageAccess(page);
+
+      System::PageAccess access = mySystemPages[page];
+      access.directPeekBase = access.directPokeBase = 0;
+      access.device = this;
+      mySystem->setPageAccess(page, access);
+    }
+  }
+  else
+    mySystem->setPageAccess(0, mySystemPages, pages);
+
+  myAccessesTrapped = enable;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt8 CartridgeAR::getAccessFlags(uInt16 address)
 {
+  if(!(address & 0x1000))
+    return mySystemPages[(address & 0x0FFF) >> mySystem->pageShift()].
+             device->getAccessFlags(address);
+
   return myCodeAccessBase[(address & 0x07FF) +
            myImageOffset[(address & 0x0800) ? 1 : 0]];
 }
@@ -232,6 +326,13 @@ uInt8 CartridgeAR::getAccessFlags(uInt16 address)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeAR::setAccessFlags(uInt16 address, uInt8 flags)
 {
+  if(!(address & 0x1000))
+  {
+    mySystemPages[(address & 0x0FFF) >> mySystem->pageShift()].
+      device->setAccessFlags(address, flags);
+    return;
+  }
+
   myCodeAccessBase[(address & 0x07FF) +
     myImageOffset[(address & 0x0800) ? 1 : 0]] |= flags;
 }
@@ -343,6 +444,10 @@ void CartridgeAR::initializeROM()
   //   0x00 -> show SC BIOS progress bars as normal
   ourDummyROMCode[109] = mySettings.getBool("fastscbios") ? 0xFF : 0x00;
 
+  // In fast-load mode, the emulator does all the work of the BIOS once
+  // a load has been read, instead of running the rest of its code
+  myFastLoad = mySettings.getBool("fastscload");
+
   // The accumulator should contain a random value after exiting the
   // SC BIOS code - a value placed in offset 281 will be stored in A
   ourDummyROMCode[281] = mySystem->randGenerator().next();
@@ -372,7 +477,7 @@ uInt8 CartridgeAR::checksum(uInt8* s, uInt16 length)
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-void CartridgeAR::loadIntoRAM(uInt8 load)
+bool CartridgeAR::loadIntoRAM(uInt8 load)
 {
   uInt16 image;
 
@@ -420,13 +525,59 @@ void CartridgeAR::loadIntoRAM(uInt8 load)
       mySystem->poke(0x80, myHeader[2]);
 
       myBankChanged = true;
-      return;
+      return true;
     }
   }
 
   // TODO: Should probably switch to an internal ROM routine to display
   // this message to the user...
   cerr << "ERROR: Supercharger load is missing from ROM image...\n";
+  return false;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt8 CartridgeAR::startLoad()
+{
+  // None of the following are accesses by the CPU
+  myWritePending = false;
+  trapAccesses(false);
+
+  // Copy the code to do the bank switching into page zero
+  // (CMP $FFF8 / JMP $????, with the address already placed at $FE/$FF)
+  mySystem->poke(0xfa, 0xcd);
+  mySystem->poke(0xfb, 0xf8);
+  mySystem->poke(0xfc, 0xff);
+  mySystem->poke(0xfd, 0x4c);
+
+  // Clear some of the 2600's RAM and TIA registers like the real SC BIOS does
+  for(uInt16 addr = 0x2c; addr >= 0x04; --addr)
+    mySystem->poke(addr, 0);
+  for(uInt16 addr = 0x9d; addr >= 0x81; --addr)
+    mySystem->poke(addr, 0);
+
+  // Setup the bank configuration from the load's header (the BIOS does
+  // this with a CMP $F000,X followed by the CMP $FFF8 above)
+  myDataHoldRegister = myHeader[2];
+  bankConfiguration(myDataHoldRegister);
+
+  // Initialize A, X, Y, and SP registers, with the flags as they'd be
+  // after the CMP $FFF8
+  uInt8 value = myImage[0x07F8 + myImageOffset[1]];
+  my6502->A = myImage[(3 << 11) + 281];  // This cart's own random value
+  my6502->X = 0xff;
+  my6502->Y = 0x00;
+  my6502->SP = 0xff;
+  my6502->N = (my6502->A - value) & 0x80;
+  my6502->notZ = my6502->A != value;
+  my6502->C = my6502->A >= value;
+
+  // Finally, continue from the load's entry point, as if its first
+  // opcode was the one just fetched (through the system, since the entry
+  // point isn't necessarily in the cart's address space)
+  uInt16 entry = myHeader[0] | (myHeader[1] << 8);
+  my6502->PC = entry + 1;
+
+  return mySystem->peek(entry);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -499,11 +650,17 @@ bool CartridgeAR::save(Serializer& out) const
     // Data hold register used for writing
     out.putByte(myDataHoldRegister);
 
-    // Indicates number of distinct accesses when data hold register was set
+    // Indicates number of distinct accesses since data hold register was set
     out.putInt(myNumberOfDistinctAccesses);
 
+    // The address of the last access counted as a distinct access
+    out.putShort(myLastAccessAddress);
+
     // Indicates if a write is pending or not
     out.putBool(myWritePending);
+
+    // Indicates if loads jump straight into their entry point
+    out.putBool(myFastLoad);
   }
   catch(...)
   {
@@ -550,11 +707,17 @@ bool CartridgeAR::load(Serializer& in)
     // Data hold register used for writing
     myDataHoldRegister = in.getByte();
 
-    // Indicates number of distinct accesses when data hold register was set
+    // Indicates number of distinct accesses since data hold register was set
     myNumberOfDistinctAccesses = in.getInt();
 
+    // The address of the last access counted as a distinct access
+    myLastAccessAddress = in.getShort();
+
     // Indicates if a write is pending or not
     myWritePending = in.getBool();
+
+    // Indicates if loads jump straight into their entry point
+    myFastLoad = in.getBool();
   }
   catch(...)
   {
@@ -562,6 +725,9 @@ bool CartridgeAR::load(Serializer& in)
     return false;
   }
 
+  // Resume counting the CPU's accesses if a write is pending
+  trapAccesses(myWritePending && myWriteEnabled);
+
   return true;
 }
 
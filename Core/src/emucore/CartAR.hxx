@@ -183,12 +183,25 @@ class CartridgeAR : public Cartridge
     // Compute the sum of the array of bytes
     uInt8 checksum(uInt8* s, uInt16 length);
 
-    // Load the specified load into SC RAM
-    void loadIntoRAM(uInt8 load);
+    // Load the specified load into SC RAM (returns false if it doesn't exist)
+    bool loadIntoRAM(uInt8 load);
 
     // Sets up a "dummy" BIOS ROM in the ROM bank of the cartridge
     void initializeROM();
 
+    // Does the work of the "dummy" BIOS after a load has been read, and
+    // returns the first opcode at the load's entry point (fast-load mode)
+    uInt8 startLoad();
+
+    // Start/stop routing accesses to the rest of the system through this
+    // cart, so that the CPU's distinct accesses can be counted while a
+    // write is pending
+    void trapAccesses(bool enable);
+
+    // Count an access to the given address by the CPU, cancelling any
+    // pending write if more than 5 distinct accesses have occurred
+    void countAccess(uInt16 address);
+
   private:
     // Pointer to the 6502 processor in the system
     M6502* my6502;
@@ -223,9 +236,23 @@ class CartridgeAR : public Cartridge
     // Data hold register used for writing
     uInt8 myDataHoldRegister;
 
-    // Indicates number of distinct accesses when data hold register was set
+    // Indicates number of distinct accesses since data hold register was set
     uInt32 myNumberOfDistinctAccesses;
 
+    // The address of the last access counted as a distinct access
+    uInt16 myLastAccessAddress;
+
+    // Indicates if accesses to the rest of the system are being counted
+    bool myAccessesTrapped;
+
+    // The page accessing methods of the rest of the system (below 0x1000),
+    // saved while its accesses are routed through this cart
+    System::PageAccess* mySystemPages;
+
+    // Indicates if loads jump straight into their entry point, bypassing
+    // the "dummy" BIOS
+    bool myFastLoad;
+
     // Indicates if a write is pending or not
     bool myWritePending;
 
@@ -0,0 +1,433 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2014 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//
+// $Id$
+//============================================================================
+
+#ifndef CARTRIDGEBANKED_HXX
+#define CARTRIDGEBANKED_HXX
+
+#include <cassert>
+#include <cstring>
+
+#include "bspf.hxx"
+#include "Cart.hxx"
+#include "System.hxx"
+#include "Serializer.hxx"
+
+/**
+  Generic implementation of the simple 'hotspot' bankswitching schemes
+  (F8, F6, F4, EF, DF, BF, FA and their Superchip variants).  These
+  carts consist of a number of 4K banks, one of which is visible at a
+  time in the 4K cartridge space.  Accessing one of a range of consecutive
+  hotspots at the end of the cartridge space selects the corresponding
+  bank (the first hotspot selects bank 0, the next one bank 1, and so on).
+
+  Optionally, the cart contains extended RAM at the beginning of the
+  cartridge space; its write port is immediately followed by its read
+  port, each being 'RAMSIZE' bytes long.
+
+  A scheme is described entirely by the template parameters.  The page
+  accessing methods for every bank are computed once when the cart is
+  installed, so a bankswitch is a single block copy into the system.
+  Classes for the actual schemes derive from this one, providing only
+  their constructor (with the startup bank), name and debugger widget.
+
+  @param BANKS    The number of 4K banks
+  @param HOTSPOT  Address (& 0x0FFF) of the hotspot which selects bank 0
+  @param RAMSIZE  Size of the extended RAM in bytes (0 if there is none)
+
+  @version $Id$
+*/
+template<uInt16 BANKS, uInt16 HOTSPOT, uInt16 RAMSIZE>
+class CartridgeBanked : public Cartridge
+{
+  public:
+    /**
+      Create a new cartridge using the specified image
+
+      @param image     Pointer to the ROM image
+      @param size      The size of the ROM image
+      @param md5       MD5sum of the ROM image
+      @param settings  A reference to the various settings (read-only)
+    */
+    CartridgeBanked(const uInt8* image, uInt32 size, const string& md5,
+                    const Settings& settings);
+
+    /**
+      Destructor
+    */
+    virtual ~CartridgeBanked() { }
+
+  public:
+    /**
+      Reset device to its power-on state
+    */
+    void reset();
+
+    /**
+      Install cartridge in the specified system.  Invoked by the system
+      when the cartridge is attached to it.
+
+      @param system The system the device should install itself in
+    */
+    void install(System& system);
+
+    /**
+      Install pages for the specified bank in the system.
+
+      @param bank The bank that should be installed in the system
+    */
+    bool bank(uInt16 bank);
+
+    /**
+      Get the current bank.
+    */
+    uInt16 bank() const { return myCurrentBank; }
+
+    /**
+      Query the number of banks supported by the cartridge.
+    */
+    uInt16 bankCount() const { return BANKS; }
+
+    /**
+      Patch the cartridge ROM.
+
+      @param address  The ROM address to patch
+      @param value    The value to place into the address
+      @return    Success or failure of the patch operation
+    */
+    bool patch(uInt16 address, uInt8 value);
+
+    /**
+      Access the internal ROM image for this cartridge.
+
+      @param size  Set to the size of the internal ROM image data
+      @return  A pointer to the internal ROM image data
+    */
+    const uInt8* getImage(int& size) const;
+
+    /**
+      Save the current state of this cart to the given Serializer.
+
+      @param out  The Serializer object to use
+      @return  False on any errors, else true
+    */
+    bool save(Serializer& out) const;
+
+    /**
+      Load the current state of this cart from the given Serializer.
+
+      @param in  The Serializer object to use
+      @return  False on any errors, else true
+    */
+    bool load(Serializer& in);
+
+    /**
+      Copy the current state of this cart to/from the given snapshot.
+    */
+    bool saveSnapshot(Snapshot& s) const;
+    void loadSnapshot(const Snapshot& s);
+
+  public:
+    /**
+      Get the byte at the specified address.
+
+      @return The byte at the specified address
+    */
+    uInt8 peek(uInt16 address);
+
+    /**
+      Change the byte at the specified address to the given value
+
+      @param address The address where the value should be stored
+      @param value The value to be stored at the address
+      @return  True if the poke changed the device address space, else false
+    */
+    bool poke(uInt16 address, uInt8 value);
+
+  private:
+    /**
+      Switch banks if the given address is one of the hotspots.
+    */
+    void checkSwitchBank(uInt16 address)
+    {
+      // Since both bounds are constants, this is a single compare
+      if(uInt16(address - HOTSPOT) < BANKS)
+        bank(address - HOTSPOT);
+    }
+
+    // First address of the cartridge space switched by the banks
+    // (the space below it is taken by the RAM ports)
+    enum { BANK_START = 0x1000 + 2 * RAMSIZE };
+
+  protected:
+    // Indicates which bank is currently active
+    uInt16 myCurrentBank;
+
+    // The ROM image of the cartridge (possibly shared)
+    uInt8* myImage;
+
+    // The extended RAM (unused if RAMSIZE is 0)
+    uInt8 myRAM[RAMSIZE > 0 ? RAMSIZE : 1];
+};
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<uInt16 BANKS, uInt16 HOTSPOT, uInt16 RAMSIZE>
+CartridgeBanked<BANKS, HOTSPOT, RAMSIZE>::CartridgeBanked(
+    const uInt8* image, uInt32 size, const string& md5,
+    const Settings& settings)
+  : Cartridge(settings),
+    myCurrentBank(0)
+{
+  // Get the (possibly shared) ROM image
+  myImage = shareImage(image, size, md5, BANKS * 4096);
+  createCodeAccessBase(BANKS * 4096);
+
+  // The RAM write port is followed by the read port @ 0x1000
+  if(RAMSIZE > 0)
+    registerRamArea(0x1000, RAMSIZE, RAMSIZE, 0x00);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<uInt16 BANKS, uInt16 HOTSPOT, uInt16 RAMSIZE>
+void CartridgeBanked<BANKS, HOTSPOT, RAMSIZE>::reset()
+{
+  // Initialize RAM
+  if(RAMSIZE > 0)
+  {
+    if(mySettings.getBool("ramrandom"))
+      for(uInt32 i = 0; i < RAMSIZE; ++i)
+        myRAM[i] = mySystem->randGenerator().next();
+    else
+      memset(myRAM, 0, RAMSIZE);
+  }
+
+  // Upon reset we switch to the startup bank
+  bank(myStartBank);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<uInt16 BANKS, uInt16 HOTSPOT, uInt16 RAMSIZE>
+void CartridgeBanked<BANKS, HOTSPOT, RAMSIZE>::install(System& system)
+{
+  mySystem = &system;
+  uInt16 shift = mySystem->pageShift();
+  uInt16 mask = mySystem->pageMask();
+
+  // Make sure the system we're being installed in has a page size that'll work
+  assert((((0x1000 + RAMSIZE) & mask) == 0) && ((BANK_START & mask) == 0));
+
+  System::PageAccess access(0, 0, 0, this, System::PA_READ);
+
+  if(RAMSIZE > 0)
+  {
+    // Set the page accessing method for the RAM writing pages
+    access.type = System::PA_WRITE;
+    for(uInt32 j = 0x1000; j < 0x1000U + RAMSIZE; j += (1 << shift))
+    {
+      access.directPokeBase = &myRAM[j & (RAMSIZE - 1)];
+      access.codeAccessBase = &myCodeAccessBase[j & (RAMSIZE - 1)];
+      mySystem->setPageAccess(j >> shift, access);
+    }
+
+    // Set the page accessing method for the RAM reading pages
+    access.directPokeBase = 0;
+    access.type = System::PA_READ;
+    for(uInt32 k = 0x1000U + RAMSIZE; k < BANK_START; k += (1 << shift))
+    {
+      access.directPeekBase = &myRAM[k & (RAMSIZE - 1)];
+      access.codeAccessBase = &myCodeAccessBase[RAMSIZE + (k & (RAMSIZE - 1))];
+      mySystem->setPageAccess(k >> shift, access);
+    }
+  }
+
+  // Precompute the page access methods for each bank, so that switching
+  // banks is just a matter of copying them into the system
+  uInt16 pages = (0x2000 - BANK_START) >> shift;
+  createBankPages(BANKS * pages);
+
+  access.directPeekBase = access.directPokeBase = 0;
+  access.type = System::PA_READ;
+  for(uInt32 b = 0; b < BANKS; ++b)
+  {
+    uInt32 offset = b << 12;
+    for(uInt32 address = BANK_START; address < 0x2000; address += (1 << shift))
+    {
+      // The hot spots must not be directly accessed
+      access.directPeekBase = address < ((0x1000U + HOTSPOT) & ~mask) ?
+          &myImage[offset + (address & 0x0FFF)] : 0;
+      access.codeAccessBase = &myCodeAccessBase[offset + (address & 0x0FFF)];
+      myBankPages[b * pages + ((address - BANK_START) >> shift)] = access;
+    }
+  }
+
+  // Install pages for the startup bank
+  bank(myStartBank);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<uInt16 BANKS, uInt16 HOTSPOT, uInt16 RAMSIZE>
+uInt8 CartridgeBanked<BANKS, HOTSPOT, RAMSIZE>::peek(uInt16 address)
+{
+  uInt16 peekAddress = address;
+  address &= 0x0FFF;
+
+  // Switch banks if necessary
+  checkSwitchBank(address);
+
+  if(RAMSIZE > 0 && address < RAMSIZE)
+  {
+    // Reading from the write port triggers an unwanted write
+    uInt8 value = mySystem->getDataBusState(0xFF);
+
+    if(bankLocked())
+      return value;
+    else
+    {
+      triggerReadFromWritePort(peekAddress);
+      return myRAM[address] = value;
+    }
+  }
+  else
+    return myImage[(myCurrentBank << 12) + address];
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<uInt16 BANKS, uInt16 HOTSPOT, uInt16 RAMSIZE>
+bool CartridgeBanked<BANKS, HOTSPOT, RAMSIZE>::poke(uInt16 address, uInt8)
+{
+  // Switch banks if necessary
+  checkSwitchBank(address & 0x0FFF);
+
+  // NOTE: This does not handle accessing RAM, however, this function
+  // should never be called for RAM because of the way page accessing
+  // has been setup
+  return false;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<uInt16 BANKS, uInt16 HOTSPOT, uInt16 RAMSIZE>
+bool CartridgeBanked<BANKS, HOTSPOT, RAMSIZE>::bank(uInt16 bank)
+{
+  if(bankLocked()) return false;
+
+  // Remember what bank we're in
+  myCurrentBank = bank;
+  uInt16 shift = mySystem->pageShift();
+  uInt16 pages = (0x2000 - BANK_START) >> shift;
+
+  // Install the precomputed page access methods for the current bank
+  mySystem->setPageAccess(BANK_START >> shift, &myBankPages[bank * pages], pages);
+
+  return myBankChanged = true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<uInt16 BANKS, uInt16 HOTSPOT, uInt16 RAMSIZE>
+bool CartridgeBanked<BANKS, HOTSPOT, RAMSIZE>::patch(uInt16 address, uInt8 value)
+{
+  unshareImage(myImage);
+
+  address &= 0x0FFF;
+
+  if(RAMSIZE > 0 && address < 2 * RAMSIZE)
+  {
+    // Normally, a write to the read port won't do anything
+    // However, the patch command is special in that ignores such
+    // cart restrictions
+    myRAM[address & (RAMSIZE - 1)] = value;
+  }
+  else
+    myImage[(myCurrentBank << 12) + address] = value;
+
+  return myBankChanged = true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<uInt16 BANKS, uInt16 HOTSPOT, uInt16 RAMSIZE>
+const uInt8* CartridgeBanked<BANKS, HOTSPOT, RAMSIZE>::getImage(int& size) const
+{
+  size = BANKS * 4096;
+  return myImage;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<uInt16 BANKS, uInt16 HOTSPOT, uInt16 RAMSIZE>
+bool CartridgeBanked<BANKS, HOTSPOT, RAMSIZE>::save(Serializer& out) const
+{
+  try
+  {
+    out.putString(name());
+    out.putShort(myCurrentBank);
+    if(RAMSIZE > 0)
+      out.putByteArray(myRAM, RAMSIZE);
+  }
+  catch(...)
+  {
+    cerr << "ERROR: " << name() << "::save" << endl;
+    return false;
+  }
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<uInt16 BANKS, uInt16 HOTSPOT, uInt16 RAMSIZE>
+bool CartridgeBanked<BANKS, HOTSPOT, RAMSIZE>::load(Serializer& in)
+{
+  try
+  {
+    if(in.getString() != name())
+      return false;
+
+    myCurrentBank = in.getShort();
+    if(RAMSIZE > 0)
+      in.getByteArray(myRAM, RAMSIZE);
+  }
+  catch(...)
+  {
+    cerr << "ERROR: " << name() << "::load" << endl;
+    return false;
+  }
+
+  // Remember what bank we were in
+  bank(myCurrentBank);
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<uInt16 BANKS, uInt16 HOTSPOT, uInt16 RAMSIZE>
+bool CartridgeBanked<BANKS, HOTSPOT, RAMSIZE>::saveSnapshot(Snapshot& s) const
+{
+  s.bank[0] = myCurrentBank;
+  if(RAMSIZE > 0)
+    memcpy(s.RAM, myRAM, RAMSIZE);
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+template<uInt16 BANKS, uInt16 HOTSPOT, uInt16 RAMSIZE>
+void CartridgeBanked<BANKS, HOTSPOT, RAMSIZE>::loadSnapshot(const Snapshot& s)
+{
+  if(RAMSIZE > 0)
+    memcpy(myRAM, s.RAM, RAMSIZE);
+  bank(s.bank[0]);
+}
+
+#endif
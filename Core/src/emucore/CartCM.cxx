@@ -26,7 +26,8 @@
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 CartridgeCM::CartridgeCM(const uInt8* image, uInt32 size, const Settings& settings)
-  : Cartridge(settings)
+  : Cartridge(settings),
+    myRAM(2048)
 {
   // Copy the ROM image into my buffer
   memcpy(myImage, image, BSPF_min(16384u, size));
@@ -55,7 +56,8 @@ void CartridgeCM::reset()
     for(uInt32 i = 0; i < 2048; ++i)
       myRAM[i] = mySystem->randGenerator().next();
   else
-    memset(myRAM, 0, 2048);
+    memset(myRAM.data(), 0, 2048);
+  myRAM.touchAll();
 
   // Upon reset we switch to the startup bank
   bank(myStartBank);
@@ -112,6 +114,9 @@ bool CartridgeCM::bank(uInt16 bank)
 {
   if(bankLocked()) return false;
 
+  // Writes to the RAM must be seen by the snapshots before it's unmapped
+  touchMappedRAM();
+
   // Remember what bank we're in
   myCurrentBank = bank;
   uInt16 offset = myCurrentBank << 12;
@@ -182,7 +187,7 @@ uInt16 CartridgeCM::bankCount() const
 bool CartridgeCM::patch(uInt16 address, uInt8 value)
 {
   if((mySWCHA & 0x30) == 0x20)
-    myRAM[address & 0x7FF] = value;
+    myRAM.poke(address & 0x7FF, value);
   else
     myImage[(myCurrentBank << 12) + address] = value;
 
@@ -205,7 +210,7 @@ bool CartridgeCM::save(Serializer& out) const
     out.putShort(myCurrentBank);
     out.putByte(mySWCHA);
     out.putByte(myColumn);
-    out.putByteArray(myRAM, 2048);
+    out.putByteArray(myRAM.data(), 2048);
   }
   catch(...)
   {
@@ -227,7 +232,8 @@ bool CartridgeCM::load(Serializer& in)
     myCurrentBank = in.getShort();
     mySWCHA = in.getByte();
     myColumn = in.getByte();
-    in.getByteArray(myRAM, 2048);
+    in.getByteArray(myRAM.data(), 2048);
+    myRAM.touchAll();
   }
   catch(...)
   {
@@ -240,3 +246,27 @@ bool CartridgeCM::load(Serializer& in)
 
   return true;
 }
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool CartridgeCM::saveSnapshot(Snapshot& s) const
+{
+  touchMappedRAM();
+
+  s.bank[0] = myCurrentBank;
+  s.registers[0] = mySWCHA;
+  s.registers[1] = myColumn;
+  myRAM.save(s.pages);
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeCM::loadSnapshot(const Snapshot& s)
+{
+  touchMappedRAM();
+  myRAM.load(s.pages);
+
+  mySWCHA = s.registers[0];
+  myColumn = s.registers[1];
+  bank(s.bank[0]);
+}
@@ -189,6 +189,12 @@ class CartridgeCM : public Cartridge
     */
     bool load(Serializer& in);
 
+    /**
+      Copy the current state of this cart to/from the given snapshot.
+    */
+    bool saveSnapshot(Snapshot& s) const;
+    void loadSnapshot(const Snapshot& s);
+
     /**
       Get a descriptor for the device name (used in error checking).
 
@@ -232,6 +238,14 @@ class CartridgeCM : public Cartridge
     */
     uInt8 column() const { return myColumn; }
 
+  private:
+    // Collect the writes to the RAM, which is always mapped at 0x1800
+    // when it's writable
+    void touchMappedRAM() const
+    {
+      myRAM.touchMapped(*mySystem, 0x1800, 0, 2048);
+    }
+
   private:
     // Indicates which bank is currently active
     uInt16 myCurrentBank;
@@ -240,7 +254,7 @@ class CartridgeCM : public Cartridge
     uInt8 myImage[16384];
 
     // The 2K of RAM
-    uInt8 myRAM[2048];
+    CartRAM myRAM;
 
     // Current copy of SWCHA (controls ROM/RAM accesses)
     uInt8 mySWCHA;
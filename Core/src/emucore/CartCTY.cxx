@@ -318,7 +318,7 @@ bool CartridgeCTY::save(Serializer& out) const
     out.putBool(myLDAimmediate);
     out.putInt(myRandomNumber);
     out.putInt(mySystemCycles);
-    out.putInt((uInt32)(myFractionalClocks * 100000000.0));
+    out.putInt((uInt32)(myFractionalClocks * 100000000.0 + 0.5));
 
   }
   catch(...)
@@ -233,3 +233,17 @@ bool CartridgeCV::load(Serializer& in)
 
   return true;
 }
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool CartridgeCV::saveSnapshot(Snapshot& s) const
+{
+  memcpy(s.RAM, myRAM, 1024);
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeCV::loadSnapshot(const Snapshot& s)
+{
+  memcpy(myRAM, s.RAM, 1024);
+}
@@ -20,10 +20,8 @@
 #ifndef CARTRIDGEDFSC_HXX
 #define CARTRIDGEDFSC_HXX
 
-class System;
-
 #include "bspf.hxx"
-#include "Cart.hxx"
+#include "CartBanked.hxx"
 #ifdef DEBUGGER_SUPPORT
   #include "CartDFSCWidget.hxx"
 #endif
@@ -35,7 +33,7 @@ class System;
   @author  Stephen Anthony
   @version $Id: CartDFSC.hxx 2838 2014-01-17 23:34:03Z stephena $
 */
-class CartridgeDFSC : public Cartridge
+class CartridgeDFSC : public CartridgeBanked<32, 0x0FC0, 128>
 {
   friend class CartridgeDFSCWidget;
 
@@ -45,9 +43,11 @@ class CartridgeDFSC : public Cartridge
 
       @param image     Pointer to the ROM image
       @param size      The size of the ROM image
+      @param md5       MD5sum of the ROM image
       @param settings  A reference to the various settings (read-only)
     */
-    CartridgeDFSC(const uInt8* image, uInt32 size, const Settings& settings);
+    CartridgeDFSC(const uInt8* image, uInt32 size, const string& md5,
+                  const Settings& settings);
 
     /**
       Destructor
@@ -55,69 +55,6 @@ class CartridgeDFSC : public Cartridge
     virtual ~CartridgeDFSC();
 
   public:
-    /**
-      Reset device to its power-on state
-    */
-    void reset();
-
-    /**
-      Install cartridge in the specified system.  Invoked by the system
-      when the cartridge is attached to it.
-
-      @param system The system the device should install itself in
-    */
-    void install(System& system);
-
-    /**
-      Install pages for the specified bank in the system.
-
-      @param bank The bank that should be installed in the system
-    */
-    bool bank(uInt16 bank);
-
-    /**
-      Get the current bank.
-    */
-    uInt16 bank() const;
-
-    /**
-      Query the number of banks supported by the cartridge.
-    */
-    uInt16 bankCount() const;
-
-    /**
-      Patch the cartridge ROM.
-
-      @param address  The ROM address to patch
-      @param value    The value to place into the address
-      @return    Success or failure of the patch operation
-    */
-    bool patch(uInt16 address, uInt8 value);
-
-    /**
-      Access the internal ROM image for this cartridge.
-
-      @param size  Set to the size of the internal ROM image data
-      @return  A pointer to the internal ROM image data
-    */
-    const uInt8* getImage(int& size) const;
-
-    /**
-      Save the current state of this cart to the given Serializer.
-
-      @param out  The Serializer object to use
-      @return  False on any errors, else true
-    */
-    bool save(Serializer& out) const;
-
-    /**
-      Load the current state of this cart from the given Serializer.
-
-      @param in  The Serializer object to use
-      @return  False on any errors, else true
-    */
-    bool load(Serializer& in);
-
     /**
       Get a descriptor for the device name (used in error checking).
 
@@ -136,33 +73,6 @@ class CartridgeDFSC : public Cartridge
       return new CartridgeDFSCWidget(boss, lfont, nfont, x, y, w, h, *this);
     }
   #endif
-
-  public:
-    /**
-      Get the byte at the specified address.
-
-      @return The byte at the specified address
-    */
-    uInt8 peek(uInt16 address);
-
-    /**
-      Change the byte at the specified address to the given value
-
-      @param address The address where the value should be stored
-      @param value The value to be stored at the address
-      @return  True if the poke changed the device address space, else false
-    */
-    bool poke(uInt16 address, uInt8 value);
-
-  private:
-    // Indicates which bank is currently active
-    uInt16 myCurrentBank;
-
-    // The 64K ROM image of the cartridge
-    uInt8 myImage[131072];
-
-    // The 128 bytes of RAM
-    uInt8 myRAM[128];
 };
 
 #endif
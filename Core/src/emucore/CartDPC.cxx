@@ -502,7 +502,7 @@ bool CartridgeDPC::save(Serializer& out) const
     out.putByte(myRandomNumber);
 
     out.putInt(mySystemCycles);
-    out.putInt((uInt32)(myFractionalClocks * 100000000.0));
+    out.putInt((uInt32)(myFractionalClocks * 100000000.0 + 0.5));
   }
   catch(...)
   {
@@ -702,8 +702,9 @@ bool CartridgeDPCPlus::save(Serializer& out) const
     // The random number generator register
     out.putInt(myRandomNumber);
 
+    // Rounded, so that saving again after a load writes the same value
     out.putInt(mySystemCycles);
-    out.putInt((uInt32)(myFractionalClocks * 100000000.0));
+    out.putInt((uInt32)(myFractionalClocks * 100000000.0 + 0.5));
   }
   catch(...)
   {
@@ -777,3 +778,76 @@ bool CartridgeDPCPlus::load(Serializer& in)
 
   return true;
 }
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// Copy a member to or from the raw state of a snapshot, moving past it
+#define STORE(member) \
+  memcpy(out, &member, sizeof(member));  out += sizeof(member);
+#define FETCH(member) \
+  memcpy(&member, in, sizeof(member));  in += sizeof(member);
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool CartridgeDPCPlus::saveSnapshot(Snapshot& s) const
+{
+  // Unlike save(), the fractional clocks are kept exactly (so that the
+  // music fetchers go on as if the snapshot was never taken)
+  static const uInt32 size = sizeof(myDPCRAM) + sizeof(myTops) +
+    sizeof(myBottoms) + sizeof(myCounters) + sizeof(myFractionalCounters) +
+    sizeof(myFractionalIncrements) + sizeof(myFastFetch) +
+    sizeof(myLDAimmediate) + sizeof(myParameter) +
+    sizeof(myParameterPointer) + sizeof(myMusicCounters) +
+    sizeof(myMusicFrequencies) + sizeof(myMusicWaveforms) +
+    sizeof(myRandomNumber) + sizeof(mySystemCycles) +
+    sizeof(myFractionalClocks);
+
+  s.bank[0] = myCurrentBank;
+  s.state.resize(size);
+
+  uInt8* out = &s.state[0];
+  STORE(myDPCRAM);
+  STORE(myTops);
+  STORE(myBottoms);
+  STORE(myCounters);
+  STORE(myFractionalCounters);
+  STORE(myFractionalIncrements);
+  STORE(myFastFetch);
+  STORE(myLDAimmediate);
+  STORE(myParameter);
+  STORE(myParameterPointer);
+  STORE(myMusicCounters);
+  STORE(myMusicFrequencies);
+  STORE(myMusicWaveforms);
+  STORE(myRandomNumber);
+  STORE(mySystemCycles);
+  STORE(myFractionalClocks);
+  assert(out == &s.state[0] + size);
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeDPCPlus::loadSnapshot(const Snapshot& s)
+{
+  const uInt8* in = &s.state[0];
+  FETCH(myDPCRAM);
+  FETCH(myTops);
+  FETCH(myBottoms);
+  FETCH(myCounters);
+  FETCH(myFractionalCounters);
+  FETCH(myFractionalIncrements);
+  FETCH(myFastFetch);
+  FETCH(myLDAimmediate);
+  FETCH(myParameter);
+  FETCH(myParameterPointer);
+  FETCH(myMusicCounters);
+  FETCH(myMusicFrequencies);
+  FETCH(myMusicWaveforms);
+  FETCH(myRandomNumber);
+  FETCH(mySystemCycles);
+  FETCH(myFractionalClocks);
+
+  bank(s.bank[0]);
+}
+
+#undef STORE
+#undef FETCH
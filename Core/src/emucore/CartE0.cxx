@@ -24,11 +24,12 @@
 #include "CartE0.hxx"
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-CartridgeE0::CartridgeE0(const uInt8* image, uInt32 size, const Settings& settings)
+CartridgeE0::CartridgeE0(const uInt8* image, uInt32 size, const string& md5,
+                         const Settings& settings)
   : Cartridge(settings)
 {
-  // Copy the ROM image into my buffer
-  memcpy(myImage, image, BSPF_min(8192u, size));
+  // Get the (possibly shared) ROM image
+  myImage = shareImage(image, size, md5, 8192);
   createCodeAccessBase(8192);
 }
 
@@ -77,6 +78,19 @@ void CartridgeE0::install(System& system)
   for(uInt32 j = (0x1FE0 & ~mask); j < 0x2000; j += (1 << shift))
     mySystem->setPageAccess(j >> shift, access);
 
+  // Precompute the page access methods for each of the 1K slices; these
+  // are the same regardless of which segment the slice is mapped into
+  uInt16 pages = 0x0400 >> shift;
+  createBankPages(8 * pages);
+
+  access.type = System::PA_READ;
+  for(uInt32 offset = 0; offset < 8192; offset += (1 << shift))
+  {
+    access.directPeekBase = &myImage[offset];
+    access.codeAccessBase = &myCodeAccessBase[offset];
+    myBankPages[offset >> shift] = access;
+  }
+
   // Install some default slices for the other segments
   segmentZero(4);
   segmentOne(5);
@@ -133,18 +147,12 @@ void CartridgeE0::segmentZero(uInt16 slice)
 
   // Remember the new slice
   myCurrentSlice[0] = slice;
-  uInt16 offset = slice << 10;
   uInt16 shift = mySystem->pageShift();
+  uInt16 pages = 0x0400 >> shift;
 
-  // Setup the page access methods for the current bank
-  System::PageAccess access(0, 0, 0, this, System::PA_READ);
+  // Install the precomputed page access methods for the slice
+  mySystem->setPageAccess(0x1000 >> shift, &myBankPages[slice * pages], pages);
 
-  for(uInt32 address = 0x1000; address < 0x1400; address += (1 << shift))
-  {
-    access.directPeekBase = &myImage[offset + (address & 0x03FF)];
-    access.codeAccessBase = &myCodeAccessBase[offset + (address & 0x03FF)];
-    mySystem->setPageAccess(address >> shift, access);
-  }
   myBankChanged = true;
 }
 
@@ -155,18 +163,12 @@ void CartridgeE0::segmentOne(uInt16 slice)
 
   // Remember the new slice
   myCurrentSlice[1] = slice;
-  uInt16 offset = slice << 10;
   uInt16 shift = mySystem->pageShift();
+  uInt16 pages = 0x0400 >> shift;
 
-  // Setup the page access methods for the current bank
-  System::PageAccess access(0, 0, 0, this, System::PA_READ);
+  // Install the precomputed page access methods for the slice
+  mySystem->setPageAccess(0x1400 >> shift, &myBankPages[slice * pages], pages);
 
-  for(uInt32 address = 0x1400; address < 0x1800; address += (1 << shift))
-  {
-    access.directPeekBase = &myImage[offset + (address & 0x03FF)];
-    access.codeAccessBase = &myCodeAccessBase[offset + (address & 0x03FF)];
-    mySystem->setPageAccess(address >> shift, access);
-  }
   myBankChanged = true;
 }
 
@@ -177,18 +179,12 @@ void CartridgeE0::segmentTwo(uInt16 slice)
 
   // Remember the new slice
   myCurrentSlice[2] = slice;
-  uInt16 offset = slice << 10;
   uInt16 shift = mySystem->pageShift();
+  uInt16 pages = 0x0400 >> shift;
 
-  // Setup the page access methods for the current bank
-  System::PageAccess access(0, 0, 0, this, System::PA_READ);
+  // Install the precomputed page access methods for the slice
+  mySystem->setPageAccess(0x1800 >> shift, &myBankPages[slice * pages], pages);
 
-  for(uInt32 address = 0x1800; address < 0x1C00; address += (1 << shift))
-  {
-    access.directPeekBase = &myImage[offset + (address & 0x03FF)];
-    access.codeAccessBase = &myCodeAccessBase[offset + (address & 0x03FF)];
-    mySystem->setPageAccess(address >> shift, access);
-  }
   myBankChanged = true;
 }
 
@@ -217,6 +213,8 @@ uInt16 CartridgeE0::bankCount() const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartridgeE0::patch(uInt16 address, uInt8 value)
 {
+  unshareImage(myImage);
+
   address &= 0x0FFF;
   myImage[(myCurrentSlice[address >> 10] << 10) + (address & 0x03FF)] = value;
   return true;
@@ -262,5 +260,27 @@ bool CartridgeE0::load(Serializer& in)
     return false;
   }
 
+  // Set up the previously used slices
+  segmentZero(myCurrentSlice[0]);
+  segmentOne(myCurrentSlice[1]);
+  segmentTwo(myCurrentSlice[2]);
+
   return true;
 }
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool CartridgeE0::saveSnapshot(Snapshot& s) const
+{
+  memcpy(s.bank, myCurrentSlice, sizeof(myCurrentSlice));
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeE0::loadSnapshot(const Snapshot& s)
+{
+  // The last segment is always the last slice
+  segmentZero(s.bank[0]);
+  segmentOne(s.bank[1]);
+  segmentTwo(s.bank[2]);
+}
@@ -54,9 +54,11 @@ class CartridgeE0 : public Cartridge
 
       @param image     Pointer to the ROM image
       @param size      The size of the ROM image
+      @param md5       MD5sum of the ROM image
       @param settings  A reference to the various settings (read-only)
     */
-    CartridgeE0(const uInt8* image, uInt32 size, const Settings& settings);
+    CartridgeE0(const uInt8* image, uInt32 size, const string& md5,
+                const Settings& settings);
  
     /**
       Destructor
@@ -127,6 +129,12 @@ class CartridgeE0 : public Cartridge
     */
     bool load(Serializer& in);
 
+    /**
+      Copy the current state of this cart to/from the given snapshot.
+    */
+    bool saveSnapshot(Snapshot& s) const;
+    void loadSnapshot(const Snapshot& s);
+
     /**
       Get a descriptor for the device name (used in error checking).
 
@@ -189,8 +197,8 @@ class CartridgeE0 : public Cartridge
     // Indicates the slice mapped into each of the four segments
     uInt16 myCurrentSlice[4];
 
-    // The 8K ROM image of the cartridge
-    uInt8 myImage[8192];
+    // The 8K ROM image of the cartridge (possibly shared)
+    uInt8* myImage;
 };
 
 #endif
@@ -24,11 +24,13 @@
 #include "CartE7.hxx"
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-CartridgeE7::CartridgeE7(const uInt8* image, uInt32 size, const Settings& settings)
-  : Cartridge(settings)
+CartridgeE7::CartridgeE7(const uInt8* image, uInt32 size, const string& md5,
+                         const Settings& settings)
+  : Cartridge(settings),
+    myRAMBankPages(0)
 {
-  // Copy the ROM image into my buffer
-  memcpy(myImage, image, BSPF_min(16384u, size));
+  // Get the (possibly shared) ROM image
+  myImage = shareImage(image, size, md5, 16384);
   createCodeAccessBase(16384 + 2048);
 
   // This cart can address a 1024 byte bank of RAM @ 0x1000
@@ -93,6 +95,64 @@ void CartridgeE7::install(System& system)
   }
   myCurrentSlice[1] = 7;
 
+  // Precompute the page access methods for each slice of the first
+  // segment, followed by those for each 256 byte bank of RAM
+  uInt16 pages = 0x0800 >> shift, ramPages = 0x0200 >> shift;
+  createBankPages(8 * pages + 4 * ramPages);
+  myRAMBankPages = myBankPages + 8 * pages;
+
+  // Slices 0 - 6 map ROM into the first segment
+  for(uInt32 offset = 0; offset < 7 * 2048; offset += (1 << shift))
+  {
+    access.directPeekBase = &myImage[offset];
+    access.codeAccessBase = &myCodeAccessBase[offset];
+    myBankPages[offset >> shift] = access;
+  }
+
+  // Slice 7 maps the 1K of RAM; first the writing pages, then the
+  // reading pages
+  System::PageAccess* slice = myBankPages + 7 * pages;
+  access.directPeekBase = 0;
+  access.type = System::PA_WRITE;
+  for(uInt32 j = 0x0000; j < 0x0400; j += (1 << shift))
+  {
+    access.directPokeBase = &myRAM[j];
+    access.codeAccessBase = &myCodeAccessBase[8192 + j];
+    slice[j >> shift] = access;
+  }
+  access.directPokeBase = 0;
+  access.type = System::PA_READ;
+  for(uInt32 k = 0x0400; k < 0x0800; k += (1 << shift))
+  {
+    access.directPeekBase = &myRAM[k & 0x03FF];
+    access.codeAccessBase = &myCodeAccessBase[8192 + (k & 0x03FF)];
+    slice[k >> shift] = access;
+  }
+
+  // Each bank of RAM has 256 bytes of writing pages, then 256 bytes of
+  // reading pages
+  for(uInt32 offset = 0; offset < 1024; offset += 256)
+  {
+    System::PageAccess* ram = myRAMBankPages + (offset >> 8) * ramPages;
+    access.directPeekBase = 0;
+    access.type = System::PA_WRITE;
+    for(uInt32 j = 0x0000; j < 0x0100; j += (1 << shift))
+    {
+      access.directPokeBase = &myRAM[1024 + offset + j];
+      access.codeAccessBase = &myCodeAccessBase[8192 + 1024 + offset + j];
+      ram[j >> shift] = access;
+    }
+    access.directPokeBase = 0;
+    access.type = System::PA_READ;
+    for(uInt32 k = 0x0100; k < 0x0200; k += (1 << shift))
+    {
+      access.directPeekBase = &myRAM[1024 + offset + (k & 0x00FF)];
+      access.codeAccessBase =
+          &myCodeAccessBase[8192 + 1024 + offset + (k & 0x00FF)];
+      ram[k >> shift] = access;
+    }
+  }
+
   // Install some default banks for the RAM and first segment
   bankRAM(0);
   bank(myStartBank);
@@ -172,29 +232,12 @@ void CartridgeE7::bankRAM(uInt16 bank)
 
   // Remember what bank we're in
   myCurrentRAM = bank;
-  uInt16 offset = bank << 8;
   uInt16 shift = mySystem->pageShift();
+  uInt16 pages = 0x0200 >> shift;
 
-  // Setup the page access methods for the current bank
-  System::PageAccess access(0, 0, 0, this, System::PA_WRITE);
+  // Install the precomputed page access methods for the RAM bank
+  mySystem->setPageAccess(0x1800 >> shift, &myRAMBankPages[bank * pages], pages);
 
-  // Set the page accessing method for the 256 bytes of RAM writing pages
-  for(uInt32 j = 0x1800; j < 0x1900; j += (1 << shift))
-  {
-    access.directPokeBase = &myRAM[1024 + offset + (j & 0x00FF)];
-    access.codeAccessBase = &myCodeAccessBase[8192 + 1024 + offset + (j & 0x00FF)];
-    mySystem->setPageAccess(j >> shift, access);
-  }
-
-  // Set the page accessing method for the 256 bytes of RAM reading pages
-  access.directPokeBase = 0;
-  access.type = System::PA_READ;
-  for(uInt32 k = 0x1900; k < 0x1A00; k += (1 << shift))
-  {
-    access.directPeekBase = &myRAM[1024 + offset + (k & 0x00FF)];
-    access.codeAccessBase = &myCodeAccessBase[8192 + 1024 + offset + (k & 0x00FF)];
-    mySystem->setPageAccess(k >> shift, access);
-  }
   myBankChanged = true;
 }
 
@@ -205,44 +248,12 @@ bool CartridgeE7::bank(uInt16 slice)
 
   // Remember what bank we're in
   myCurrentSlice[0] = slice;
-  uInt16 offset = slice << 11;
   uInt16 shift = mySystem->pageShift();
+  uInt16 pages = 0x0800 >> shift;
 
-  // Setup the page access methods for the current bank
-  if(slice != 7)
-  {
-    System::PageAccess access(0, 0, 0, this, System::PA_READ);
-
-    // Map ROM image into first segment
-    for(uInt32 address = 0x1000; address < 0x1800; address += (1 << shift))
-    {
-      access.directPeekBase = &myImage[offset + (address & 0x07FF)];
-      access.codeAccessBase = &myCodeAccessBase[offset + (address & 0x07FF)];
-      mySystem->setPageAccess(address >> shift, access);
-    }
-  }
-  else
-  {
-    System::PageAccess access(0, 0, 0, this, System::PA_WRITE);
-
-    // Set the page accessing method for the 1K slice of RAM writing pages
-    for(uInt32 j = 0x1000; j < 0x1400; j += (1 << shift))
-    {
-      access.directPokeBase = &myRAM[j & 0x03FF];
-      access.codeAccessBase = &myCodeAccessBase[8192 + (j & 0x03FF)];
-      mySystem->setPageAccess(j >> shift, access);
-    }
+  // Install the precomputed page access methods for the current slice
+  mySystem->setPageAccess(0x1000 >> shift, &myBankPages[slice * pages], pages);
 
-    // Set the page accessing method for the 1K slice of RAM reading pages
-    access.directPokeBase = 0;
-    access.type = System::PA_READ;
-    for(uInt32 k = 0x1400; k < 0x1800; k += (1 << shift))
-    {
-      access.directPeekBase = &myRAM[k & 0x03FF];
-      access.codeAccessBase = &myCodeAccessBase[8192 + (k & 0x03FF)];
-      mySystem->setPageAccess(k >> shift, access);
-    }
-  }
   return myBankChanged = true;
 }
 
@@ -261,6 +272,8 @@ uInt16 CartridgeE7::bankCount() const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartridgeE7::patch(uInt16 address, uInt8 value)
 {
+  unshareImage(myImage);
+
   address = address & 0x0FFF;
 
   if(address < 0x0800)
@@ -338,3 +351,22 @@ bool CartridgeE7::load(Serializer& in)
 
   return true;
 }
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool CartridgeE7::saveSnapshot(Snapshot& s) const
+{
+  s.bank[0] = myCurrentSlice[0];
+  s.bank[1] = myCurrentSlice[1];
+  s.bank[2] = myCurrentRAM;
+  memcpy(s.RAM, myRAM, 2048);
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeE7::loadSnapshot(const Snapshot& s)
+{
+  memcpy(myRAM, s.RAM, 2048);
+  bankRAM(s.bank[2]);
+  bank(s.bank[0]);
+}
@@ -71,9 +71,11 @@ class CartridgeE7 : public Cartridge
 
       @param image     Pointer to the ROM image
       @param size      The size of the ROM image
+      @param md5       MD5sum of the ROM image
       @param settings  A reference to the various settings (read-only)
     */
-    CartridgeE7(const uInt8* image, uInt32 size, const Settings& settings);
+    CartridgeE7(const uInt8* image, uInt32 size, const string& md5,
+                const Settings& settings);
  
     /**
       Destructor
@@ -144,6 +146,12 @@ class CartridgeE7 : public Cartridge
     */
     bool load(Serializer& in);
 
+    /**
+      Copy the current state of this cart to/from the given snapshot.
+    */
+    bool saveSnapshot(Snapshot& s) const;
+    void loadSnapshot(const Snapshot& s);
+
     /**
       Get a descriptor for the device name (used in error checking).
 
@@ -195,11 +203,15 @@ class CartridgeE7 : public Cartridge
     // Indicates which 256 byte bank of RAM is being used
     uInt16 myCurrentRAM;
 
-    // The 16K ROM image of the cartridge
-    uInt8 myImage[16384];
+    // The 16K ROM image of the cartridge (possibly shared)
+    uInt8* myImage;
 
     // The 2048 bytes of RAM
     uInt8 myRAM[2048];
+
+    // Precomputed page access methods for each 256 byte bank of RAM
+    // (stored after those for each slice of the first segment)
+    System::PageAccess* myRAMBankPages;
 };
 
 #endif
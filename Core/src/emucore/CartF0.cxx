@@ -24,11 +24,12 @@
 #include "CartF0.hxx"
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-CartridgeF0::CartridgeF0(const uInt8* image, uInt32 size, const Settings& settings)
+CartridgeF0::CartridgeF0(const uInt8* image, uInt32 size, const string& md5,
+                         const Settings& settings)
   : Cartridge(settings)
 {
-  // Copy the ROM image into my buffer
-  memcpy(myImage, image, BSPF_min(65536u, size));
+  // Get the (possibly shared) ROM image
+  myImage = shareImage(image, size, md5, 65536);
   createCodeAccessBase(65536);
 
   // Remember startup bank
@@ -143,6 +144,8 @@ uInt16 CartridgeF0::bankCount() const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartridgeF0::patch(uInt16 address, uInt8 value)
 {
+  unshareImage(myImage);
+
   myImage[(myCurrentBank << 12) + (address & 0x0FFF)] = value;
   return myBankChanged = true;
 } 
@@ -193,3 +196,19 @@ bool CartridgeF0::load(Serializer& in)
 
   return true;
 }
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool CartridgeF0::saveSnapshot(Snapshot& s) const
+{
+  s.bank[0] = myCurrentBank;
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeF0::loadSnapshot(const Snapshot& s)
+{
+  // Switching always selects the next bank
+  myCurrentBank = s.bank[0] - 1;
+  incbank();
+}
@@ -46,9 +46,11 @@ class CartridgeF0 : public Cartridge
 
       @param image     Pointer to the ROM image
       @param size      The size of the ROM image
+      @param md5       MD5sum of the ROM image
       @param settings  A reference to the various settings (read-only)
     */
-    CartridgeF0(const uInt8* image, uInt32 size, const Settings& settings);
+    CartridgeF0(const uInt8* image, uInt32 size, const string& md5,
+                const Settings& settings);
 
     /**
       Destructor
@@ -119,6 +121,12 @@ class CartridgeF0 : public Cartridge
     */
     bool load(Serializer& in);
 
+    /**
+      Copy the current state of this cart to/from the given snapshot.
+    */
+    bool saveSnapshot(Snapshot& s) const;
+    void loadSnapshot(const Snapshot& s);
+
     /**
       Get a descriptor for the device name (used in error checking).
 
@@ -165,8 +173,8 @@ class CartridgeF0 : public Cartridge
     // Indicates which bank is currently active
     uInt16 myCurrentBank;
 
-    // The 64K ROM image of the cartridge
-    uInt8 myImage[65536];
+    // The 64K ROM image of the cartridge (possibly shared)
+    uInt8* myImage;
 };
 
 #endif
@@ -349,6 +349,22 @@ bool CartridgeFA2::load(Serializer& in)
   return true;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool CartridgeFA2::saveSnapshot(Snapshot& s) const
+{
+  s.bank[0] = myCurrentBank;
+  memcpy(s.RAM, myRAM, 256);
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeFA2::loadSnapshot(const Snapshot& s)
+{
+  memcpy(myRAM, s.RAM, 256);
+  bank(s.bank[0]);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void CartridgeFA2::setRomName(const string& name)
 {
@@ -24,14 +24,15 @@
 #include "CartFE.hxx"
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-CartridgeFE::CartridgeFE(const uInt8* image, uInt32 size, const Settings& settings)
+CartridgeFE::CartridgeFE(const uInt8* image, uInt32 size, const string& md5,
+                         const Settings& settings)
   : Cartridge(settings),
     myLastAddress1(0),
     myLastAddress2(0),
     myLastAddressChanged(false)
 {
-  // Copy the ROM image into my buffer
-  memcpy(myImage, image, BSPF_min(8192u, size));
+  // Get the (possibly shared) ROM image
+  myImage = shareImage(image, size, md5, 8192);
 
   // We use System::PageAccess.codeAccessBase, but don't allow its use
   // through a pointer, since the address space of FE carts can change
@@ -144,6 +145,8 @@ bool CartridgeFE::bankChanged()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartridgeFE::patch(uInt16 address, uInt8 value)
 {
+  unshareImage(myImage);
+
   myImage[(address & 0x0FFF) + (((address & 0x2000) == 0) ? 4096 : 0)] = value;
   return myBankChanged = true;
 } 
@@ -192,3 +195,19 @@ bool CartridgeFE::load(Serializer& in)
 
   return true;
 }
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool CartridgeFE::saveSnapshot(Snapshot& s) const
+{
+  s.bank[0] = myLastAddress1;
+  s.bank[1] = myLastAddress2;
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeFE::loadSnapshot(const Snapshot& s)
+{
+  myLastAddress1 = s.bank[0];
+  myLastAddress2 = s.bank[1];
+}
@@ -60,9 +60,11 @@ class CartridgeFE : public Cartridge
 
       @param image     Pointer to the ROM image
       @param size      The size of the ROM image
+      @param md5       MD5sum of the ROM image
       @param settings  A reference to the various settings (read-only)
     */
-    CartridgeFE(const uInt8* image, uInt32 size, const Settings& settings);
+    CartridgeFE(const uInt8* image, uInt32 size, const string& md5,
+                const Settings& settings);
  
     /**
       Destructor
@@ -141,6 +143,12 @@ class CartridgeFE : public Cartridge
     */
     bool load(Serializer& in);
 
+    /**
+      Copy the current state of this cart to/from the given snapshot.
+    */
+    bool saveSnapshot(Snapshot& s) const;
+    void loadSnapshot(const Snapshot& s);
+
     /**
       Get a descriptor for the device name (used in error checking).
 
@@ -188,8 +196,8 @@ class CartridgeFE : public Cartridge
     void setAccessFlags(uInt16 address, uInt8 flags);
 
   private:
-    // The 8K ROM image of the cartridge
-    uInt8 myImage[8192];
+    // The 8K ROM image of the cartridge (possibly shared)
+    uInt8* myImage;
 
     // Previous two addresses accessed by peek()
     uInt16 myLastAddress1, myLastAddress2;
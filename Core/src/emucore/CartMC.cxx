@@ -34,6 +34,7 @@
 CartridgeMC::CartridgeMC(const uInt8* image, uInt32 size,
                          const Settings& settings)
   : Cartridge(settings),
+    myRAM(32768),
     mySlot3Locked(false)
 {
   // Make sure size is reasonable
@@ -59,7 +60,8 @@ void CartridgeMC::reset()
     for(uInt32 i = 0; i < 32768; ++i)
       myRAM[i] = mySystem->randGenerator().next();
   else
-    memset(myRAM, 0, 32768);
+    memset(myRAM.data(), 0, 32768);
+  myRAM.touchAll();
 
   myBankChanged = true;
 }
@@ -155,7 +157,7 @@ uInt8 CartridgeMC::peek(uInt16 address)
         else
         {
           triggerReadFromWritePort(peekAddress);
-          return myRAM[(uInt32)((block & 0x3F) << 9) + (address & 0x01FF)] = value;
+          return myRAM.poke((uInt32)((block & 0x3F) << 9) + (address & 0x01FF), value);
         }
       }
     }
@@ -202,7 +204,7 @@ bool CartridgeMC::poke(uInt16 address, uInt8 value)
     if(!(block & 0x80) && !(address & 0x0200))
     {
       // Handle the write to RAM
-      myRAM[(uInt32)((block & 0x3F) << 9) + (address & 0x01FF)] = value;
+      myRAM.poke((uInt32)((block & 0x3F) << 9) + (address & 0x01FF), value);
       return true;
     }
   }  
@@ -255,7 +257,7 @@ bool CartridgeMC::save(Serializer& out) const
     out.putByteArray(myCurrentBlock, 4);
 
     // The 32K of RAM
-    out.putByteArray(myRAM, 32 * 1024);
+    out.putByteArray(myRAM.data(), 32 * 1024);
   }
   catch(...)
   {
@@ -278,7 +280,8 @@ bool CartridgeMC::load(Serializer& in)
     in.getByteArray(myCurrentBlock, 4);
 
     // The 32K of RAM
-    in.getByteArray(myRAM, 32 * 1024);
+    in.getByteArray(myRAM.data(), 32 * 1024);
+    myRAM.touchAll();
   }
   catch(...)
   {
@@ -288,3 +291,23 @@ bool CartridgeMC::load(Serializer& in)
 
   return true;
 }
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool CartridgeMC::saveSnapshot(Snapshot& s) const
+{
+  for(uInt32 i = 0; i < 4; ++i)
+    s.bank[i] = myCurrentBlock[i];
+  s.registers[0] = mySlot3Locked;
+  myRAM.save(s.pages);
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeMC::loadSnapshot(const Snapshot& s)
+{
+  for(uInt32 i = 0; i < 4; ++i)
+    myCurrentBlock[i] = s.bank[i];
+  mySlot3Locked = s.registers[0];
+  myRAM.load(s.pages);
+}
@@ -224,6 +224,12 @@ class CartridgeMC : public Cartridge
     */
     bool load(Serializer& in);
 
+    /**
+      Copy the current state of this cart to/from the given snapshot.
+    */
+    bool saveSnapshot(Snapshot& s) const;
+    void loadSnapshot(const Snapshot& s);
+
     /**
       Get a descriptor for the device name (used in error checking).
 
@@ -265,7 +271,7 @@ class CartridgeMC : public Cartridge
     uInt8 myImage[131072];
 
     // The 32K of RAM for the cartridge
-    uInt8 myRAM[32768];
+    CartRAM myRAM;
 
     // Indicates which block is currently active for the four segments
     uInt8 myCurrentBlock[4];
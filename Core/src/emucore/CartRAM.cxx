@@ -0,0 +1,173 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2014 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//
+// $Id$
+//============================================================================
+
+#include <cstring>
+
+#include "System.hxx"
+#include "CartRAM.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+CartRAM::Pages::Pages(const Pages& pages)
+  : myPages(pages.myPages)
+{
+  for(uInt32 i = 0; i < myPages.size(); ++i)
+    share(myPages[i]);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+CartRAM::Pages::~Pages()
+{
+  clear();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+CartRAM::Pages& CartRAM::Pages::operator = (const Pages& pages)
+{
+  // Share the new pages before releasing the old ones, in case they're
+  // the same
+  for(uInt32 i = 0; i < pages.myPages.size(); ++i)
+    share(pages.myPages[i]);
+  clear();
+  myPages = pages.myPages;
+
+  return *this;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartRAM::Pages::clear()
+{
+  for(uInt32 i = 0; i < myPages.size(); ++i)
+    release(myPages[i]);
+  myPages.clear();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+CartRAM::CartRAM(uInt32 size)
+  : mySize(size),
+    myBase(size >> kPageShift, (Page*)0),
+    myDirty(size >> kPageShift, true)
+{
+  myData = new uInt8[mySize];
+  memset(myData, 0, mySize);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+CartRAM::~CartRAM()
+{
+  for(uInt32 i = 0; i < myBase.size(); ++i)
+    if(myBase[i])
+      release(myBase[i]);
+
+  delete[] myData;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartRAM::touch(uInt32 offset, uInt32 length)
+{
+  uInt32 last = (offset + length - 1) >> kPageShift;
+  for(uInt32 i = offset >> kPageShift; i <= last; ++i)
+    myDirty[i] = true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartRAM::touchAll()
+{
+  for(uInt32 i = 0; i < myDirty.size(); ++i)
+    myDirty[i] = true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartRAM::touchMapped(const System& system, uInt16 address,
+                          uInt32 offset, uInt32 length) const
+{
+  uInt16 shift = system.pageShift();
+  uInt32 last = (address + length - 1) >> shift;
+  if(myMappedWrites.size() <= last)
+    myMappedWrites.resize(last + 1, 0);
+
+  for(uInt32 a = 0; a < length; a += 1 << shift)
+  {
+    uInt32 count = system.pageWriteCount(address + a);
+    uInt32& seen = myMappedWrites[(address + a) >> shift];
+    if(count != seen)
+    {
+      myDirty[(offset + a) >> kPageShift] = true;
+      seen = count;
+    }
+  }
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartRAM::save(Pages& pages) const
+{
+  uInt32 count = myBase.size();
+  vector<Page*> saved(count);
+
+  for(uInt32 i = 0; i < count; ++i)
+  {
+    if(myDirty[i] || !myBase[i])
+    {
+      // Copy the page, which becomes the base of the live one
+      Page* page = new Page;
+      page->refs = 1;
+      memcpy(page->data, myData + (i << kPageShift), kPageSize);
+
+      if(myBase[i])
+        release(myBase[i]);
+      myBase[i] = page;
+      myDirty[i] = false;
+    }
+    saved[i] = share(myBase[i]);
+  }
+
+  pages.clear();
+  pages.myPages.swap(saved);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool CartRAM::load(const Pages& pages)
+{
+  uInt32 count = myBase.size();
+  if(pages.myPages.size() != count)
+    return false;
+
+  for(uInt32 i = 0; i < count; ++i)
+  {
+    Page* page = pages.myPages[i];
+    if(myDirty[i] || myBase[i] != page)
+    {
+      memcpy(myData + (i << kPageShift), page->data, kPageSize);
+
+      share(page);
+      if(myBase[i])
+        release(myBase[i]);
+      myBase[i] = page;
+      myDirty[i] = false;
+    }
+  }
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartRAM::release(Page* page)
+{
+  if(--page->refs == 0)
+    delete page;
+}
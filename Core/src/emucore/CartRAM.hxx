@@ -0,0 +1,176 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2014 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//
+// $Id$
+//============================================================================
+
+
+#ifndef CARTRAM_HXX
+#define CARTRAM_HXX
+
+class System;
+
+#include <vector>
+
+#include "bspf.hxx"
+
+/**
+  The extended RAM of a cartridge, organized in pages which snapshots
+  share copy-on-write.
+
+  The RAM itself is a flat array, so that it can be mapped directly into
+  the system as usual.  Alongside it, each page remembers the snapshot
+  page (if any) holding the same contents, and whether it has been
+  written since.  Saving a snapshot then copies only the pages written
+  since the last save or load, and shares the others; likewise, loading
+  a snapshot copies back only the pages which differ.  Forking a state
+  (ie, to try several inputs from it) thus costs in proportion to the
+  RAM actually written, rather than to the size of the RAM.
+
+  Writes through 'poke' mark their page as written.  Writes done by the
+  system through 'directPokeBase' aren't seen by the cart, so they're
+  collected from the page write counts of the system with 'touchMapped',
+  which must be called before the RAM is unmapped and before saving.
+  The dirty page flags of the system are left alone, as the debugger
+  relies on them (and clears them when it likes).
+
+  Pages are reference counted without locking, so snapshots sharing
+  pages must only be used from the thread which emulates the cart.
+*/
+class CartRAM
+{
+  public:
+    enum {
+      kPageShift = 8,
+      kPageSize = 1 << kPageShift
+    };
+
+  private:
+    // A page of RAM, shared by any number of snapshots
+    struct Page {
+      uInt32 refs;
+      uInt8 data[kPageSize];
+    };
+
+  public:
+    /**
+      The pages of the RAM in a snapshot (see Cartridge::Snapshot).
+      Copying them only shares the pages.
+    */
+    class Pages
+    {
+      friend class CartRAM;
+
+      public:
+        Pages() { }
+        Pages(const Pages& pages);
+        ~Pages();
+
+        Pages& operator = (const Pages& pages);
+
+        /**
+          Release all the pages.
+        */
+        void clear();
+
+      private:
+        vector<Page*> myPages;
+    };
+
+  public:
+    /**
+      Create RAM of the given size (a multiple of the page size).
+    */
+    CartRAM(uInt32 size);
+    virtual ~CartRAM();
+
+  public:
+    uInt8* data()             { return myData; }
+    const uInt8* data() const { return myData; }
+    uInt32 size() const       { return mySize; }
+
+    /**
+      Access a byte of the RAM; writing it this way must be followed by
+      a call to 'touch'.
+    */
+    uInt8& operator [] (uInt32 offset)             { return myData[offset]; }
+    const uInt8& operator [] (uInt32 offset) const { return myData[offset]; }
+
+    /**
+      Write a byte of the RAM, marking its page as written.
+
+      @return  The value written
+    */
+    uInt8 poke(uInt32 offset, uInt8 value)
+    {
+      myDirty[offset >> kPageShift] = true;
+      return myData[offset] = value;
+    }
+
+    /**
+      Mark the pages of the given range (or all of them) as written.
+    */
+    void touch(uInt32 offset, uInt32 length = 1);
+    void touchAll();
+
+    /**
+      Mark as written the pages of RAM behind the system pages written
+      in the given address range since the last call, which must map
+      'length' bytes of RAM from 'offset' through 'directPokeBase'.
+    */
+    void touchMapped(const System& system, uInt16 address,
+                     uInt32 offset, uInt32 length) const;
+
+    /**
+      Save the contents of the RAM to the given pages, copying only the
+      pages written since the last save or load.
+    */
+    void save(Pages& pages) const;
+
+    /**
+      Restore the contents of the RAM from the given pages, copying only
+      the pages which differ.
+
+      @return  False if the pages don't come from RAM of this size
+    */
+    bool load(const Pages& pages);
+
+  private:
+    // Reference counting of the snapshot pages
+    static Page* share(Page* page) { ++page->refs; return page; }
+    static void release(Page* page);
+
+  private:
+    uInt8* myData;
+    uInt32 mySize;
+
+    // For each page, the snapshot page with the same contents (if any),
+    // and whether it has been written since; this bookkeeping doesn't
+    // change the contents of the RAM, so saving can update it
+    mutable vector<Page*> myBase;
+    mutable vector<bool> myDirty;
+
+    // For each system page, its write count when 'touchMapped' last
+    // looked at it
+    mutable vector<uInt32> myMappedWrites;
+
+  private:
+    // Following constructors and assignment operators not supported
+    CartRAM(const CartRAM&);
+    CartRAM& operator = (const CartRAM&);
+};
+
+#endif
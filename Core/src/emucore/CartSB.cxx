@@ -24,16 +24,13 @@
 #include "CartSB.hxx"
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-CartridgeSB::CartridgeSB(const uInt8* image, uInt32 size,
+CartridgeSB::CartridgeSB(const uInt8* image, uInt32 size, const string& md5,
                          const Settings& settings)
   : Cartridge(settings),
     mySize(size)
 {
-  // Allocate array for the ROM image
-  myImage = new uInt8[mySize];
-
-  // Copy the ROM image into my buffer
-  memcpy(myImage, image, mySize);
+  // Get the (possibly shared) ROM image
+  myImage = shareImage(image, size, md5, mySize);
   createCodeAccessBase(mySize);
 
   // Remember startup bank
@@ -43,7 +40,6 @@ CartridgeSB::CartridgeSB(const uInt8* image, uInt32 size,
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 CartridgeSB::~CartridgeSB()
 {
-  delete[] myImage;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -161,6 +157,8 @@ uInt16 CartridgeSB::bankCount() const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartridgeSB::patch(uInt16 address, uInt8 value)
 {
+  unshareImage(myImage);
+
   myImage[(myCurrentBank << 12) + (address & 0x0FFF)] = value;
   return myBankChanged = true;
 } 
@@ -210,3 +208,17 @@ bool CartridgeSB::load(Serializer& in)
 
   return true;
 }
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool CartridgeSB::saveSnapshot(Snapshot& s) const
+{
+  s.bank[0] = myCurrentBank;
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeSB::loadSnapshot(const Snapshot& s)
+{
+  bank(s.bank[0]);
+}
@@ -45,9 +45,11 @@ class CartridgeSB : public Cartridge
 
       @param image     Pointer to the ROM image
       @param size      The size of the ROM image
+      @param md5       MD5sum of the ROM image
       @param settings  A reference to the various settings (read-only)
     */
-    CartridgeSB(const uInt8* image, uInt32 size, const Settings& settings);
+    CartridgeSB(const uInt8* image, uInt32 size, const string& md5,
+                const Settings& settings);
  
     /**
       Destructor
@@ -118,6 +120,12 @@ class CartridgeSB : public Cartridge
     */
     bool load(Serializer& in);
 
+    /**
+      Copy the current state of this cart to/from the given snapshot.
+    */
+    bool saveSnapshot(Snapshot& s) const;
+    void loadSnapshot(const Snapshot& s);
+
     /**
       Get a descriptor for the device name (used in error checking).
 
@@ -155,7 +163,7 @@ class CartridgeSB : public Cartridge
     bool poke(uInt16 address, uInt8 value);
 
   private:
-    // The 128-256K ROM image and size of the cartridge
+    // The 128-256K (possibly shared) ROM image and size of the cartridge
     uInt8* myImage;
     uInt32 mySize;
 
@@ -24,11 +24,12 @@
 #include "CartUA.hxx"
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-CartridgeUA::CartridgeUA(const uInt8* image, uInt32 size, const Settings& settings)
+CartridgeUA::CartridgeUA(const uInt8* image, uInt32 size, const string& md5,
+                         const Settings& settings)
   : Cartridge(settings)
 {
-  // Copy the ROM image into my buffer
-  memcpy(myImage, image, BSPF_min(8192u, size));
+  // Get the (possibly shared) ROM image
+  myImage = shareImage(image, size, md5, 8192);
   createCodeAccessBase(8192);
 
   // Remember startup bank
@@ -169,6 +170,8 @@ uInt16 CartridgeUA::bankCount() const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartridgeUA::patch(uInt16 address, uInt8 value)
 {
+  unshareImage(myImage);
+
   myImage[(myCurrentBank << 12) + (address & 0x0FFF)] = value;
   return myBankChanged = true;
 } 
@@ -218,3 +221,17 @@ bool CartridgeUA::load(Serializer& in)
 
   return true;
 }
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool CartridgeUA::saveSnapshot(Snapshot& s) const
+{
+  s.bank[0] = myCurrentBank;
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeUA::loadSnapshot(const Snapshot& s)
+{
+  bank(s.bank[0]);
+}
@@ -45,9 +45,11 @@ class CartridgeUA : public Cartridge
 
       @param image     Pointer to the ROM image
       @param size      The size of the ROM image
+      @param md5       MD5sum of the ROM image
       @param settings  A reference to the various settings (read-only)
     */
-    CartridgeUA(const uInt8* image, uInt32 size, const Settings& settings);
+    CartridgeUA(const uInt8* image, uInt32 size, const string& md5,
+                const Settings& settings);
  
     /**
       Destructor
@@ -118,6 +120,12 @@ class CartridgeUA : public Cartridge
     */
     bool load(Serializer& in);
 
+    /**
+      Copy the current state of this cart to/from the given snapshot.
+    */
+    bool saveSnapshot(Snapshot& s) const;
+    void loadSnapshot(const Snapshot& s);
+
     /**
       Get a descriptor for the device name (used in error checking).
 
@@ -158,8 +166,8 @@ class CartridgeUA : public Cartridge
     // Indicates which bank is currently active
     uInt16 myCurrentBank;
 
-    // The 8K ROM image of the cartridge
-    uInt8 myImage[8192];
+    // The 8K ROM image of the cartridge (possibly shared)
+    uInt8* myImage;
    
     // Previous Device's page access
     System::PageAccess myHotSpotPageAccess;
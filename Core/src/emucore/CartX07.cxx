@@ -26,11 +26,12 @@
 #include "CartX07.hxx"
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-CartridgeX07::CartridgeX07(const uInt8* image, uInt32 size, const Settings& settings)
+CartridgeX07::CartridgeX07(const uInt8* image, uInt32 size, const string& md5,
+                           const Settings& settings)
   : Cartridge(settings)
 {
-  // Copy the ROM image into my buffer
-  memcpy(myImage, image, BSPF_min(65536u, size));
+  // Get the (possibly shared) ROM image
+  myImage = shareImage(image, size, md5, 65536);
   createCodeAccessBase(65536);
 
   // Remember startup bank
@@ -153,6 +154,8 @@ uInt16 CartridgeX07::bankCount() const
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool CartridgeX07::patch(uInt16 address, uInt8 value)
 {
+  unshareImage(myImage);
+
   myImage[(myCurrentBank << 12) + (address & 0x0FFF)] = value;
   return myBankChanged = true;
 } 
@@ -202,3 +205,17 @@ bool CartridgeX07::load(Serializer& in)
 
   return true;
 }
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool CartridgeX07::saveSnapshot(Snapshot& s) const
+{
+  s.bank[0] = myCurrentBank;
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void CartridgeX07::loadSnapshot(const Snapshot& s)
+{
+  bank(s.bank[0]);
+}
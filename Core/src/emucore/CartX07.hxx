@@ -55,9 +55,11 @@ class CartridgeX07 : public Cartridge
 
       @param image     Pointer to the ROM image
       @param size      The size of the ROM image
+      @param md5       MD5sum of the ROM image
       @param settings  A reference to the various settings (read-only)
     */
-    CartridgeX07(const uInt8* image, uInt32 size, const Settings& settings);
+    CartridgeX07(const uInt8* image, uInt32 size, const string& md5,
+                 const Settings& settings);
  
     /**
       Destructor
@@ -128,6 +130,12 @@ class CartridgeX07 : public Cartridge
     */
     bool load(Serializer& in);
 
+    /**
+      Copy the current state of this cart to/from the given snapshot.
+    */
+    bool saveSnapshot(Snapshot& s) const;
+    void loadSnapshot(const Snapshot& s);
+
     /**
       Get a descriptor for the device name (used in error checking).
 
@@ -168,8 +176,8 @@ class CartridgeX07 : public Cartridge
     // Indicates which bank is currently active
     uInt16 myCurrentBank;
 
-    // The 64K ROM image of the cartridge
-    uInt8 myImage[65536];
+    // The 64K ROM image of the cartridge (possibly shared)
+    uInt8* myImage;
 };
 
 #endif
@@ -30,14 +30,17 @@
 #include "Driving.hxx"
 #include "Event.hxx"
 #include "EventHandler.hxx"
+#include "FrameInput.hxx"
 #include "Joystick.hxx"
 #include "Keyboard.hxx"
 #include "KidVid.hxx"
 #include "Genesis.hxx"
 #include "MindLink.hxx"
 #include "CompuMate.hxx"
+#include "ConsoleSnapshot.hxx"
 #include "M6502.hxx"
 #include "M6532.hxx"
+#include "MD5.hxx"
 #include "Paddles.hxx"
 #include "Props.hxx"
 #include "PropsSet.hxx"
@@ -78,7 +81,8 @@ Console::Console(OSystem* osystem, Cartridge* cart, const Properties& props)
     myDisplayFormat(""),  // Unknown TV format @ start
     myFramerate(0.0),     // Unknown framerate @ start
     myCurrentFormat(0),   // Unknown format @ start
-    myUserPaletteDefined(false)
+    myUserPaletteDefined(false),
+    myPalette(0)
 {
   // Load user-defined palette for this ROM
   loadUserPalette();
@@ -111,9 +115,16 @@ Console::Console(OSystem* osystem, Cartridge* cart, const Properties& props)
 
   // Auto-detect NTSC/PAL mode if it's requested
   string autodetected = "";
+  bool powerOnRestored = false;
   myDisplayFormat = myProperties.get(Display_Format);
   if(myDisplayFormat == "AUTO" || myOSystem->settings().getBool("rominfo"))
   {
+    // Take a snapshot of the power-on state, so it can be restored after
+    // autodetection instead of resetting the whole system a second time
+    mySystem->reset();
+    Serializer powerOn;
+    bool havePowerOn = mySystem->save(powerOn);
+
     // Run the TIA, looking for PAL scanline patterns
     // We turn off the SuperCharger progress bars, otherwise the SC BIOS
     // will take over 250 frames!
@@ -121,9 +132,7 @@ Console::Console(OSystem* osystem, Cartridge* cart, const Properties& props)
     bool fastscbios = myOSystem->settings().getBool("fastscbios");
     myOSystem->settings().setValue("fastscbios", true);
     mySystem->reset(true);  // autodetect in reset enabled
-    for(int i = 0; i < 60; ++i)
-      myTIA->update();
-    myDisplayFormat = myTIA->isPAL() ? "PAL" : "NTSC";
+    myDisplayFormat = autodetectFormat() ? "PAL" : "NTSC";
     if(myProperties.get(Display_Format) == "AUTO")
     {
       autodetected = "*";
@@ -132,6 +141,14 @@ Console::Console(OSystem* osystem, Cartridge* cart, const Properties& props)
 
     // Don't forget to reset the SC progress bars again
     myOSystem->settings().setValue("fastscbios", fastscbios);
+
+    // Go back to the state the system had before autodetection started
+    if(havePowerOn)
+    {
+      powerOn.reset();
+      powerOnRestored = mySystem->load(powerOn);
+      mySystem->endAutodetectMode();
+    }
   }
   myConsoleInfo.DisplayFormat = myDisplayFormat + autodetected;
 
@@ -161,7 +178,12 @@ Console::Console(OSystem* osystem, Cartridge* cart, const Properties& props)
   myOSystem->eventHandler().allowAllDirections(joyallow4);
 
   // Reset the system to its power-on state
-  mySystem->reset();
+  // If autodetection already restored it, only the TIA needs to pick up
+  // the (possibly changed) display properties
+  if(powerOnRestored)
+    myTIA->frameReset();
+  else
+    mySystem->reset();
 
   // Finally, add remaining info about the console
   myConsoleInfo.CartName   = myProperties.get(Cartridge_Name);
@@ -183,6 +205,20 @@ Console::~Console()
   delete myControllers[1];
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Console* Console::create(OSystem* osystem, Settings& settings,
+                         const uInt8* image, uInt32 size, const string& type)
+{
+  string md5 = MD5(image, size), id;
+  Properties props;
+  osystem->propSet().getMD5(md5, props);
+  string carttype = type != "" ? type : props.get(Cartridge_Type);
+
+  Cartridge* cart = Cartridge::create(image, size, md5, carttype, id,
+                                      *osystem, settings);
+  return cart ? new Console(osystem, cart, props) : (Console*) NULL;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool Console::save(Serializer& out) const
 {
@@ -229,6 +265,60 @@ bool Console::load(Serializer& in)
   return true;  // success
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Console::saveSnapshot(ConsoleSnapshot& snapshot) const
+{
+  if(!myCart->saveSnapshot(snapshot.cart))
+    return false;
+
+  mySystem->saveSnapshot(snapshot.system);
+  mySystem->m6502().saveSnapshot(snapshot.cpu);
+  myRiot->saveSnapshot(snapshot.riot);
+  myTIA->saveSnapshot(snapshot.tia);
+
+  myControllers[0]->saveSnapshot(snapshot.controllers[0]);
+  myControllers[1]->saveSnapshot(snapshot.controllers[1]);
+  mySwitches->saveSnapshot(snapshot.switches);
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Console::loadSnapshot(const ConsoleSnapshot& snapshot)
+{
+  mySystem->loadSnapshot(snapshot.system);
+  mySystem->m6502().loadSnapshot(snapshot.cpu);
+  myRiot->loadSnapshot(snapshot.riot);
+  myTIA->loadSnapshot(snapshot.tia);
+  myCart->loadSnapshot(snapshot.cart);
+
+  myControllers[0]->loadSnapshot(snapshot.controllers[0]);
+  myControllers[1]->loadSnapshot(snapshot.controllers[1]);
+  mySwitches->loadSnapshot(snapshot.switches);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Console::applyInput(const FrameInput& input)
+{
+  static const Event::Type events[2][5] = {
+    { Event::JoystickZeroUp, Event::JoystickZeroDown, Event::JoystickZeroLeft,
+      Event::JoystickZeroRight, Event::JoystickZeroFire },
+    { Event::JoystickOneUp, Event::JoystickOneDown, Event::JoystickOneLeft,
+      Event::JoystickOneRight, Event::JoystickOneFire }
+  };
+
+  for(int i = 0; i < 2; ++i)
+  {
+    if(!myControllers[i]->applyInput(input))
+    {
+      for(int bit = 0; bit < 5; ++bit)
+        myEvent.set(events[i][bit], (input.joystick[i] >> bit) & 1);
+      myControllers[i]->update();
+    }
+  }
+  mySwitches->applyInput(input);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Console::toggleFormat(int direction)
 {
@@ -400,8 +490,6 @@ void Console::togglePalette()
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-//OpenEmu: Function to receive palette
-extern void stellaOESetPalette(const uInt32* palette);
 void Console::setPalette(const string& type)
 {
   // Look at all the palettes, since we don't know which one is
@@ -433,8 +521,11 @@ void Console::setPalette(const string& type)
     (myDisplayFormat.compare(0, 5, "SECAM") == 0) ? palettes[paletteNum][2] :
      palettes[paletteNum][0];
 
-  //myOSystem->frameBuffer().setTIAPalette(palette);
-  stellaOESetPalette(palette);
+  myPalette = palette;
+
+  //OpenEmu: the frame buffer passes it on to the core, if it's the one of
+  //the console being played (see Stubs.hh)
+  myOSystem->frameBuffer().setTIAPalette(palette);
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -621,6 +712,35 @@ void Console::changeHeight(int direction)
   myProperties.set(Display_Height, val.str());
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Console::autodetectFormat()
+{
+  // Only VSYNC and scanline counts are of interest, so don't draw anything
+  bool video = myTIA->isVideoEnabled();
+  myTIA->enableVideo(false);
+
+  // Stop as soon as the number of scanlines has settled for the requested
+  // number of frames; otherwise fall back to looking at all 60 frames
+  int stableFrames = BSPF_max(myOSystem->settings().getInt("autodetectframes"), 1);
+  uInt32 lines = 0;
+  int stable = 0;
+  for(int i = 0; i < 60 && stable < stableFrames; ++i)
+  {
+    myTIA->update();
+    if(myTIA->scanlines() == lines)
+      ++stable;
+    else
+    {
+      lines = myTIA->scanlines();
+      stable = 0;
+    }
+  }
+  myTIA->enableVideo(video);
+
+  // Same PAL threshold the TIA uses when counting PAL frames
+  return stable >= stableFrames ? lines >= 287 : myTIA->isPAL();
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void Console::setTIAProperties()
 {
@@ -27,7 +27,10 @@ class System;
 class TIA;
 class M6532;
 class Cartridge;
+class Settings;
 class CompuMate;
+struct ConsoleSnapshot;
+struct FrameInput;
 
 #include "bspf.hxx"
 #include "Control.hxx"
@@ -82,6 +85,23 @@ class Console : public Serializable
     */
     virtual ~Console();
 
+    /**
+      Create a new console for the given game image, as the core does: its
+      properties are found from the MD5 of the image, and so is the type
+      of the cartridge unless one is given.
+
+      @param osystem   The OSystem object to use
+      @param settings  The settings used by the cartridge
+      @param image     The game image
+      @param size      The size of the game image
+      @param type      The type of the cartridge, or "" for the one of
+                       the properties
+      @return  The console, or NULL if the cartridge couldn't be created
+    */
+    static Console* create(OSystem* osystem, Settings& settings,
+                           const uInt8* image, uInt32 size,
+                           const string& type = "");
+
   public:
     /**
       Get the controller plugged into the specified jack
@@ -159,6 +179,33 @@ class Console : public Serializable
     */
     bool load(Serializer& in);
 
+    /**
+      Copy the current state of the console into the given snapshot,
+      directly from each device (see ConsoleSnapshot).
+
+      @param snapshot  The snapshot to fill
+      @return  False if the cartridge doesn't support snapshots
+    */
+    bool saveSnapshot(ConsoleSnapshot& snapshot) const;
+
+    /**
+      Restore the state of the console from a snapshot taken by
+      saveSnapshot().
+
+      @param snapshot  The snapshot to restore
+    */
+    void loadSnapshot(const ConsoleSnapshot& snapshot);
+
+    /**
+      Set the input of the next frame all at once (see FrameInput), in
+      place of updating the controllers and switches from the events.
+      Controllers which can't decode frame inputs are given the joystick
+      input as events instead.
+
+      @param input  The input of the next frame
+    */
+    void applyInput(const FrameInput& input);
+
     /**
       Get a descriptor for this console class (used in error checking).
 
@@ -222,6 +269,13 @@ class Console : public Serializable
     */
     void setPalette(const string& palette);
 
+    /**
+      Answers the palette currently in use, as 256 entries of 0x00RRGGBB
+      indexed by the values in TIA::currentFrameBuffer().  The pointer
+      changes whenever a different palette is selected.
+    */
+    const uInt32* currentPalette() const { return myPalette; }
+
     /**
       Toggles phosphor effect.
     */
@@ -310,6 +364,14 @@ class Console : public Serializable
     void toggleFixedColors() const;
 
   private:
+    /**
+      Runs the system (with TIA drawing disabled) until the number of
+      scanlines per frame stabilizes, and determines the display format.
+
+      @return  True if the ROM generates PAL-like frames, else false
+    */
+    bool autodetectFormat();
+
     /**
       Sets various properties of the TIA (YStart, Height, etc) based on
       the current display format.
@@ -388,6 +450,9 @@ class Console : public Serializable
     // successfully loaded
     bool myUserPaletteDefined;
 
+    // The palette currently in use
+    const uInt32* myPalette;
+
     // Contains detailed info about this console
     ConsoleInfo myConsoleInfo;
 
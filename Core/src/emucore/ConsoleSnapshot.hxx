@@ -0,0 +1,64 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2014 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//
+// $Id$
+//============================================================================
+
+#ifndef CONSOLE_SNAPSHOT_HXX
+#define CONSOLE_SNAPSHOT_HXX
+
+#include "bspf.hxx"
+#include "Cart.hxx"
+#include "Control.hxx"
+#include "M6502.hxx"
+#include "M6532.hxx"
+#include "System.hxx"
+#include "TIA.hxx"
+
+/**
+  The state of a console, held in the fields of each device's own
+  snapshot rather than as a serialized stream: the same state as written
+  by Console::save(), apart from that of the sound (which has no effect
+  on emulation), plus that of the random number generator (so that
+  emulation from a snapshot is repeatable, even when it reads undriven
+  bits of the data bus).  Taking a snapshot and restoring it copies each
+  field directly from and to its device, without going through a
+  Serializer.  This makes it suitable for saving and restoring the state
+  very often (ie, to try several inputs from the same state).
+
+  Most fields are plain values, but large cart RAM is held in pages
+  shared between snapshots (see CartRAM), so taking one costs in
+  proportion to the RAM written since the previous one, and some schemes
+  keep their extra state in a vector.  A snapshot must therefore be
+  copied by assignment (which shares the pages), never with memcpy().
+
+  A snapshot can only be restored in the console it was taken from.
+  Note that some bankswitching schemes (those with more state than a
+  Cartridge::Snapshot holds) don't support snapshots; a Serializer must
+  then be used instead.
+*/
+struct ConsoleSnapshot
+{
+  System::Snapshot system;
+  M6502::Snapshot cpu;
+  M6532::Snapshot riot;
+  TIA::Snapshot tia;
+  Cartridge::Snapshot cart;
+  Controller::Snapshot controllers[2];
+  uInt8 switches;
+};
+
+#endif
@@ -174,6 +174,20 @@ bool Controller::load(Serializer& in)
   return true;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Controller::saveSnapshot(Snapshot& s) const
+{
+  memcpy(s.digitalPinState, myDigitalPinState, sizeof(myDigitalPinState));
+  memcpy(s.analogPinValue, myAnalogPinValue, sizeof(myAnalogPinValue));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Controller::loadSnapshot(const Snapshot& s)
+{
+  memcpy(myDigitalPinState, s.digitalPinState, sizeof(myDigitalPinState));
+  memcpy(myAnalogPinValue, s.analogPinValue, sizeof(myAnalogPinValue));
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 string Controller::name() const
 {
@@ -23,6 +23,7 @@
 class Controller;
 class Event;
 class System;
+struct FrameInput;
 
 #include "Serializable.hxx"
 #include "bspf.hxx"
@@ -171,6 +172,16 @@ class Controller : public Serializable
     */
     virtual void update() = 0;
 
+    /**
+      Update the entire digital and analog pin state according to the
+      given input (see FrameInput), rather than to the events.
+
+      @param input  The input of the next frame
+      @return  False if this controller doesn't decode frame inputs, in
+               which case the input must be given to it as events
+    */
+    virtual bool applyInput(const FrameInput& input) { return false; }
+
     /**
       Notification method invoked by the system right before the
       system resets its cycle counter to zero.  It may be necessary 
@@ -236,6 +247,20 @@ class Controller : public Serializable
     */
     bool load(Serializer& in);
 
+    /**
+      The state saved by save(), as plain data (see ConsoleSnapshot).
+    */
+    struct Snapshot {
+      bool digitalPinState[5];
+      Int32 analogPinValue[2];
+    };
+
+    /**
+      Copy the current state of this controller to/from the given snapshot.
+    */
+    void saveSnapshot(Snapshot& s) const;
+    void loadSnapshot(const Snapshot& s);
+
   public:
     /// Constant which represents maximum resistance for analog pins
     static const Int32 maximumResistance;
@@ -1993,13 +1993,15 @@ void EventHandler::takeSnapshot(uInt32 number)
   else
     filename = sspath + ".png";
 
-  // Now create a PNG snapshot
+  // Now create a PNG snapshot; continuous snapshots are written in the
+  // background, so that emulation doesn't wait for them
+  bool queue = number > 0;
   if(myOSystem->settings().getBool("ss1x"))
   {
     string msg =
       myOSystem->png().saveImage(filename, myOSystem->frameBuffer(),
                                  myOSystem->console().tia(),
-                                 myOSystem->console().properties());
+                                 myOSystem->console().properties(), queue);
     if(showmessage)
       myOSystem->frameBuffer().showMessage(msg);
   }
@@ -2010,7 +2012,7 @@ void EventHandler::takeSnapshot(uInt32 number)
 
     string msg =
       myOSystem->png().saveImage(filename, myOSystem->frameBuffer(),
-                                 myOSystem->console().properties());
+                                 myOSystem->console().properties(), queue);
 
     // Re-enable old messages
     myOSystem->frameBuffer().enableMessages(true);
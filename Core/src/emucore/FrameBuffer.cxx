@@ -627,19 +627,22 @@ void FrameBuffer::resetSurfaces(FBSurface* tiasurface)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt32 FrameBuffer::tiaPixel(uInt32 idx, uInt8 shift) const
 {
-  uInt8 c = *(myOSystem->console().tia().currentFrameBuffer() + idx) | shift;
-  uInt8 p = *(myOSystem->console().tia().previousFrameBuffer() + idx) | shift;
+  // The phosphor effect is applied by each backend as the frame is drawn,
+  // so the pixel is taken from what was actually shown (greyed pixels
+  // are never blended)
+  uInt32 pixel;
+  if(myUsePhosphor && shift == 0 && phosphorPixel(idx, pixel))
+    return pixel;
 
-  return (!myUsePhosphor ? myDefPalette[c] : myAvgPalette[c][p]);
+  uInt8 c = *(myOSystem->console().tia().currentFrameBuffer() + idx) | shift;
+  return myDefPalette[c];
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void FrameBuffer::setTIAPalette(const uInt32* palette)
 {
-  int i, j;
-
   // Set palette for normal fill
-  for(i = 0; i < 256; ++i)
+  for(int i = 0; i < 256; ++i)
   {
     Uint8 r = (palette[i] >> 16) & 0xff;
     Uint8 g = (palette[i] >> 8) & 0xff;
@@ -660,26 +663,6 @@ void FrameBuffer::setTIAPalette(const uInt32* palette)
     }
   }
 
-  // Set palette for phosphor effect
-  for(i = 0; i < 256; ++i)
-  {
-    for(j = 0; j < 256; ++j)
-    {
-      uInt8 ri = (palette[i] >> 16) & 0xff;
-      uInt8 gi = (palette[i] >> 8) & 0xff;
-      uInt8 bi = palette[i] & 0xff;
-      uInt8 rj = (palette[j] >> 16) & 0xff;
-      uInt8 gj = (palette[j] >> 8) & 0xff;
-      uInt8 bj = palette[j] & 0xff;
-
-      Uint8 r = (Uint8) getPhosphor(ri, rj);
-      Uint8 g = (Uint8) getPhosphor(gi, gj);
-      Uint8 b = (Uint8) getPhosphor(bi, bj);
-
-      myAvgPalette[i][j] = mapRGB(r, g, b);
-    }
-  }
-
   myRedrawEntireFrame = true;
 }
 
@@ -919,15 +902,6 @@ void FrameBuffer::setWindowIcon()
 #endif
 }
 
-// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
-uInt8 FrameBuffer::getPhosphor(uInt8 c1, uInt8 c2) const
-{
-  if(c2 > c1)
-    BSPF_swap(c1, c2);
-
-  return ((c1 - c2) * myPhosphorBlend)/100 + c2;
-}
-
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 const VariantList& FrameBuffer::supportedTIAFilters(const string& type)
 {
@@ -193,6 +193,17 @@ class FrameBuffer
     */
     void enablePhosphor(bool enable, int blend) { }
 
+    /**
+      Get the pixel at the given TIA buffer index as last shown with the
+      phosphor effect, in the format of the TIA palette.
+
+      @param idx    The index of the pixel in the TIA frame buffer
+      @param pixel  The blended pixel
+      @return  False if the backend can't provide it (the unblended pixel
+               is then used instead)
+    */
+    virtual bool phosphorPixel(uInt32 idx, uInt32& pixel) const { return false; }
+
     /**
       This method is called to get the specified scanline data from the
       viewable FrameBuffer area.  Note that this isn't the same as any
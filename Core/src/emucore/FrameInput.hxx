@@ -0,0 +1,77 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2014 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//
+// $Id$
+//============================================================================
+
+#ifndef FRAME_INPUT_HXX
+#define FRAME_INPUT_HXX
+
+#include "bspf.hxx"
+
+/**
+  The complete input of the console for one frame, as plain data: the
+  state of the joysticks, paddles and console switches.  It's applied in
+  a single call (see Console::applyInput), and decoded by the controllers
+  straight into their pins, rather than set as individual events which
+  each controller then has to look up.  This makes it the cheapest way of
+  driving many consoles in lockstep, or replaying recorded input.
+
+  Everything describes the hardware rather than the events mapped to it:
+  paddle 0 is the first paddle of the left jack whatever the 'swap'
+  settings are, and the switches are their actual positions, so an input
+  must carry the difficulty and TV type switches even when they don't
+  change.
+*/
+struct FrameInput
+{
+  // The bits of each joystick
+  enum {
+    kUp    = 1 << 0,
+    kDown  = 1 << 1,
+    kLeft  = 1 << 2,
+    kRight = 1 << 3,
+    kFire  = 1 << 4
+  };
+
+  // The bits of the console switches
+  enum {
+    kSelect      = 1 << 0,
+    kReset       = 1 << 1,
+    kColor       = 1 << 2,
+    kLeftDiffA   = 1 << 3,
+    kRightDiffA  = 1 << 4
+  };
+
+  uInt8 joystick[2];     // Left and right jacks
+  uInt8 paddleFire;      // Bit 'n' is the button of paddle 'n'
+  uInt8 switches;
+  uInt16 paddle[4];      // Positions, from 0 (least resistance) to 65535
+
+  /**
+    Set an input with no buttons pressed, the paddles centred, and the
+    given switches.
+  */
+  void clear(uInt8 switchBits = kColor)
+  {
+    joystick[0] = joystick[1] = 0;
+    paddleFire = 0;
+    switches = switchBits;
+    paddle[0] = paddle[1] = paddle[2] = paddle[3] = 32768;
+  }
+};
+
+#endif
@@ -18,6 +18,7 @@
 //============================================================================
 
 #include "Event.hxx"
+#include "FrameInput.hxx"
 #include "Joystick.hxx"
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -119,6 +120,19 @@ void Joystick::update()
   }
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Joystick::applyInput(const FrameInput& input)
+{
+  uInt8 bits = input.joystick[myJack == Left ? 0 : 1];
+  myDigitalPinState[One]   = !(bits & FrameInput::kUp);
+  myDigitalPinState[Two]   = !(bits & FrameInput::kDown);
+  myDigitalPinState[Three] = !(bits & FrameInput::kLeft);
+  myDigitalPinState[Four]  = !(bits & FrameInput::kRight);
+  myDigitalPinState[Six]   = !(bits & FrameInput::kFire);
+
+  return true;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool Joystick::setMouseControl(
     Controller::Type xtype, int xid, Controller::Type ytype, int yid)
@@ -54,6 +54,12 @@ class Joystick : public Controller
     */
     void update();
 
+    /**
+      Update the entire digital and analog pin state according to the
+      given frame input.
+    */
+    bool applyInput(const FrameInput& input);
+
     /**
       Determines how this controller will treat values received from the
       X/Y axis and left/right buttons of the mouse.  Since not all controllers
@@ -54,8 +54,6 @@ M6502::M6502(uInt32 systemCyclesPerProcessorCycle, const Settings& settings)
     mySystemCyclesPerProcessorCycle(systemCyclesPerProcessorCycle),
     myLastAccessWasRead(true),
     myTotalInstructionCount(0),
-    myNumberOfDistinctAccesses(0),
-    myLastAddress(0),
     myLastPeekAddress(0),
     myLastPokeAddress(0),
     myLastSrcAddressS(-1),
@@ -132,7 +130,7 @@ void M6502::reset()
 
   myTotalInstructionCount = 0;
 
-  myLastAddress = myLastPeekAddress = myLastPokeAddress = 0;
+  myLastPeekAddress = myLastPokeAddress = 0;
   myLastSrcAddressS = myLastSrcAddressA =
     myLastSrcAddressX = myLastSrcAddressY = -1;
   myDataAddressForPoke = 0;
@@ -141,14 +139,6 @@ void M6502::reset()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 inline uInt8 M6502::peek(uInt16 address, uInt8 flags)
 {
-  ////////////////////////////////////////////////
-  // TODO - move this logic directly into CartAR
-  if(address != myLastAddress)
-  {
-    myNumberOfDistinctAccesses++;
-    myLastAddress = address;
-  }
-  ////////////////////////////////////////////////
   mySystem->incrementCycles(mySystemCyclesPerProcessorCycle);
 
 #ifdef DEBUGGER_SUPPORT
@@ -170,14 +160,6 @@ inline uInt8 M6502::peek(uInt16 address, uInt8 flags)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 inline void M6502::poke(uInt16 address, uInt8 value)
 {
-  ////////////////////////////////////////////////
-  // TODO - move this logic directly into CartAR
-  if(address != myLastAddress)
-  {
-    myNumberOfDistinctAccesses++;
-    myLastAddress = address;
-  }
-  ////////////////////////////////////////////////
   mySystem->incrementCycles(mySystemCyclesPerProcessorCycle);
 
 #ifdef DEBUGGER_SUPPORT
@@ -356,10 +338,7 @@ bool M6502::save(Serializer& out) const
 
     out.putByte(myExecutionStatus);
 
-    // Indicates the number of distinct memory accesses
-    out.putInt(myNumberOfDistinctAccesses);
     // Indicates the last address(es) which was accessed
-    out.putShort(myLastAddress);
     out.putShort(myLastPeekAddress);
     out.putShort(myLastPokeAddress);
     out.putShort(myDataAddressForPoke);
@@ -404,10 +383,7 @@ bool M6502::load(Serializer& in)
 
     myExecutionStatus = in.getByte();
 
-    // Indicates the number of distinct memory accesses
-    myNumberOfDistinctAccesses = in.getInt();
     // Indicates the last address(es) which was accessed
-    myLastAddress = in.getShort();
     myLastPeekAddress = in.getShort();
     myLastPokeAddress = in.getShort();
     myDataAddressForPoke = in.getShort();
@@ -425,6 +401,64 @@ bool M6502::load(Serializer& in)
   return true;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502::saveSnapshot(Snapshot& s) const
+{
+  s.A = A;
+  s.X = X;
+  s.Y = Y;
+  s.SP = SP;
+  s.IR = IR;
+  s.PC = PC;
+
+  s.N = N;
+  s.V = V;
+  s.B = B;
+  s.D = D;
+  s.I = I;
+  s.notZ = notZ;
+  s.C = C;
+
+  s.executionStatus = myExecutionStatus;
+
+  s.lastPeekAddress = myLastPeekAddress;
+  s.lastPokeAddress = myLastPokeAddress;
+  s.dataAddressForPoke = myDataAddressForPoke;
+  s.lastSrcAddressS = myLastSrcAddressS;
+  s.lastSrcAddressA = myLastSrcAddressA;
+  s.lastSrcAddressX = myLastSrcAddressX;
+  s.lastSrcAddressY = myLastSrcAddressY;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6502::loadSnapshot(const Snapshot& s)
+{
+  A = s.A;
+  X = s.X;
+  Y = s.Y;
+  SP = s.SP;
+  IR = s.IR;
+  PC = s.PC;
+
+  N = s.N;
+  V = s.V;
+  B = s.B;
+  D = s.D;
+  I = s.I;
+  notZ = s.notZ;
+  C = s.C;
+
+  myExecutionStatus = s.executionStatus;
+
+  myLastPeekAddress = s.lastPeekAddress;
+  myLastPokeAddress = s.lastPokeAddress;
+  myDataAddressForPoke = s.dataAddressForPoke;
+  myLastSrcAddressS = s.lastSrcAddressS;
+  myLastSrcAddressA = s.lastSrcAddressA;
+  myLastSrcAddressX = s.lastSrcAddressX;
+  myLastSrcAddressY = s.lastSrcAddressY;
+}
+
 #ifdef DEBUGGER_SUPPORT
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void M6502::attach(Debugger& debugger)
@@ -54,6 +54,9 @@ class M6502 : public Serializable
   friend class CartDebug;
   friend class CpuDebug;
 
+  // The Supercharger fast-load sets up the registers as its BIOS would
+  friend class CartridgeAR;
+
   public:
     /**
       Create a new 6502 microprocessor with the specified cycle 
@@ -176,13 +179,6 @@ class M6502 : public Serializable
     */
     int totalInstructionCount() const { return myTotalInstructionCount; }
 
-    /**
-      Get the number of memory accesses to distinct memory locations
-
-      @return The number of memory accesses to distinct memory locations
-    */
-    uInt32 distinctAccesses() const { return myNumberOfDistinctAccesses; }
-
     /**
       Saves the current state of this device to the given Serializer.
 
@@ -199,6 +195,25 @@ class M6502 : public Serializable
     */
     bool load(Serializer& in);
 
+    /**
+      The state saved by save(), as plain data (see ConsoleSnapshot).
+    */
+    struct Snapshot {
+      uInt8 A, X, Y, SP, IR;
+      uInt16 PC;
+      bool N, V, B, D, I, notZ, C;
+      uInt8 executionStatus;
+      uInt16 lastPeekAddress, lastPokeAddress, dataAddressForPoke;
+      Int32 lastSrcAddressS, lastSrcAddressA,
+            lastSrcAddressX, lastSrcAddressY;
+    };
+
+    /**
+      Copy the current state of this device to/from the given snapshot.
+    */
+    void saveSnapshot(Snapshot& s) const;
+    void loadSnapshot(const Snapshot& s);
+
     /**
       Get a null terminated string which is the processor's name (i.e. "M6532")
 
@@ -336,12 +351,6 @@ class M6502 : public Serializable
     /// The total number of instructions executed so far
     int myTotalInstructionCount;
 
-    /// Indicates the numer of distinct memory accesses
-    uInt32 myNumberOfDistinctAccesses;
-
-    /// Indicates the last address which was accessed
-    uInt16 myLastAddress;
-
     /// Indicates the last address which was accessed specifically
     /// by a peek or poke command
     uInt16 myLastPeekAddress, myLastPokeAddress;
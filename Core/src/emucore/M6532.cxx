@@ -401,6 +401,46 @@ bool M6532::load(Serializer& in)
   return true;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6532::saveSnapshot(Snapshot& s) const
+{
+  memcpy(s.RAM, myRAM, 128);
+
+  s.timer = myTimer;
+  s.intervalShift = myIntervalShift;
+  s.cyclesWhenTimerSet = myCyclesWhenTimerSet;
+
+  s.DDRA = myDDRA;
+  s.DDRB = myDDRB;
+  s.outA = myOutA;
+  s.outB = myOutB;
+
+  s.interruptFlag = myInterruptFlag;
+  s.timerFlagValid = myTimerFlagValid;
+  s.edgeDetectPositive = myEdgeDetectPositive;
+  memcpy(s.outTimer, myOutTimer, 4);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void M6532::loadSnapshot(const Snapshot& s)
+{
+  memcpy(myRAM, s.RAM, 128);
+
+  myTimer = s.timer;
+  myIntervalShift = s.intervalShift;
+  myCyclesWhenTimerSet = s.cyclesWhenTimerSet;
+
+  myDDRA = s.DDRA;
+  myDDRB = s.DDRB;
+  myOutA = s.outA;
+  myOutB = s.outB;
+
+  myInterruptFlag = s.interruptFlag;
+  myTimerFlagValid = s.timerFlagValid;
+  myEdgeDetectPositive = s.edgeDetectPositive;
+  memcpy(myOutTimer, s.outTimer, 4);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt8 M6532::intim() const
 {
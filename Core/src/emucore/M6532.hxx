@@ -114,6 +114,33 @@ class M6532 : public Device
     */
     bool load(Serializer& in);
 
+    /**
+      The state saved by save(), as plain data (see ConsoleSnapshot).
+    */
+    struct Snapshot {
+      uInt8 RAM[128];
+      uInt32 timer;
+      uInt32 intervalShift;
+      Int32 cyclesWhenTimerSet;
+      uInt8 DDRA, DDRB, outA, outB;
+      uInt8 interruptFlag;
+      bool timerFlagValid;
+      bool edgeDetectPositive;
+      uInt8 outTimer[4];
+    };
+
+    /**
+      Copy the current state of this device to/from the given snapshot.
+    */
+    void saveSnapshot(Snapshot& s) const;
+    void loadSnapshot(const Snapshot& s);
+
+    /**
+      Answers the 128 bytes of RAM, ie, to observe the state of a game
+      without going through peek().
+    */
+    const uInt8* getRAM() const { return myRAM; }
+
     /**
       Get a descriptor for the device name (used in error checking).
 
@@ -0,0 +1,428 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2014 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//
+// $Id$
+//============================================================================
+
+#include "Console.hxx"
+#include "Control.hxx"
+#include "Props.hxx"
+#include "Random.hxx"
+#include "Serializer.hxx"
+#include "System.hxx"
+#include "TIA.hxx"
+
+#include "Movie.hxx"
+
+#define MOVIE_MAGIC "StelMovi"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Movie::putNumber(ostream& out, uInt32 value)
+{
+  while(value >= 0x80)
+  {
+    out.put(char((value & 0x7f) | 0x80));
+    value >>= 7;
+  }
+  out.put(char(value));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Movie::getNumber(istream& in, uInt32& value)
+{
+  value = 0;
+  for(uInt32 shift = 0; shift < 32; shift += 7)
+  {
+    int c = in.get();
+    if(c == istream::traits_type::eof())
+      return false;
+
+    value |= uInt32(c & 0x7f) << shift;
+    if(!(c & 0x80))
+      return true;
+  }
+  return false;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Movie::putString(ostream& out, const string& str)
+{
+  putNumber(out, str.length());
+  out.write(str.data(), str.length());
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Movie::getString(istream& in, string& str)
+{
+  uInt32 length;
+  if(!getNumber(in, length))
+    return false;
+
+  str.resize(length);
+  if(length > 0)
+    in.read(&str[0], length);
+
+  return !in.fail();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 Movie::frameHash(const TIA& tia)
+{
+  const uInt8* frame = tia.currentFrameBuffer();
+  uInt32 size = tia.width() * tia.height(), hash = 2166136261u;
+
+  for(uInt32 i = 0; i < size; ++i)
+    hash = (hash ^ frame[i]) * 16777619u;
+
+  return hash;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+MovieWriter::MovieWriter()
+  : myConsole(0),
+    myKeyInterval(600),
+    myCheckInterval(60),
+    myFrames(0)
+{
+  memset(myValues, 0, sizeof(myValues));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+MovieWriter::~MovieWriter()
+{
+  close();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool MovieWriter::open(const string& filename, Console& console,
+                       uInt32 keyInterval, uInt32 checkInterval)
+{
+  close();
+
+  myOut.open(filename.c_str(), ios_base::binary | ios_base::trunc);
+  if(!myOut.is_open())
+    return false;
+
+  myConsole = &console;
+  myKeyInterval = keyInterval > 0 ? keyInterval : 1;
+  myCheckInterval = checkInterval;
+  myFrames = 0;
+
+  // The movie can only be played with the same ROM and controllers
+  myOut.write(MOVIE_MAGIC, 8);
+  Movie::putNumber(myOut, Movie::kVersion);
+  Movie::putString(myOut, console.properties().get(Cartridge_MD5));
+  Movie::putString(myOut, console.controller(Controller::Left).name());
+  Movie::putString(myOut, console.controller(Controller::Right).name());
+  Movie::putNumber(myOut, myKeyInterval);
+
+  return myOut.good();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool MovieWriter::addFrame(const Event& event)
+{
+  if(!myOut.is_open())
+    return false;
+
+  // The previous frame has been emulated by now
+  if(myCheckInterval > 0 && myFrames > 0 && myFrames % myCheckInterval == 0)
+  {
+    Movie::putNumber(myOut, Movie::kCheckpointMarker);
+    Movie::putNumber(myOut, myFrames - 1);
+    Movie::putNumber(myOut, Movie::frameHash(myConsole->tia()));
+  }
+
+  // Every so often, save the complete state; the input that follows is
+  // then written in full, by comparing it to no input at all
+  if(myFrames % myKeyInterval == 0)
+  {
+    Serializer state;
+    if(!myConsole->save(state))
+      return false;
+
+    Movie::putNumber(myOut, Movie::kKeyFrameMarker);
+    Movie::putNumber(myOut, myFrames);
+    Movie::putNumber(myOut, myConsole->system().randGenerator().state());
+    Movie::putString(myOut, state.data());
+    memset(myValues, 0, sizeof(myValues));
+  }
+
+  // Find the events which have changed since the previous frame
+  uInt32 changed[Movie::kLastEvent - Movie::kFirstEvent], count = 0;
+  for(uInt32 type = Movie::kFirstEvent; type < Movie::kLastEvent; ++type)
+    if(event.get(Event::Type(type)) != myValues[type])
+      changed[count++] = type;
+
+  Movie::putNumber(myOut, count << 1);
+  for(uInt32 i = 0, previous = 0; i < count; previous = changed[i++])
+  {
+    Int32 value = event.get(Event::Type(changed[i]));
+    Movie::putNumber(myOut, changed[i] - previous);
+    Movie::putNumber(myOut, Movie::zigzag(value));
+    myValues[changed[i]] = value;
+  }
+  ++myFrames;
+
+  return myOut.good();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void MovieWriter::close()
+{
+  if(myOut.is_open())
+    myOut.close();
+  myConsole = 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+MovieReader::MovieReader()
+  : myConsole(0),
+    myFrames(0),
+    myPosition(0),
+    myCheckpoints(0),
+    myMismatches(0),
+    myFirstMismatch(-1)
+{
+  memset(myValues, 0, sizeof(myValues));
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+MovieReader::~MovieReader()
+{
+  close();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool MovieReader::open(const string& filename, Console& console)
+{
+  close();
+
+  myIn.open(filename.c_str(), ios_base::binary);
+  if(!myIn.is_open())
+    return false;
+
+  // Make sure the movie was recorded with this ROM and these controllers
+  char magic[8];
+  uInt32 version, keyInterval;
+  string md5, left, right;
+  myIn.read(magic, 8);
+  if(myIn.fail() || memcmp(magic, MOVIE_MAGIC, 8) != 0 ||
+     !Movie::getNumber(myIn, version) || version != Movie::kVersion ||
+     !Movie::getString(myIn, md5) || !Movie::getString(myIn, left) ||
+     !Movie::getString(myIn, right) || !Movie::getNumber(myIn, keyInterval) ||
+     md5 != console.properties().get(Cartridge_MD5) ||
+     left != console.controller(Controller::Left).name() ||
+     right != console.controller(Controller::Right).name())
+  {
+    close();
+    return false;
+  }
+  myConsole = &console;
+
+  // Locate the keyframes, and count the frames; anything following the
+  // last complete frame (ie, when recording was interrupted) is ignored
+  streamoff start = myIn.tellg();
+  myIn.seekg(0, ios_base::end);
+  streamoff size = myIn.tellg();
+  myIn.seekg(start);
+
+  for(;;)
+  {
+    streamoff offset = myIn.tellg();
+    uInt32 value, frame, random, length, hash;
+    if(!Movie::getNumber(myIn, value))
+      break;
+
+    if(value == Movie::kKeyFrameMarker)
+    {
+      if(!Movie::getNumber(myIn, frame) || frame != myFrames ||
+         !Movie::getNumber(myIn, random) || !Movie::getNumber(myIn, length) ||
+         myIn.tellg() + streamoff(length) > size)
+        break;
+
+      KeyFrame keyframe = { frame, offset };
+      myKeyFrames.push_back(keyframe);
+      myIn.seekg(length, ios_base::cur);
+      continue;
+    }
+    else if(value == Movie::kCheckpointMarker)
+    {
+      if(!Movie::getNumber(myIn, frame) || frame + 1 != myFrames ||
+         !Movie::getNumber(myIn, hash))
+        break;
+      continue;
+    }
+    else if(value & 1)
+      break;
+
+    uInt32 count = value >> 1, type, data;
+    while(count > 0 && Movie::getNumber(myIn, type) &&
+          Movie::getNumber(myIn, data))
+      --count;
+    if(count > 0)
+      break;
+
+    ++myFrames;
+  }
+
+  if(myKeyFrames.empty() || myKeyFrames[0].frame != 0 || seek(0) != 0)
+  {
+    close();
+    return false;
+  }
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void MovieReader::close()
+{
+  if(myIn.is_open())
+    myIn.close();
+  myIn.clear();
+
+  myConsole = 0;
+  myKeyFrames.clear();
+  myFrames = myPosition = 0;
+  myCheckpoints = myMismatches = 0;
+  myFirstMismatch = -1;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool MovieReader::nextFrame(Event& event)
+{
+  if(!myIn.is_open() || myPosition >= myFrames)
+    return false;
+
+  // Playback from the start or from a keyframe already matches the state
+  // saved in a keyframe, so the state itself is skipped
+  uInt32 value;
+  for(;;)
+  {
+    if(!Movie::getNumber(myIn, value))
+      return false;
+    else if(value == Movie::kKeyFrameMarker)
+    {
+      if(!readKeyFrame(false))
+        return false;
+    }
+    else if(value == Movie::kCheckpointMarker)
+    {
+      if(!readCheckpoint())
+        return false;
+    }
+    else if(value & 1)
+      return false;
+    else
+      break;
+  }
+
+  uInt32 type = 0;
+  for(uInt32 count = value >> 1; count > 0; --count)
+  {
+    uInt32 delta, data;
+    if(!Movie::getNumber(myIn, delta) || !Movie::getNumber(myIn, data))
+      return false;
+
+    type += delta;
+    if(type < uInt32(Movie::kFirstEvent) || type >= uInt32(Movie::kLastEvent))
+      return false;
+    myValues[type] = Movie::unzigzag(data);
+  }
+
+  for(type = Movie::kFirstEvent; type < Movie::kLastEvent; ++type)
+    event.set(Event::Type(type), myValues[type]);
+  ++myPosition;
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Int32 MovieReader::seek(uInt32 frame)
+{
+  if(!myIn.is_open() || frame >= myFrames)
+    return -1;
+
+  // Find the last keyframe at or before the frame
+  uInt32 k = 0;
+  while(k + 1 < myKeyFrames.size() && myKeyFrames[k + 1].frame <= frame)
+    ++k;
+
+  myIn.clear();
+  myIn.seekg(myKeyFrames[k].offset);
+  myPosition = myKeyFrames[k].frame;
+
+  uInt32 marker;
+  if(!Movie::getNumber(myIn, marker) || marker != Movie::kKeyFrameMarker ||
+     !readKeyFrame(true))
+    return -1;
+
+  return myPosition;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool MovieReader::readKeyFrame(bool restore)
+{
+  uInt32 frame, random, length;
+  if(!Movie::getNumber(myIn, frame) || frame != myPosition ||
+     !Movie::getNumber(myIn, random) || !Movie::getNumber(myIn, length))
+    return false;
+
+  // The input of the following frame is written in full
+  memset(myValues, 0, sizeof(myValues));
+
+  if(!restore)
+  {
+    myIn.seekg(length, ios_base::cur);
+    return !myIn.fail();
+  }
+
+  string data(length, '\0');
+  if(length > 0)
+    myIn.read(&data[0], length);
+  if(myIn.fail())
+    return false;
+
+  Serializer state;
+  state.setData(data);
+  if(!myConsole->load(state))
+    return false;
+
+  // The random number generator decides the undriven bits of the data bus
+  // (ie, when reading the write port of extra cart RAM)
+  myConsole->system().randGenerator().setState(random);
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool MovieReader::readCheckpoint()
+{
+  uInt32 frame, hash;
+  if(!Movie::getNumber(myIn, frame) || frame + 1 != myPosition ||
+     !Movie::getNumber(myIn, hash))
+    return false;
+
+  ++myCheckpoints;
+  if(Movie::frameHash(myConsole->tia()) != hash)
+  {
+    ++myMismatches;
+    if(myFirstMismatch < 0)
+      myFirstMismatch = frame;
+  }
+
+  return true;
+}
@@ -0,0 +1,269 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2014 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//
+// $Id$
+//============================================================================
+
+#ifndef MOVIE_HXX
+#define MOVIE_HXX
+
+class Console;
+class TIA;
+
+#include <fstream>
+#include <vector>
+
+#include "bspf.hxx"
+#include "Event.hxx"
+
+/**
+  An input movie: the state of the console when recording started,
+  followed by the input (the values of the emulation events) given to
+  each frame.  Playing the movie back from that state reproduces exactly
+  the same frames, so a movie serves both as a recording and as a test.
+
+  Only the events which changed since the previous frame are stored, as
+  pairs of the distance to the previous changed event and the new value
+  (zigzag encoded), each written as a variable-length integer; a frame
+  with no change in input takes a single byte.  Every so often, a
+  keyframe holding the complete state of the console is inserted; the
+  input of the frame following it is then stored in full, so that
+  playback can start from any keyframe.
+
+  Checkpoints holding a hash of the frame just emulated are inserted at
+  another interval, so that playback can tell whether it still generates
+  the frames which were recorded.
+
+  File layout (all numbers are variable-length integers, 7 bits per
+  byte, least significant first; strings are a length and the bytes):
+
+    Header:      "StelMovi", version, ROM md5, left and right controller
+                 names, keyframe interval
+    Keyframe:    1, frame number, state of the random number generator
+                 (which a Serializer doesn't hold), state length, state
+                 (from Console::save)
+    Checkpoint:  3, frame number, hash of the frame (see frameHash)
+    Frame:       changed events * 2, then for each: type delta, value
+
+  The movie starts with a keyframe, so that it begins in the state in
+  which it was recorded.  Note that emulation is only deterministic if
+  the state of the console is; ie, 'tiadriven' must be disabled.
+*/
+class Movie
+{
+  public:
+    enum {
+      kVersion = 2,
+      kKeyFrameMarker = 1,
+      kCheckpointMarker = 3,
+
+      // The range of events making up the input of a frame (the others
+      // aren't seen by the emulation)
+      kFirstEvent = Event::ConsoleOn,
+      kLastEvent = Event::ChangeState
+    };
+
+    // Variable-length encoding of numbers and strings
+    static void putNumber(ostream& out, uInt32 value);
+    static bool getNumber(istream& in, uInt32& value);
+    static void putString(ostream& out, const string& str);
+    static bool getString(istream& in, string& str);
+
+    // Map signed numbers to unsigned ones, keeping small numbers small
+    static uInt32 zigzag(Int32 value)
+      { return (uInt32(value) << 1) ^ uInt32(value >> 31); }
+    static Int32 unzigzag(uInt32 value)
+      { return Int32(value >> 1) ^ -Int32(value & 1); }
+
+    /**
+      Answers a hash (FNV-1a) of the palette indices of the frame last
+      generated by the TIA.
+    */
+    static uInt32 frameHash(const TIA& tia);
+
+  private:      // Make sure this class is never instantiated
+    Movie() { }
+};
+
+/**
+  Records a movie, one frame at a time.
+*/
+class MovieWriter
+{
+  public:
+    MovieWriter();
+    virtual ~MovieWriter();
+
+  public:
+    /**
+      Create a movie file, replacing any existing file.  Recording starts
+      from the state of the console when the first frame is added.
+
+      @param filename     The file to create
+      @param console      The console whose input is recorded
+      @param keyInterval    The number of frames between keyframes
+      @param checkInterval  The number of frames between checkpoints
+                            (0 for none)
+
+      @return  True if the file was created
+    */
+    bool open(const string& filename, Console& console,
+              uInt32 keyInterval = 600, uInt32 checkInterval = 60);
+
+    /**
+      Record the input of the next frame; this must be called just before
+      the frame is emulated.
+
+      @param event  The events the frame will be emulated with
+
+      @return  False if the frame couldn't be written
+    */
+    bool addFrame(const Event& event);
+
+    /**
+      Finish writing the file, and close it.
+    */
+    void close();
+
+    bool isOpen() const     { return myOut.is_open(); }
+    uInt32 frames() const   { return myFrames; }
+
+  private:
+    ofstream myOut;
+    Console* myConsole;
+    uInt32 myKeyInterval;
+    uInt32 myCheckInterval;
+    uInt32 myFrames;
+
+    // The input of the previous frame
+    Int32 myValues[Event::LastType];
+
+  private:
+    // Following constructors and assignment operators not supported
+    MovieWriter(const MovieWriter&);
+    MovieWriter& operator = (const MovieWriter&);
+};
+
+/**
+  Plays a movie back, either from the start or from any keyframe.  The
+  frames generated are compared to the checkpoints met along the way.
+*/
+class MovieReader
+{
+  public:
+    MovieReader();
+    virtual ~MovieReader();
+
+  public:
+    /**
+      Open a movie for the given console, locate all of its keyframes, and
+      restore the console to the state in which recording started.
+
+      @param filename  The file to open
+      @param console   The console to play the movie on, which must use the
+                       same ROM and controllers as the one recorded
+
+      @return  True if the movie can be played on the console
+    */
+    bool open(const string& filename, Console& console);
+
+    /**
+      Close the file.
+    */
+    void close();
+
+    /**
+      Set the input of the next frame; this must be called just before the
+      frame is emulated.
+
+      @param event  The events to set to the recorded values
+
+      @return  False at the end of the movie, or if the frame is invalid
+    */
+    bool nextFrame(Event& event);
+
+    /**
+      Restore the console to the last keyframe at or before the given frame.
+      Playback then continues from that keyframe, so the frames between it
+      and the one requested must be emulated to reach the latter.
+
+      @param frame  The frame number, starting at 0
+
+      @return  The number of the frame played next, or -1 if there's no
+               such frame or the keyframe can't be restored
+    */
+    Int32 seek(uInt32 frame);
+
+    bool isOpen() const     { return myIn.is_open(); }
+    uInt32 frames() const   { return myFrames; }
+
+    /**
+      Answers the number of the next frame to be played.
+    */
+    uInt32 position() const { return myPosition; }
+
+    /**
+      Answers the number of checkpoints compared since the movie was
+      opened, and how many of them didn't match the frame generated.
+    */
+    uInt32 checkpoints() const { return myCheckpoints; }
+    uInt32 mismatches() const  { return myMismatches; }
+
+    /**
+      Answers the number of the first frame which didn't match its
+      checkpoint, or -1 if there was none.
+    */
+    Int32 firstMismatch() const { return myFirstMismatch; }
+
+  private:
+    // Read the keyframe at the current position; the state is restored
+    // only if 'restore' is set
+    bool readKeyFrame(bool restore);
+
+    // Read the checkpoint at the current position, and compare it to the
+    // frame last generated
+    bool readCheckpoint();
+
+  private:
+    // The location of each keyframe in the file
+    struct KeyFrame {
+      uInt32 frame;
+      streamoff offset;
+    };
+
+    ifstream myIn;
+    Console* myConsole;
+    vector<KeyFrame> myKeyFrames;
+    uInt32 myFrames;
+
+    // The next frame to play
+    uInt32 myPosition;
+
+    // The results of comparing the checkpoints
+    uInt32 myCheckpoints;
+    uInt32 myMismatches;
+    Int32 myFirstMismatch;
+
+    // The input of the previous frame
+    Int32 myValues[Event::LastType];
+
+  private:
+    // Following constructors and assignment operators not supported
+    MovieReader(const MovieReader&);
+    MovieReader& operator = (const MovieReader&);
+};
+
+#endif
@@ -266,7 +266,9 @@ bool OSystem::create()
   Random::setSystem(this);
 
   // Create PNG handler
-  myPNGLib = new PNGLibrary();
+  myPNGLib = new PNGLibrary(mySettings->getInt("ssthreads"),
+                            mySettings->getInt("ssqueue"));
+  myPNGLib->setCompressionLevel(mySettings->getInt("sslevel"));
 
   // Create ZIP handler
   myZipHandler = new ZipHandler();
@@ -20,6 +20,7 @@
 #include <cassert>
 
 #include "Event.hxx"
+#include "FrameInput.hxx"
 #include "Paddles.hxx"
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -370,6 +371,28 @@ void Paddles::update()
       myCharge[myAxisDigitalOne] += myPaddleRepeat1;
   }
 
+  updateAnalogPins();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Paddles::applyInput(const FrameInput& input)
+{
+  // Paddles 0 and 1 are plugged into the left jack, 2 and 3 the right one
+  uInt32 first = myJack == Left ? 0 : 2;
+
+  myDigitalPinState[Four]  = !(input.paddleFire & (1 << first));
+  myDigitalPinState[Three] = !(input.paddleFire & (2 << first));
+
+  myCharge[0] = TRIGMIN + input.paddle[first] * (TRIGMAX - TRIGMIN) / 65535;
+  myCharge[1] = TRIGMIN + input.paddle[first+1] * (TRIGMAX - TRIGMIN) / 65535;
+  updateAnalogPins();
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Paddles::updateAnalogPins()
+{
   // Only change state if the charge has actually changed
   if(myCharge[1] != myLastCharge[1])
     myAnalogPinValue[Five] =
@@ -61,6 +61,13 @@ class Paddles : public Controller
     */
     void update();
 
+    /**
+      Update the entire digital and analog pin state according to the
+      given frame input.  The paddles are moved straight to the positions
+      given, ignoring the sensitivity and the 'swap' settings.
+    */
+    bool applyInput(const FrameInput& input);
+
     /**
       Determines how this controller will treat values received from the
       X/Y axis and left/right buttons of the mouse.  Since not all controllers
@@ -100,6 +107,10 @@ class Paddles : public Controller
     */
     static void setMouseSensitivity(int sensitivity);
 
+  private:
+    // Set the analog pins from the charges, if they've changed
+    void updateAnalogPins();
+
   private:
     // Range of values over which digital and mouse movement is scaled
     // to paddle resistance
@@ -54,6 +54,13 @@ class Random
     */
     uInt32 next();
 
+    /**
+      Get/set the state of the generator, so that the same sequence of
+      numbers can be generated again (see ConsoleSnapshot).
+    */
+    uInt32 state() const        { return myValue; }
+    void setState(uInt32 value) { myValue = value; }
+
     /**
       Class method which sets the OSystem in use; the constructor will
       use this to reseed the random number generator every time a new
@@ -0,0 +1,146 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2014 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//
+// $Id$
+//============================================================================
+
+#include <iomanip>
+#include <sstream>
+
+#include "OSystem.hxx"
+#include "Console.hxx"
+#include "Control.hxx"
+#include "EventHandler.hxx"
+#include "Movie.hxx"
+#include "Props.hxx"
+#include "Sound.hxx"
+#include "Switches.hxx"
+#include "TIA.hxx"
+
+#include "Replay.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Replay::Replay(OSystem* osystem)
+  : myOSystem(osystem),
+    myWriter(1, 4),
+    mySnapshotInterval(0)
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+Replay::~Replay()
+{
+  myWriter.flush();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Replay::setSnapshots(const string& prefix, uInt32 interval)
+{
+  mySnapshotPrefix = prefix;
+  mySnapshotInterval = interval;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Replay::run(const string& filename, Stats& stats,
+                 uInt32 first, uInt32 count)
+{
+  memset(&stats, 0, sizeof(stats));
+  stats.firstMismatch = -1;
+
+  Console& console = myOSystem->console();
+  MovieReader movie;
+  if(!movie.open(filename, console))
+    return false;
+
+  Int32 start = movie.seek(first);
+  if(start < 0)
+    return false;
+
+  uInt32 last = movie.frames();
+  if(count > 0 && first + count < last)
+    last = first + count;
+
+  // Sound register writes would otherwise pile up, with nothing to play them
+  myOSystem->sound().close();
+
+  Event& event = myOSystem->eventHandler().event();
+  Controller& left = console.controller(Controller::Left);
+  Controller& right = console.controller(Controller::Right);
+  Switches& switches = console.switches();
+  TIA& tia = console.tia();
+
+  uInt64 startTime = myOSystem->getTicks();
+  for(uInt32 frame = start; frame < last && movie.nextFrame(event); ++frame)
+  {
+    left.update();
+    right.update();
+    switches.update();
+    tia.update();
+    ++stats.frames;
+
+    if(mySnapshotInterval > 0 && frame >= first &&
+       (frame - first) % mySnapshotInterval == 0)
+    {
+      if(saveSnapshot(frame))
+        ++stats.snapshots;
+    }
+  }
+  stats.time = myOSystem->getTicks() - startTime;
+
+  stats.checkpoints = movie.checkpoints();
+  stats.mismatches = movie.mismatches();
+  stats.firstMismatch = movie.firstMismatch();
+
+  // The events keep the input of the last frame played
+  event.clear();
+  console.initializeAudio();
+
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool Replay::saveSnapshot(uInt32 frame)
+{
+  const TIA& tia = myOSystem->console().tia();
+  const uInt32* palette = myOSystem->console().currentPalette();
+  if(palette == 0)
+    return false;
+
+  uInt32 width = tia.width(), height = tia.height();
+
+  Common::PNGWriter::Image* png = myWriter.getImage(width << 1, height);
+  const uInt8* src = tia.currentFrameBuffer();
+  for(uInt32 y = 0; y < height; ++y)
+  {
+    uInt8* dst = png->row(y);
+    for(uInt32 x = 0; x < width; ++x)
+    {
+      uInt32 pixel = palette[*src++];
+      uInt8 r = (pixel >> 16) & 0xff, g = (pixel >> 8) & 0xff, b = pixel & 0xff;
+      *dst++ = r;  *dst++ = g;  *dst++ = b;
+      *dst++ = r;  *dst++ = g;  *dst++ = b;
+    }
+  }
+
+  ostringstream number;
+  number << setw(6) << setfill('0') << frame;
+  png->addText("ROM Name",
+               myOSystem->console().properties().get(Cartridge_Name));
+  png->addText("Frame", number.str());
+  myWriter.queue(png, mySnapshotPrefix + "_" + number.str() + ".png");
+
+  return true;
+}
@@ -0,0 +1,105 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2014 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//
+// $Id$
+//============================================================================
+
+#ifndef REPLAY_HXX
+#define REPLAY_HXX
+
+class OSystem;
+
+#include "bspf.hxx"
+#include "PNGWriter.hxx"
+
+/**
+  Plays an input movie (see Movie) back as fast as the host allows, to
+  check that emulation still generates the frames which were recorded,
+  and to measure how fast it runs.
+
+  Nothing is done with the frames apart from comparing them to the
+  checkpoints of the movie: sound is disabled, and the palette indices
+  generated by the TIA are never converted to pixels, except for the
+  frames chosen to be saved as snapshots.
+*/
+class Replay
+{
+  public:
+    /**
+      The results of playing a movie.
+    */
+    struct Stats {
+      uInt32 frames;        // Frames emulated
+      uInt32 snapshots;     // Frames saved as snapshots
+      uInt32 checkpoints;   // Checkpoints compared
+      uInt32 mismatches;    // Checkpoints which didn't match their frame
+      Int32 firstMismatch;  // The first frame which didn't match, or -1
+      uInt64 time;          // Time spent emulating, in microseconds
+    };
+
+  public:
+    /**
+      Create a replay for the console of the given OSystem.
+    */
+    Replay(OSystem* osystem);
+
+    /**
+      Destructor; waits for all snapshots to be written.
+    */
+    virtual ~Replay();
+
+  public:
+    /**
+      Save every so many frames as a PNG file, named from the given prefix
+      and the frame number.
+
+      @param prefix    The start of the filenames (ie, a path and ROM name)
+      @param interval  The number of frames between snapshots (0 for none)
+    */
+    void setSnapshots(const string& prefix, uInt32 interval);
+
+    /**
+      Play (part of) a movie on the current console.  Playback starts from
+      the last keyframe at or before the first frame.
+
+      @param filename  The movie to play
+      @param stats     Receives the results
+      @param first     The first frame to play
+      @param count     The number of frames to play (0 for all)
+
+      @return  False if the movie can't be played on this console
+    */
+    bool run(const string& filename, Stats& stats,
+             uInt32 first = 0, uInt32 count = 0);
+
+  private:
+    // Queue the frame last generated by the TIA to be saved
+    bool saveSnapshot(uInt32 frame);
+
+  private:
+    OSystem* myOSystem;
+
+    Common::PNGWriter myWriter;
+    string mySnapshotPrefix;
+    uInt32 mySnapshotInterval;
+
+  private:
+    // Following constructors and assignment operators not supported
+    Replay(const Replay&);
+    Replay& operator = (const Replay&);
+};
+
+#endif
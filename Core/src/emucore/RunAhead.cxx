@@ -0,0 +1,91 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2014 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//
+// $Id$
+//============================================================================
+
+#include "Console.hxx"
+#include "Random.hxx"
+#include "System.hxx"
+#include "TIA.hxx"
+
+#include "RunAhead.hxx"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+RunAhead::RunAhead(Console& console)
+  : myConsole(console),
+    myFrames(0),
+    myRandomState(0),
+    myUsesSnapshots(true)
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+RunAhead::~RunAhead()
+{
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RunAhead::setFrames(uInt32 frames)
+{
+  myFrames = BSPF_min(frames, (uInt32)kMaxFrames);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void RunAhead::update()
+{
+  TIA& tia = myConsole.tia();
+  if(myFrames == 0)
+  {
+    tia.update();
+    return;
+  }
+
+  // The real frame, which is heard but never seen
+  bool video = tia.isVideoEnabled(), sound = tia.isSoundEnabled();
+  tia.enableVideo(false);
+  tia.update();
+
+  myUsesSnapshots = myConsole.saveSnapshot(mySnapshot);
+  if(!myUsesSnapshots)
+  {
+    myState.reset();
+    myConsole.save(myState);
+    myRandomState = myConsole.system().randGenerator().state();
+  }
+
+  // The frames ahead, of which only the last one is seen (and none heard)
+  tia.enableSound(false);
+  for(uInt32 frame = 1; frame <= myFrames; ++frame)
+  {
+    tia.enableVideo(video && frame == myFrames);
+    tia.update();
+  }
+  tia.enableVideo(video);
+
+  // The sound is still disabled while the state is restored, so that
+  // loading a Serializer leaves it alone (along with the register writes
+  // of the real frame, which are still queued)
+  if(myUsesSnapshots)
+    myConsole.loadSnapshot(mySnapshot);
+  else
+  {
+    myState.reset();
+    myConsole.load(myState);
+    myConsole.system().randGenerator().setState(myRandomState);
+  }
+  tia.enableSound(sound);
+}
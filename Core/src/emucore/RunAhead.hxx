@@ -0,0 +1,106 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2014 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//
+// $Id$
+//============================================================================
+
+#ifndef RUN_AHEAD_HXX
+#define RUN_AHEAD_HXX
+
+class Console;
+
+#include "bspf.hxx"
+#include "ConsoleSnapshot.hxx"
+#include "Serializer.hxx"
+
+/**
+  Hides the input latency of a game by running a few frames ahead of the
+  one emulated for real.  Most games only react to the input a frame or
+  two after reading it, so the frame shown when a button is pressed still
+  looks as if it wasn't.  Running ahead shows instead the frame which
+  would be generated some frames later, were the input to stay as it is.
+
+  Each host frame, the real frame is emulated (with its sound, but without
+  generating its picture), the state of the console is saved, the frames
+  ahead are emulated with the same input (without sound, and generating
+  only the picture of the last one), and the state is restored.  So the
+  emulation itself goes on exactly as without running ahead, only the
+  frame shown differs.  The TIA's ring of frame buffers moves on once per
+  host frame, as usual, so the dirty lines and frameBuffer(1) still refer
+  to the previous frame shown.
+
+  The state is saved as a ConsoleSnapshot, which costs a few microseconds;
+  for the bankswitching schemes which don't support snapshots, it's saved
+  with a Serializer instead (along with the state of the random number
+  generator, which a Serializer doesn't hold), which is slower.
+*/
+class RunAhead
+{
+  public:
+    enum {
+      kMaxFrames = 8
+    };
+
+  public:
+    /**
+      Create a run-ahead for the given console, initially disabled.
+    */
+    RunAhead(Console& console);
+
+    /**
+      Destructor
+    */
+    virtual ~RunAhead();
+
+  public:
+    /**
+      Set the number of frames to run ahead.
+
+      @param frames  From 0 (disabled) to kMaxFrames
+    */
+    void setFrames(uInt32 frames);
+    uInt32 frames() const { return myFrames; }
+
+    /**
+      Emulate the next frame, and generate the frame which would follow it
+      'frames()' later (or only the next frame, if disabled).  This replaces
+      TIA::update(), and the input of the frame must be set beforehand.
+    */
+    void update();
+
+    /**
+      Answers whether the state was last saved as a snapshot, rather than
+      with a Serializer.
+    */
+    bool usesSnapshots() const { return myUsesSnapshots; }
+
+  private:
+    Console& myConsole;
+    uInt32 myFrames;
+
+    // The state saved after the real frame
+    ConsoleSnapshot mySnapshot;
+    Serializer myState;
+    uInt32 myRandomState;
+    bool myUsesSnapshots;
+
+  private:
+    // Following constructors and assignment operators not supported
+    RunAhead(const RunAhead&);
+    RunAhead& operator = (const RunAhead&);
+};
+
+#endif
@@ -112,6 +112,22 @@ void Serializer::reset(void)
   myStream->seekp(ios_base::beg);
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string Serializer::data(void) const
+{
+  return myUseFilestream ? "" : ((stringstream*)myStream)->str();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void Serializer::setData(const string& data)
+{
+  if(!myUseFilestream)
+  {
+    ((stringstream*)myStream)->str(data);
+    reset();
+  }
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt8 Serializer::getByte(void)
 {
@@ -73,6 +73,18 @@ class Serializer
     */
     void reset(void);
 
+    /**
+      Answers everything written to an in-memory stream (for a file
+      stream, this is always empty).
+    */
+    string data(void) const;
+
+    /**
+      Replaces the contents of an in-memory stream with the given data,
+      and resets the read/write location to its beginning.
+    */
+    void setData(const string& data);
+
     /**
       Reads a byte value (unsigned 8-bit) from the current input stream.
 
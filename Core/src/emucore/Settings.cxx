@@ -64,6 +64,9 @@ Settings::Settings(OSystem* osystem)
   setInternal("tv_filter", "0");
   setInternal("tv_scanlines", "25");
   setInternal("tv_scaninter", "true");
+  setInternal("tv_threads", "0");
+  setInternal("tv_cachefile", "");
+  setInternal("tv_phosphor", "peak");
   // TV options when using 'custom' mode
   setInternal("tv_contrast", "0.0");
   setInternal("tv_brightness", "0.0");
@@ -101,6 +104,9 @@ Settings::Settings(OSystem* osystem)
   setInternal("sssingle", "false");
   setInternal("ss1x", "false");
   setInternal("ssinterval", "2");
+  setInternal("sslevel", "6");
+  setInternal("ssthreads", "1");
+  setInternal("ssqueue", "8");
 
   // Config files and paths
   setInternal("romdir", "");
@@ -131,11 +137,15 @@ Settings::Settings(OSystem* osystem)
   setInternal("loglevel", "1");
   setInternal("logtoconsole", "0");
   setInternal("tiadriven", "false");
+  setInternal("tiabuffers", "2");
+  setInternal("runahead", "0");
   setInternal("cpurandom", "true");
   setInternal("ramrandom", "true");
   setInternal("avoxport", "");
   setInternal("stats", "false");
   setInternal("fastscbios", "false");
+  setInternal("fastscload", "false");
+  setInternal("autodetectframes", "5");
   setExternal("romloadcount", "0");
   setExternal("maxres", "");
 
@@ -285,6 +295,8 @@ void Settings::validate()
 
   i = getInt("tv_filter");
   if(i < 0 || i > 5)  setInternal("tv_filter", "0");
+  i = getInt("tv_threads");
+  if(i < 0 || i > 16)  setInternal("tv_threads", "0");
 
 #endif
 
@@ -314,11 +326,26 @@ void Settings::validate()
   i = getInt("ssinterval");
   if(i < 1)        setInternal("ssinterval", "2");
   else if(i > 10)  setInternal("ssinterval", "10");
+  i = getInt("sslevel");
+  if(i < 0 || i > 9)  setInternal("sslevel", "6");
+  i = getInt("ssthreads");
+  if(i < 0 || i > 8)  setInternal("ssthreads", "1");
+  i = getInt("ssqueue");
+  if(i < 1 || i > 64)  setInternal("ssqueue", "8");
+
+  i = getInt("tiabuffers");
+  if(i < 2 || i > 16)  setInternal("tiabuffers", "2");
+  i = getInt("runahead");
+  if(i < 0 || i > 8)  setInternal("runahead", "0");
 
   s = getString("palette");
   if(s != "standard" && s != "z26" && s != "user")
     setInternal("palette", "standard");
 
+  s = getString("tv_phosphor");
+  if(s != "peak" && s != "average")
+    setInternal("tv_phosphor", "peak");
+
   s = getString("launcherfont");
   if(s != "small" && s != "medium" && s != "large")
     setInternal("launcherfont", "medium");
@@ -360,6 +387,9 @@ void Settings::validate()
 //    << "  -tv_filter    <0-5>          Set TV effects off (0) or to specified mode (1-5)\n"
 //    << "  -tv_scanlines <0-100>        Set scanline intensity to percentage (0 disables completely)\n"
 //    << "  -tv_scaninter <1|0>          Enable interpolated (smooth) scanlines\n"
+//    << "  -tv_threads   <0-16>         Use extra threads for TV effects (0 disables)\n"
+//    << "  -tv_cachefile <file>         Full pathname of file to keep TV effects data in\n"
+//    << "  -tv_phosphor  <peak|average> Fade all earlier frames, or average with the last one, for phosphor\n"
 //    << "  -tv_contrast    <value>      Set TV effects custom contrast to value 1.0 - 1.0\n"
 //    << "  -tv_brightness  <value>      Set TV effects custom brightness to value 1.0 - 1.0\n"
 //    << "  -tv_hue         <value>      Set TV effects custom hue to value 1.0 - 1.0\n"
@@ -407,12 +437,16 @@ void Settings::validate()
 //    << "  -autoslot     <1|0>          Automatically switch to next save slot when state saving\n"
 //    << "  -stats        <1|0>          Overlay console info during emulation\n"
 //    << "  -fastscbios   <1|0>          Disable Supercharger BIOS progress loading bars\n"
+//    << "  -fastscload   <1|0>          Start Supercharger loads without running the BIOS\n"
 //    << "  -snapsavedir  <path>         The directory to save snapshot files to\n"
 //    << "  -snaploaddir  <path>         The directory to load snapshot files from\n"
 //    << "  -snapname     <int|rom>      Name snapshots according to internal database or ROM\n"
 //    << "  -sssingle     <1|0>          Generate single snapshot instead of many\n"
 //    << "  -ss1x         <1|0>          Generate TIA snapshot in 1x mode (ignore scaling/effects)\n"
 //    << "  -ssinterval   <number        Number of seconds between snapshots in continuous snapshot mode\n"
+//    << "  -sslevel      <0-9>          Compression level for snapshots (9 is smallest)\n"
+//    << "  -ssthreads    <0-8>          Number of threads writing continuous snapshots\n"
+//    << "  -ssqueue      <1-64>         Number of continuous snapshots which may wait to be written\n"
 //    << endl
 //    << "  -rominfo      <rom>          Display detailed information for the given ROM\n"
 //    << "  -listrominfo                 Display contents of stella.pro, one line per ROM entry\n"
@@ -440,6 +474,8 @@ void Settings::validate()
 //    << "  -holdjoy0     <U,D,L,R,F>    Start the emulator with the left joystick direction/fire button held down\n"
 //    << "  -holdjoy1     <U,D,L,R,F>    Start the emulator with the right joystick direction/fire button held down\n"
 //    << "  -tiadriven    <1|0>          Drive unused TIA pins randomly on a read/peek\n"
+//    << "  -tiabuffers   <2-16>         Number of recent frames kept by the TIA\n"
+//    << "  -runahead     <0-8>          Number of frames to run ahead, to hide input latency\n"
 //    << "  -cpurandom    <1|0>          Randomize the contents of CPU registers on reset\n"
 //    << "  -ramrandom    <1|0>          Randomize the contents of RAM on reset\n"
 //    << "  -help                        Show the text you're now reading\n"
@@ -24,13 +24,14 @@
 #include "Console.hxx"
 #include "Cart.hxx"
 #include "Control.hxx"
+#include "EventHandler.hxx"
 #include "Switches.hxx"
 #include "System.hxx"
 #include "Serializable.hxx"
 
 #include "StateManager.hxx"
 
-#define STATE_HEADER "03090100state"
+#define STATE_HEADER "03090101state"
 #define MOVIE_HEADER "03030000movie"
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -56,32 +57,15 @@ bool StateManager::isActive()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool StateManager::toggleRecordMode()
 {
-#if 0
   if(myActiveMode != kMovieRecordMode)  // Turn on movie record mode
   {
-    myActiveMode = kOffMode;
-
-    string moviefile = /*myOSystem->baseDir() +*/ "test.inp";
-    if(myMovieWriter.isOpen())
-      myMovieWriter.close();
-    if(!myMovieWriter.open(moviefile))
-      return false;
+    reset();
 
-    // Prepend the ROM md5 so this state file only works with that ROM
-    myMovieWriter.putString(myOSystem->console().properties().get(Cartridge_MD5));
-
-    if(!myOSystem->console().save(myMovieWriter))
+    // The movie starts with the current state, and the ROM md5 and
+    // controller types, so that it only plays back with the same ROM
+    if(!myMovieWriter.open(movieFile(), myOSystem->console()))
       return false;
 
-    // Save controller types for this ROM
-    // We need to check this, since some controllers save more state than
-    // normal, and those states files wouldn't be compatible with normal
-    // controllers.
-    myMovieWriter.putString(
-      myOSystem->console().controller(Controller::Left).name());
-    myMovieWriter.putString(
-      myOSystem->console().controller(Controller::Right).name());
-
     // If we get this far, we're really in movie record mode
     myActiveMode = kMovieRecordMode;
   }
@@ -93,45 +77,22 @@ bool StateManager::toggleRecordMode()
   }
 
   return myActiveMode == kMovieRecordMode;
-#endif
-  return false;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool StateManager::toggleRewindMode()
 {
   // FIXME - For now, I'm going to use this to activate movie playback
-#if 0
-  // Close the writer, since we're about to re-open in read mode
-  myMovieWriter.close();
-
   if(myActiveMode != kMoviePlaybackMode)  // Turn on movie playback mode
   {
-    myActiveMode = kOffMode;
-
-    string moviefile = /*myOSystem->baseDir() + */ "test.inp";
-    if(myMovieReader.isOpen())
-      myMovieReader.close();
-    if(!myMovieReader.open(moviefile))
-      return false;
+    reset();
 
-    // Check the ROM md5
-    if(myMovieReader.getString() !=
-       myOSystem->console().properties().get(Cartridge_MD5))
+    // This also checks the ROM md5 and controller types, and restores
+    // the state at which recording started
+    if(!myMovieReader.open(movieFile(), myOSystem->console()))
       return false;
 
-    if(!myOSystem->console().load(myMovieReader))
-      return false;
-
-    // Check controller types
-    const string& left  = myMovieReader.getString();
-    const string& right = myMovieReader.getString();
-
-    if(left != myOSystem->console().controller(Controller::Left).name() ||
-       right != myOSystem->console().controller(Controller::Right).name())
-      return false;
-
-    // If we get this far, we're really in movie record mode
+    // If we get this far, we're really in movie playback mode
     myActiveMode = kMoviePlaybackMode;
   }
   else  // Turn off movie playback mode
@@ -142,32 +103,35 @@ bool StateManager::toggleRewindMode()
   }
 
   return myActiveMode == kMoviePlaybackMode;
-#endif
-  return false;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void StateManager::update()
 {
-#if 0
+  Event& event = myOSystem->eventHandler().event();
+
   switch(myActiveMode)
   {
     case kMovieRecordMode:
-      myOSystem->console().controller(Controller::Left).save(myMovieWriter);
-      myOSystem->console().controller(Controller::Right).save(myMovieWriter);
-      myOSystem->console().switches().save(myMovieWriter);
+      if(!myMovieWriter.addFrame(event))
+      {
+        myActiveMode = kOffMode;
+        myMovieWriter.close();
+      }
       break;
 
     case kMoviePlaybackMode:
-      myOSystem->console().controller(Controller::Left).load(myMovieReader);
-      myOSystem->console().controller(Controller::Right).load(myMovieReader);
-      myOSystem->console().switches().load(myMovieReader);
+      // Playback stops at the end of the movie
+      if(!myMovieReader.nextFrame(event))
+      {
+        myActiveMode = kOffMode;
+        myMovieReader.close();
+      }
       break;
 
     default:
       break;
   }
-#endif
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -323,9 +287,6 @@ bool StateManager::saveState(Serializer& out)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void StateManager::reset()
 {
-#if 0
-  myCurrentSlot = 0;
-
   switch(myActiveMode)
   {
     case kMovieRecordMode:
@@ -340,7 +301,13 @@ void StateManager::reset()
       break;
   }
   myActiveMode = kOffMode;
-#endif
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+string StateManager::movieFile() const
+{
+  return myOSystem->stateDir() +
+         myOSystem->console().properties().get(Cartridge_Name) + ".inp";
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
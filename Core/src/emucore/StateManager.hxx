@@ -22,6 +22,7 @@
 
 class OSystem;
 
+#include "Movie.hxx"
 #include "Serializer.hxx"
 
 /**
@@ -51,7 +52,20 @@ class StateManager
     */
     bool isActive();
 
+    /**
+      Start or stop recording a movie of the input given to the console
+      (see Movie), into the file named after the ROM in the state directory.
+
+      @return  True if recording has started
+    */
     bool toggleRecordMode();
+
+    /**
+      Start or stop playing the movie recorded by toggleRecordMode().
+      For now, this takes the place of rewind mode.
+
+      @return  True if playback has started
+    */
     bool toggleRewindMode();
 
     /**
@@ -103,6 +117,10 @@ class StateManager
     */
     void reset();
 
+  private:
+    // The file movies are recorded into and played from
+    string movieFile() const;
+
   private:
     // Copy constructor isn't supported by this class so make it private
     StateManager(const StateManager&);
@@ -135,9 +153,9 @@ class StateManager
     // MD5 of the currently active ROM (either in movie or rewind mode)
     string myMD5;
 
-    // Serializer classes used to save/load the eventstream
-    Serializer myMovieWriter;
-    Serializer myMovieReader;
+    // Used to record/play back the eventstream
+    MovieWriter myMovieWriter;
+    MovieReader myMovieReader;
 };
 
 #endif
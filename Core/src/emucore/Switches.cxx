@@ -18,6 +18,7 @@
 //============================================================================
 
 #include "Event.hxx"
+#include "FrameInput.hxx"
 #include "Props.hxx"
 #include "Switches.hxx"
 
@@ -108,6 +109,29 @@ void Switches::update()
   }
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+void Switches::applyInput(const FrameInput& input)
+{
+  // The unused bits keep their value, and the buttons are active low
+  uInt8 bits = input.switches;
+  mySwitches = (mySwitches & 0x34) |
+               ((bits & FrameInput::kReset)      ? 0x00 : 0x01) |
+               ((bits & FrameInput::kSelect)     ? 0x00 : 0x02) |
+               ((bits & FrameInput::kColor)      ? 0x08 : 0x00) |
+               ((bits & FrameInput::kLeftDiffA)  ? 0x40 : 0x00) |
+               ((bits & FrameInput::kRightDiffA) ? 0x80 : 0x00);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
+uInt8 Switches::positions() const
+{
+  return ((mySwitches & 0x01) ? 0 : FrameInput::kReset) |
+         ((mySwitches & 0x02) ? 0 : FrameInput::kSelect) |
+         ((mySwitches & 0x08) ? FrameInput::kColor : 0) |
+         ((mySwitches & 0x40) ? FrameInput::kLeftDiffA : 0) |
+         ((mySwitches & 0x80) ? FrameInput::kRightDiffA : 0);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - 
 bool Switches::save(Serializer& out) const
 {
@@ -22,6 +22,7 @@
 
 class Event;
 class Properties;
+struct FrameInput;
 
 #include "Serializable.hxx"
 #include "bspf.hxx"
@@ -66,6 +67,20 @@ class Switches : public Serializable
     */
     void update();
 
+    /**
+      Set the switches to the positions given by a frame input (see
+      FrameInput), rather than according to the events.
+
+      @param input  The input of the next frame
+    */
+    void applyInput(const FrameInput& input);
+
+    /**
+      Answers the current positions of the switches, as FrameInput
+      switch bits (ie, to carry them over to the next frame input).
+    */
+    uInt8 positions() const;
+
     /**
       Save the current state of the switches to the given Serializer.
 
@@ -82,6 +97,13 @@ class Switches : public Serializable
     */
     bool load(Serializer& in);
 
+    /**
+      Copy the current state of the switches to/from a snapshot (see
+      ConsoleSnapshot); it's the value returned by read().
+    */
+    void saveSnapshot(uInt8& s) const { s = mySwitches; }
+    void loadSnapshot(uInt8 s)        { mySwitches = s; }
+
     /**
       Get a descriptor for the device name (used in error checking).
 
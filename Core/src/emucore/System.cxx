@@ -18,6 +18,7 @@
 //============================================================================
 
 #include <cassert>
+#include <cstring>
 #include <iostream>
 
 #include "Device.hxx"
@@ -46,9 +47,10 @@ System::System(uInt16 n, uInt16 m)
   // Create a new random number generator
   myRandom = new Random();
 
-  // Allocate page table and dirty list
+  // Allocate page table, dirty list and write counts
   myPageAccessTable = new PageAccess[myNumberOfPages];
   myPageIsDirtyTable = new bool[myNumberOfPages];
+  myPageWriteCount = new uInt32[myNumberOfPages];
 
   // Initialize page access table
   PageAccess access;
@@ -59,6 +61,7 @@ System::System(uInt16 n, uInt16 m)
   {
     setPageAccess(page, access);
     myPageIsDirtyTable[page] = false;
+    myPageWriteCount[page] = 0;
   }
 
   // Bus starts out unlocked (in other words, peek() changes myDataBusState)
@@ -77,9 +80,10 @@ System::~System()
   // Free the M6502 that I own
   delete myM6502;
 
-  // Free my page access table and dirty list
+  // Free my page access table, dirty list and write counts
   delete[] myPageAccessTable;
   delete[] myPageIsDirtyTable;
+  delete[] myPageWriteCount;
 
   // Free the random number generator
   delete myRandom;
@@ -170,6 +174,15 @@ void System::setPageAccess(uInt16 page, const PageAccess& access)
   myPageAccessTable[page] = access;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void System::setPageAccess(uInt16 page, const PageAccess* access, uInt16 count)
+{
+  // Make sure the pages are within range
+  assert(page + count <= myNumberOfPages);
+
+  memcpy(myPageAccessTable + page, access, count * sizeof(PageAccess));
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 const System::PageAccess& System::getPageAccess(uInt16 page) const
 {
@@ -211,6 +224,22 @@ void System::clearDirtyPages()
     myPageIsDirtyTable[i] = false;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void System::clearDirtyPages(uInt16 start_addr, uInt16 end_addr)
+{
+  uInt16 start_page = (start_addr & myAddressMask) >> myPageShift;
+  uInt16 end_page = (end_addr & myAddressMask) >> myPageShift;
+
+  for(uInt16 page = start_page; page <= end_page; ++page)
+    myPageIsDirtyTable[page] = false;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 System::pageWriteCount(uInt16 addr) const
+{
+  return myPageWriteCount[(addr & myAddressMask) >> myPageShift];
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 uInt8 System::peek(uInt16 addr, uInt8 flags)
 {
@@ -251,6 +280,7 @@ void System::poke(uInt16 addr, uInt8 value)
     // Since we have direct access to this poke, we can dirty its page
     *(access.directPokeBase + (addr & myPageMask)) = value;
     myPageIsDirtyTable[page] = true;
+    ++myPageWriteCount[page];
   }
   else
   {
@@ -359,6 +389,22 @@ bool System::load(Serializer& in)
   return true;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void System::saveSnapshot(Snapshot& s) const
+{
+  s.cycles = myCycles;
+  s.dataBusState = myDataBusState;
+  s.random = myRandom->state();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void System::loadSnapshot(const Snapshot& s)
+{
+  myCycles = s.cycles;
+  myDataBusState = s.dataBusState;
+  myRandom->setState(s.random);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 System::System(const System& s)
   : myAddressMask(s.myAddressMask),
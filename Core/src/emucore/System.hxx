@@ -198,6 +198,12 @@ class System : public Serializable
     */
     bool autodetectMode() const { return mySystemInAutodetect; }
 
+    /**
+      Leave device autodetect mode without resetting the system.  This is
+      used when the pre-autodetect state has been restored from a snapshot.
+    */
+    void endAutodetectMode() { mySystemInAutodetect = false; }
+
   public:
     /**
       Get the current state of the data bus in the system.  The current
@@ -354,6 +360,18 @@ class System : public Serializable
     */
     void setPageAccess(uInt16 page, const PageAccess& access);
 
+    /**
+      Set the page accessing methods for a contiguous range of pages
+      with a single block copy.  This is used by cartridges which
+      precompute the pages for each of their banks, so that a
+      bankswitch doesn't need to rebuild every page.
+
+      @param page   The first page accessing methods should be set for
+      @param access Array of accessing methods, one for each page
+      @param count  The number of pages to set
+    */
+    void setPageAccess(uInt16 page, const PageAccess* access, uInt16 count);
+
     /**
       Get the page accessing method for the specified page.
 
@@ -391,6 +409,25 @@ class System : public Serializable
     */
     void clearDirtyPages();
 
+    /**
+      Mark the pages of the given address range as clean.
+
+      @param start_addr The start address; determines the start page
+      @param end_addr   The end address; determines the end page
+    */
+    void clearDirtyPages(uInt16 start_addr, uInt16 end_addr);
+
+    /**
+      Answer how many times the page containing this address has been
+      written through its 'directPokeBase'.  Unlike the dirty flags,
+      the count is never cleared, so any number of users can each tell
+      whether the page was written since they last looked.
+
+      @param addr  Determines the page in question
+      @return  The number of direct writes, modulo 2^32
+    */
+    uInt32 pageWriteCount(uInt16 addr) const;
+
     /**
       Save the current state of this system to the given Serializer.
 
@@ -407,6 +444,24 @@ class System : public Serializable
     */
     bool load(Serializer& in);
 
+    /**
+      The state of the system itself saved by save() (not including the
+      CPU and devices), as plain data (see ConsoleSnapshot).  This also
+      holds the state of the random number generator, which decides the
+      value of the undriven bits of the data bus.
+    */
+    struct Snapshot {
+      uInt32 cycles;
+      uInt8 dataBusState;
+      uInt32 random;
+    };
+
+    /**
+      Copy the state of the system itself to/from the given snapshot.
+    */
+    void saveSnapshot(Snapshot& s) const;
+    void loadSnapshot(const Snapshot& s);
+
     /**
       Get a descriptor for the device name (used in error checking).
 
@@ -433,6 +488,9 @@ class System : public Serializable
     // Pointer to a dynamically allocated array for dirty pages
     bool* myPageIsDirtyTable;
 
+    // Pointer to a dynamically allocated array of direct write counts
+    uInt32* myPageWriteCount;
+
     // Array of all the devices attached to the system
     Device* myDevices[100];
 
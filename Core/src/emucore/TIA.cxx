@@ -54,15 +54,22 @@ TIA::TIA(Console& console, Sound& sound, Settings& settings)
     myColorLossEnabled(false),
     myPartialFrameFlag(false),
     myAutoFrameEnabled(false),
+    myVideoEnabled(true),
+    mySoundEnabled(true),
     myFrameCounter(0),
     myPALFrameCounter(0),
     myBitsEnabled(true),
     myCollisionsEnabled(true)
    
 {
-  // Allocate buffers for two frame buffers
-  myCurrentFrameBuffer = new uInt8[160 * 320];
-  myPreviousFrameBuffer = new uInt8[160 * 320];
+  // Allocate the frame buffers; they're resized by frameReset() once the
+  // size of the frame is known
+  memset(myFrameBuffers, 0, sizeof(myFrameBuffers));
+  myNumFrameBuffers = BSPF_clamp(mySettings.getInt("tiabuffers"),
+                                 2, (int)kMaxFrameBuffers);
+  allocateBuffers();
+  memset(myDirtyLines, 0, sizeof(myDirtyLines));
+  myDirtyCheckLine = 0;
 
   // Make sure all TIA bits are enabled
   enableBits(true);
@@ -83,13 +90,16 @@ TIA::TIA(Console& console, Sound& sound, Settings& settings)
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 TIA::~TIA()
 {
-  delete[] myCurrentFrameBuffer;
-  delete[] myPreviousFrameBuffer;
+  for(uInt32 i = 0; i < kMaxFrameBuffers; ++i)
+    delete[] myFrameBuffers[i];
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::reset()
 {
+  // Nothing scheduled applies after a reset
+  myScheduledInputs.clear();
+
   // Reset the sound device
   mySound.reset();
 
@@ -160,12 +170,9 @@ void TIA::frameReset()
   // Clear frame buffers
   clearBuffers();
 
-  // Reset pixel pointer and drawing flag
-  myFramePointer = myCurrentFrameBuffer;
-
   // Calculate color clock offsets for starting and stopping frame drawing
   // Note that although we always start drawing at scanline zero, the
-  // framebuffer that is exposed outside the class actually starts at 'ystart'
+  // framebuffers only hold the scanlines starting at 'ystart'
   myFramePointerOffset = 160 * myFrameYStart;
 
   //myAutoFrameEnabled = (mySettings.getFloat("framerate") <= 0);
@@ -224,8 +231,10 @@ void TIA::systemCyclesReset()
   // Get the current system cycle
   uInt32 cycles = mySystem->cycles();
 
-  // Adjust the sound cycle indicator
-  mySound.adjustCycleCounter(-1 * cycles);
+  // Adjust the sound cycle indicator (which doesn't move while the sound
+  // is disabled, as the cycles will be restored along with the state)
+  if(mySoundEnabled)
+    mySound.adjustCycleCounter(-1 * cycles);
 
   // Adjust the dump cycle
   myDumpDisabledCycle -= cycles;
@@ -460,8 +469,19 @@ bool TIA::load(Serializer& in)
     myFrameCounter = in.getInt();
     myPALFrameCounter = in.getInt();
 
-    // Load the sound sample stuff ...
-    mySound.load(in);
+    // Load the sound sample stuff ... unless sound is disabled, in which
+    // case the sound device is left as it is (see enableSound()), with its
+    // queued register writes; as it hasn't changed since the state was
+    // saved, its state is skipped by reading as much as it writes now
+    if(mySoundEnabled)
+      mySound.load(in);
+    else
+    {
+      Serializer sound;
+      mySound.save(sound);
+      for(uInt32 size = sound.data().size(); size > 0; --size)
+        in.getByte();
+    }
 
     // Reset TIA bits to be on
     enableBits(true);
@@ -477,6 +497,178 @@ bool TIA::load(Serializer& in)
   return true;
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::saveSnapshot(Snapshot& s) const
+{
+  s.clockWhenFrameStarted = myClockWhenFrameStarted;
+  s.clockStartDisplay = myClockStartDisplay;
+  s.clockStopDisplay = myClockStopDisplay;
+  s.clockAtLastUpdate = myClockAtLastUpdate;
+  s.clocksToEndOfScanLine = myClocksToEndOfScanLine;
+  s.scanlineCountForLastFrame = myScanlineCountForLastFrame;
+  s.VSYNCFinishClock = myVSYNCFinishClock;
+
+  s.enabledObjects = myEnabledObjects;
+  s.disabledObjects = myDisabledObjects;
+
+  s.VSYNC = myVSYNC;
+  s.VBLANK = myVBLANK;
+  s.NUSIZ0 = myNUSIZ0;
+  s.NUSIZ1 = myNUSIZ1;
+
+  memcpy(s.color, myColor, 8);
+
+  s.CTRLPF = myCTRLPF;
+  s.playfieldPriorityAndScore = myPlayfieldPriorityAndScore;
+  s.REFP0 = myREFP0;
+  s.REFP1 = myREFP1;
+  s.PF = myPF;
+  s.GRP0 = myGRP0;
+  s.GRP1 = myGRP1;
+  s.DGRP0 = myDGRP0;
+  s.DGRP1 = myDGRP1;
+  s.ENAM0 = myENAM0;
+  s.ENAM1 = myENAM1;
+  s.ENABL = myENABL;
+  s.DENABL = myDENABL;
+  s.HMP0 = myHMP0;
+  s.HMP1 = myHMP1;
+  s.HMM0 = myHMM0;
+  s.HMM1 = myHMM1;
+  s.HMBL = myHMBL;
+  s.VDELP0 = myVDELP0;
+  s.VDELP1 = myVDELP1;
+  s.VDELBL = myVDELBL;
+  s.RESMP0 = myRESMP0;
+  s.RESMP1 = myRESMP1;
+  s.collision = myCollision;
+  s.collisionEnabledMask = myCollisionEnabledMask;
+  s.currentGRP0 = myCurrentGRP0;
+  s.currentGRP1 = myCurrentGRP1;
+
+  s.dumpEnabled = myDumpEnabled;
+  s.dumpDisabledCycle = myDumpDisabledCycle;
+
+  s.POSP0 = myPOSP0;
+  s.POSP1 = myPOSP1;
+  s.POSM0 = myPOSM0;
+  s.POSM1 = myPOSM1;
+  s.POSBL = myPOSBL;
+
+  s.motionClockP0 = myMotionClockP0;
+  s.motionClockP1 = myMotionClockP1;
+  s.motionClockM0 = myMotionClockM0;
+  s.motionClockM1 = myMotionClockM1;
+  s.motionClockBL = myMotionClockBL;
+
+  s.startP0 = myStartP0;
+  s.startP1 = myStartP1;
+  s.startM0 = myStartM0;
+  s.startM1 = myStartM1;
+
+  s.suppressP0 = mySuppressP0;
+  s.suppressP1 = mySuppressP1;
+
+  s.HMP0mmr = myHMP0mmr;
+  s.HMP1mmr = myHMP1mmr;
+  s.HMM0mmr = myHMM0mmr;
+  s.HMM1mmr = myHMM1mmr;
+  s.HMBLmmr = myHMBLmmr;
+
+  s.currentHMOVEPos = myCurrentHMOVEPos;
+  s.previousHMOVEPos = myPreviousHMOVEPos;
+  s.HMOVEBlankEnabled = myHMOVEBlankEnabled;
+
+  s.frameCounter = myFrameCounter;
+  s.PALFrameCounter = myPALFrameCounter;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::loadSnapshot(const Snapshot& s)
+{
+  myClockWhenFrameStarted = s.clockWhenFrameStarted;
+  myClockStartDisplay = s.clockStartDisplay;
+  myClockStopDisplay = s.clockStopDisplay;
+  myClockAtLastUpdate = s.clockAtLastUpdate;
+  myClocksToEndOfScanLine = s.clocksToEndOfScanLine;
+  myScanlineCountForLastFrame = s.scanlineCountForLastFrame;
+  myVSYNCFinishClock = s.VSYNCFinishClock;
+
+  myEnabledObjects = s.enabledObjects;
+  myDisabledObjects = s.disabledObjects;
+
+  myVSYNC = s.VSYNC;
+  myVBLANK = s.VBLANK;
+  myNUSIZ0 = s.NUSIZ0;
+  myNUSIZ1 = s.NUSIZ1;
+
+  memcpy(myColor, s.color, 8);
+
+  myCTRLPF = s.CTRLPF;
+  myPlayfieldPriorityAndScore = s.playfieldPriorityAndScore;
+  myREFP0 = s.REFP0;
+  myREFP1 = s.REFP1;
+  myPF = s.PF;
+  myGRP0 = s.GRP0;
+  myGRP1 = s.GRP1;
+  myDGRP0 = s.DGRP0;
+  myDGRP1 = s.DGRP1;
+  myENAM0 = s.ENAM0;
+  myENAM1 = s.ENAM1;
+  myENABL = s.ENABL;
+  myDENABL = s.DENABL;
+  myHMP0 = s.HMP0;
+  myHMP1 = s.HMP1;
+  myHMM0 = s.HMM0;
+  myHMM1 = s.HMM1;
+  myHMBL = s.HMBL;
+  myVDELP0 = s.VDELP0;
+  myVDELP1 = s.VDELP1;
+  myVDELBL = s.VDELBL;
+  myRESMP0 = s.RESMP0;
+  myRESMP1 = s.RESMP1;
+  myCollision = s.collision;
+  myCollisionEnabledMask = s.collisionEnabledMask;
+  myCurrentGRP0 = s.currentGRP0;
+  myCurrentGRP1 = s.currentGRP1;
+
+  myDumpEnabled = s.dumpEnabled;
+  myDumpDisabledCycle = s.dumpDisabledCycle;
+
+  myPOSP0 = s.POSP0;
+  myPOSP1 = s.POSP1;
+  myPOSM0 = s.POSM0;
+  myPOSM1 = s.POSM1;
+  myPOSBL = s.POSBL;
+
+  myMotionClockP0 = s.motionClockP0;
+  myMotionClockP1 = s.motionClockP1;
+  myMotionClockM0 = s.motionClockM0;
+  myMotionClockM1 = s.motionClockM1;
+  myMotionClockBL = s.motionClockBL;
+
+  myStartP0 = s.startP0;
+  myStartP1 = s.startP1;
+  myStartM0 = s.startM0;
+  myStartM1 = s.startM1;
+
+  mySuppressP0 = s.suppressP0;
+  mySuppressP1 = s.suppressP1;
+
+  myHMP0mmr = s.HMP0mmr;
+  myHMP1mmr = s.HMP1mmr;
+  myHMM0mmr = s.HMM0mmr;
+  myHMM1mmr = s.HMM1mmr;
+  myHMBLmmr = s.HMBLmmr;
+
+  myCurrentHMOVEPos = s.currentHMOVEPos;
+  myPreviousHMOVEPos = s.previousHMOVEPos;
+  myHMOVEBlankEnabled = s.HMOVEBlankEnabled;
+
+  myFrameCounter = s.frameCounter;
+  myPALFrameCounter = s.PALFrameCounter;
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 bool TIA::saveDisplay(Serializer& out) const
 {
@@ -484,7 +676,8 @@ bool TIA::saveDisplay(Serializer& out) const
   {
     out.putBool(myPartialFrameFlag);
     out.putInt(myFramePointerClocks);
-    out.putByteArray(myCurrentFrameBuffer, 160*320);
+    out.putInt(myFrameHeight);
+    out.putByteArray(myCurrentFrameBuffer, 160*myFrameHeight);
   }
   catch(...)
   {
@@ -500,19 +693,20 @@ bool TIA::loadDisplay(Serializer& in)
 {
   try
   {
-    myPartialFrameFlag = in.getBool();
-    myFramePointerClocks = in.getInt();
+    bool partialFrame = in.getBool();
+    uInt32 clocks = in.getInt();
 
-    // Reset frame buffer pointer and data
+    // The display can only be restored into a frame of the same size
+    if((uInt32)in.getInt() != myFrameHeight)
+      return false;
+
+    // Reset frame buffer data; if we're in partial frame mode, drawing
+    // continues from where it was when the state was saved
+    myPartialFrameFlag = partialFrame;
+    myFramePointerClocks = clocks;
     clearBuffers();
-    myFramePointer = myCurrentFrameBuffer;
-    in.getByteArray(myCurrentFrameBuffer, 160*320);
-    memcpy(myPreviousFrameBuffer, myCurrentFrameBuffer, 160*320);
-
-    // If we're in partial frame mode, make sure to re-create the screen
-    // as it existed when the state was saved
-    if(myPartialFrameFlag)
-      myFramePointer += myFramePointerClocks;
+    in.getByteArray(myCurrentFrameBuffer, 160*myFrameHeight);
+    myFrameBufferLines[myCurrentBuffer] = myFrameHeight;
   }
   catch(...)
   {
@@ -536,20 +730,73 @@ void TIA::update()
   myPartialFrameFlag = true;
 
   // Execute instructions until frame is finished, or a breakpoint/trap hits
-  mySystem->m6502().execute(25000);
+  if(myScheduledInputs.empty())
+    mySystem->m6502().execute(25000);
+  else
+    executeScheduledInputs(25000);
 
   // TODO: have code here that handles errors....
 
   endFrame();
 }
 
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::scheduleInput(uInt32 scanline, uInt32 cycle, const FrameInput& input)
+{
+  ScheduledInput scheduled;
+  scheduled.clock = scanline * 228 + cycle * 3;
+  scheduled.input = input;
+
+  // Keep the schedule in order, after any input for the same clock
+  vector<ScheduledInput>::iterator it = myScheduledInputs.end();
+  while(it != myScheduledInputs.begin() && (it - 1)->clock > scheduled.clock)
+    --it;
+  myScheduledInputs.insert(it, scheduled);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::executeScheduledInputs(uInt32 instructions)
+{
+  // The most CPU cycles a single instruction can take, including a WSYNC
+  // halting the CPU until the end of the scanline
+  const uInt32 kMaxInstructionCycles = 4 + 76;
+
+  M6502& cpu = mySystem->m6502();
+  bool running = true;
+
+  for(uInt32 i = 0; i < myScheduledInputs.size(); ++i)
+  {
+    // Run up to the input in bursts short enough not to go past it,
+    // down to single instructions as it gets close
+    uInt32 clock = myScheduledInputs[i].clock;
+    while(running && myPartialFrameFlag && instructions > 0)
+    {
+      uInt32 now = (mySystem->cycles() * 3) - myClockWhenFrameStarted;
+      if(now >= clock)
+        break;
+
+      uInt32 burst = BSPF_min(BSPF_max((clock - now) / 3 /
+                       kMaxInstructionCycles, 1u), instructions);
+      running = cpu.execute(burst);
+      instructions -= burst;
+    }
+    myConsole.applyInput(myScheduledInputs[i].input);
+  }
+  myScheduledInputs.clear();
+
+  // Then finish the frame as usual
+  if(running && myPartialFrameFlag && instructions > 0)
+    cpu.execute(instructions);
+}
+
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 inline void TIA::startFrame()
 {
   // This stuff should only happen at the beginning of a new frame.
-  uInt8* tmp = myCurrentFrameBuffer;
-  myCurrentFrameBuffer = myPreviousFrameBuffer;
-  myPreviousFrameBuffer = tmp;
+  // The new frame is drawn over the oldest one in the ring (unless it
+  // won't be drawn at all)
+  if(myVideoEnabled)
+    setCurrentBuffer(myCurrentBuffer + 1);
 
   // Remember the number of clocks which have passed on the current scanline
   // so that we can adjust the frame's starting clock by this amount.  This
@@ -568,9 +815,12 @@ inline void TIA::startFrame()
   myClocksToEndOfScanLine = 228;
 
   // Reset frame buffer pointer
-  myFramePointer = myCurrentFrameBuffer;
   myFramePointerClocks = 0;
 
+  // Nothing has been drawn (and so nothing has changed) yet
+  memset(myDirtyLines, 0, sizeof(myDirtyLines));
+  myDirtyCheckLine = 0;
+
   // If color loss is enabled then update the color registers based on
   // the number of scanlines in the last frame that was generated
   if(myColorLossEnabled)
@@ -609,6 +859,14 @@ inline void TIA::endFrame()
 {
   uInt32 currentlines = scanlines();
 
+  // The number of lines of the frame buffer drawn to in this frame
+  uInt32 drawn = (myFramePointerClocks + 159) / 160;
+  drawn = drawn > myFrameYStart ?
+          BSPF_min(drawn - myFrameYStart, myFrameHeight) : 0;
+  uInt32& lines = myFrameBufferLines[myCurrentBuffer];
+  if(myVideoEnabled)
+    lines = BSPF_max(lines, drawn);
+
   // The TIA may generate frames that are 'invisible' to TV (they complete
   // before the first visible scanline)
   // Such 'short' frames can't simply be eliminated, since they're running
@@ -616,9 +874,17 @@ inline void TIA::endFrame()
   // double-buffering of the video output will get confused
   if(currentlines <= myStartScanline)
   {
-    // Skip display of this frame, as if it wasn't generated at all
+    // Skip display of this frame, as if it wasn't generated at all; the
+    // frame before it becomes current again (startFrame() moves on by one)
+    if(myVideoEnabled)
+      setCurrentBuffer(myCurrentBuffer + myNumFrameBuffers - 2);
     startFrame();
     myFrameCounter--;  // This frame doesn't contribute to frame count
+
+    // The buffers have been moved back, so the previous frame no
+    // longer matches what has been shown
+    if(myVideoEnabled)
+      setLinesDirty(0, 320);
     return;
   }
 
@@ -626,13 +892,10 @@ inline void TIA::endFrame()
   uInt32 previousCount = myScanlineCountForLastFrame;
   myScanlineCountForLastFrame = currentlines;
 
-  // The following handle cases where scanlines either go too high or too
-  // low compared to the previous frame, in which case certain portions
-  // of the framebuffer are cleared to zero (black pixels)
-  // Due to the FrameBuffer class (potentially) doing dirty-rectangle
-  // updates, each internal buffer must be set slightly differently,
-  // otherwise they won't know anything has changed
-  // Hence, the front buffer is set to pixel 0, and the back to pixel 1
+  // Blanked lines are always set to colour 0; with only two buffers, the
+  // back buffer used to be set to colour 1 instead (the same black), only
+  // so that dirty-rectangle updates would notice the change, which the
+  // dirty line tracking now does by itself
 
   // Did we generate too many scanlines?
   // (usually caused by VBLANK/VSYNC taking too long or not occurring at all)
@@ -640,23 +903,27 @@ inline void TIA::endFrame()
   if(myScanlineCountForLastFrame > myMaximumNumberOfScanlines+1)
   {
     myScanlineCountForLastFrame = myMaximumNumberOfScanlines;
-    if(previousCount < myMaximumNumberOfScanlines)
+    if(previousCount < myMaximumNumberOfScanlines && myVideoEnabled)
     {
-      memset(myCurrentFrameBuffer, 0, 160 * 320);
-      memset(myPreviousFrameBuffer, 1, 160 * 320);
+      memset(myCurrentFrameBuffer, 0, 160 * lines);
+      lines = 0;
+      setLinesDirty(0, 320);
     }
   }
-  // Did the number of scanlines decrease?
-  // If so, blank scanlines that weren't rendered this frame
-  else if(myScanlineCountForLastFrame < previousCount &&
-          myScanlineCountForLastFrame < 320 && previousCount < 320)
+  // Otherwise, blank any lines this buffer still holds from an earlier
+  // frame with more scanlines, since they weren't drawn in this one
+  else if(lines > drawn && myVideoEnabled)
   {
-    uInt32 offset = myScanlineCountForLastFrame * 160,
-           stride = (previousCount - myScanlineCountForLastFrame) * 160;
-    memset(myCurrentFrameBuffer + offset, 0, stride);
-    memset(myPreviousFrameBuffer + offset, 1, stride);
+    memset(myCurrentFrameBuffer + 160 * drawn, 0, 160 * (lines - drawn));
+    lines = drawn;
   }
 
+  // Check the rest of the buffer; this includes the last (possibly
+  // incomplete) line drawn, and any lines not drawn in this frame at all,
+  // which may still differ from the previous frame
+  if(myVideoEnabled)
+    updateDirtyLines(myFrameHeight);
+
   // Recalculate framerate. attempting to auto-correct for scanline 'jumps'
   if(myAutoFrameEnabled)
   {
@@ -1036,20 +1303,31 @@ void TIA::updateFrame(Int32 clock)
       clocksToUpdate -= tmp;
     }
 
+    // Find where this part of the scanline is drawn; scanlines outside
+    // the frame buffer are drawn into a scratch line and then discarded
+    uInt8* framePointer;
+    if(myFramePointerClocks >= myFramePointerOffset &&
+       myFramePointerClocks - myFramePointerOffset < 160 * myFrameHeight)
+      framePointer = myCurrentFrameBuffer +
+                     (myFramePointerClocks - myFramePointerOffset);
+    else
+      framePointer = myDiscardedLine + myFramePointerClocks % 160;
+
     // Remember frame pointer in case HMOVE blanks need to be handled
-    uInt8* oldFramePointer = myFramePointer;
+    uInt8* oldFramePointer = framePointer;
 
     // Update as much of the scanline as we can
     if(clocksToUpdate != 0)
     {
       // Calculate the ending frame pointer value
-      uInt8* ending = myFramePointer + clocksToUpdate;
+      uInt8* ending = framePointer + clocksToUpdate;
       myFramePointerClocks += clocksToUpdate;
 
       // See if we're in the vertical blank region
       if(myVBLANK & 0x02)
       {
-        memset(myFramePointer, 0, clocksToUpdate);
+        if(myVideoEnabled)
+          memset(framePointer, 0, clocksToUpdate);
       }
       // Handle all other possible combinations
       else
@@ -1118,32 +1396,26 @@ void TIA::updateFrame(Int32 clock)
 
         uInt8 enabledObjects = myEnabledObjects & myDisabledObjects;
         uInt32 hpos = clocksFromStartOfScanLine - HBLANK;
-        for(; myFramePointer < ending; ++myFramePointer, ++hpos)
+        if(!myVideoEnabled)
         {
-          uInt8 enabled = ((enabledObjects & PFBit) &&
-                           (myPF & myPFMask[hpos])) ? PFBit : 0;
-
-          if((enabledObjects & BLBit) && myBLMask[hpos])
-            enabled |= BLBit;
-
-          if((enabledObjects & P1Bit) && (myCurrentGRP1 & myP1Mask[hpos]))
-            enabled |= P1Bit;
-
-          if((enabledObjects & M1Bit) && myM1Mask[hpos])
-            enabled |= M1Bit;
-
-          if((enabledObjects & P0Bit) && (myCurrentGRP0 & myP0Mask[hpos]))
-            enabled |= P0Bit;
-
-          if((enabledObjects & M0Bit) && myM0Mask[hpos])
-            enabled |= M0Bit;
+          // Only collisions are needed, and there can't be any unless at
+          // least two objects are enabled
+          uInt8 objects = enabledObjects & (PFBit | BLBit | P1Bit |
+                                            M1Bit | P0Bit | M0Bit);
+          if(objects & (objects - 1))
+            for(uInt32 end = hpos + clocksToUpdate; hpos < end; ++hpos)
+              myCollision |=
+                TIATables::CollisionMask[objectsAt(enabledObjects, hpos)];
+        }
+        else for(; framePointer < ending; ++framePointer, ++hpos)
+        {
+          uInt8 enabled = objectsAt(enabledObjects, hpos);
 
           myCollision |= TIATables::CollisionMask[enabled];
-          *myFramePointer = myColorPtr[myPriorityEncoder[hpos < 80 ? 0 : 1]
+          *framePointer = myColorPtr[myPriorityEncoder[hpos < 80 ? 0 : 1]
               [enabled | myPlayfieldPriorityAndScore]];
         }
       }
-      myFramePointer = ending;
     }
 
     // Handle HMOVE blanks if they are enabled
@@ -1151,7 +1423,8 @@ void TIA::updateFrame(Int32 clock)
         (clocksFromStartOfScanLine < (HBLANK + 8)))
     {
       Int32 blanks = (HBLANK + 8) - clocksFromStartOfScanLine;
-      memset(oldFramePointer, myColorPtr[HBLANKColor], blanks);
+      if(myVideoEnabled)
+        memset(oldFramePointer, myColorPtr[HBLANKColor], blanks);
 
       if((clocksToUpdate + clocksFromStartOfScanLine) >= (HBLANK + 8))
         myHMOVEBlankEnabled = false;
@@ -1169,6 +1442,35 @@ void TIA::updateFrame(Int32 clock)
     }
 #endif
   }
+
+  // Lines that are now complete won't be drawn to again during this frame
+  // (nothing is drawn at all with video off)
+  if(myVideoEnabled && myFramePointerClocks > myFramePointerOffset)
+    updateDirtyLines((myFramePointerClocks - myFramePointerOffset) / 160);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline uInt8 TIA::objectsAt(uInt8 enabledObjects, uInt32 hpos) const
+{
+  uInt8 enabled = ((enabledObjects & PFBit) &&
+                   (myPF & myPFMask[hpos])) ? PFBit : 0;
+
+  if((enabledObjects & BLBit) && myBLMask[hpos])
+    enabled |= BLBit;
+
+  if((enabledObjects & P1Bit) && (myCurrentGRP1 & myP1Mask[hpos]))
+    enabled |= P1Bit;
+
+  if((enabledObjects & M1Bit) && myM1Mask[hpos])
+    enabled |= M1Bit;
+
+  if((enabledObjects & P0Bit) && (myCurrentGRP0 & myP0Mask[hpos]))
+    enabled |= P0Bit;
+
+  if((enabledObjects & M0Bit) && myM0Mask[hpos])
+    enabled |= M0Bit;
+
+  return enabled;
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -1240,8 +1542,99 @@ inline void TIA::waitHorizontalRSync()
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 void TIA::clearBuffers()
 {
-  memset(myCurrentFrameBuffer, 0, 160 * 320);
-  memset(myPreviousFrameBuffer, 0, 160 * 320);
+  // Only the lines which have been drawn to need to be cleared
+  if(myFrameBufferHeight != myFrameHeight)
+    allocateBuffers();
+  else
+  {
+    for(uInt32 i = 0; i < myNumFrameBuffers; ++i)
+    {
+      memset(myFrameBuffers[i], 0, 160 * myFrameBufferLines[i]);
+      myFrameBufferLines[i] = 0;
+    }
+  }
+
+  // Whatever was shown before no longer applies
+  setLinesDirty(0, 320);
+  myDirtyCheckLine = 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::allocateBuffers()
+{
+  for(uInt32 i = 0; i < kMaxFrameBuffers; ++i)
+  {
+    delete[] myFrameBuffers[i];
+    myFrameBuffers[i] = 0;
+    myFrameBufferLines[i] = 0;
+  }
+  for(uInt32 i = 0; i < myNumFrameBuffers; ++i)
+  {
+    myFrameBuffers[i] = new uInt8[160 * myFrameHeight];
+    memset(myFrameBuffers[i], 0, 160 * myFrameHeight);
+  }
+  myFrameBufferHeight = myFrameHeight;
+
+  setCurrentBuffer(0);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::setCurrentBuffer(uInt32 index)
+{
+  myCurrentBuffer = index % myNumFrameBuffers;
+  myCurrentFrameBuffer = myFrameBuffers[myCurrentBuffer];
+  myPreviousFrameBuffer = myFrameBuffers[
+      (myCurrentBuffer + myNumFrameBuffers - 1) % myNumFrameBuffers];
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::setFrameBufferDepth(uInt32 depth)
+{
+  myNumFrameBuffers = BSPF_clamp(depth, 2u, (uInt32)kMaxFrameBuffers);
+  allocateBuffers();
+  clearBuffers();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+bool TIA::isFrameDirty() const
+{
+  uInt32 line = 0;
+  return nextDirtyLines(line) > 0;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+uInt32 TIA::nextDirtyLines(uInt32& line) const
+{
+  while(line < myFrameHeight && !isLineDirty(line))
+    ++line;
+
+  uInt32 count = 0;
+  while(line + count < myFrameHeight && isLineDirty(line + count))
+    ++count;
+
+  return count;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void TIA::setLinesDirty(uInt32 first, uInt32 count)
+{
+  for(uInt32 line = first; line < first + count && line < 320; ++line)
+    myDirtyLines[line >> 5] |= 1 << (line & 31);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+inline void TIA::updateDirtyLines(uInt32 end)
+{
+  if(end > myFrameHeight)
+    end = myFrameHeight;
+
+  for(; myDirtyCheckLine < end; ++myDirtyCheckLine)
+  {
+    uInt32 offset = myDirtyCheckLine * 160;
+    if(memcmp(myCurrentFrameBuffer + offset,
+              myPreviousFrameBuffer + offset, 160) != 0)
+      myDirtyLines[myDirtyCheckLine >> 5] |= 1 << (myDirtyCheckLine & 31);
+  }
 }
 
 // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
@@ -1792,42 +2185,48 @@ bool TIA::poke(uInt16 addr, uInt8 value)
     case AUDC0:   // Audio control 0
     {
       myAUDC0 = value & 0x0f;
-      mySound.set(addr, value, mySystem->cycles());
+      if(mySoundEnabled)
+        mySound.set(addr, value, mySystem->cycles());
       break;
     }
   
     case AUDC1:   // Audio control 1
     {
       myAUDC1 = value & 0x0f;
-      mySound.set(addr, value, mySystem->cycles());
+      if(mySoundEnabled)
+        mySound.set(addr, value, mySystem->cycles());
       break;
     }
   
     case AUDF0:   // Audio frequency 0
     {
       myAUDF0 = value & 0x1f;
-      mySound.set(addr, value, mySystem->cycles());
+      if(mySoundEnabled)
+        mySound.set(addr, value, mySystem->cycles());
       break;
     }
   
     case AUDF1:   // Audio frequency 1
     {
       myAUDF1 = value & 0x1f;
-      mySound.set(addr, value, mySystem->cycles());
+      if(mySoundEnabled)
+        mySound.set(addr, value, mySystem->cycles());
       break;
     }
   
     case AUDV0:   // Audio volume 0
     {
       myAUDV0 = value & 0x0f;
-      mySound.set(addr, value, mySystem->cycles());
+      if(mySoundEnabled)
+        mySound.set(addr, value, mySystem->cycles());
       break;
     }
   
     case AUDV1:   // Audio volume 1
     {
       myAUDV1 = value & 0x0f;
-      mySound.set(addr, value, mySystem->cycles());
+      if(mySoundEnabled)
+        mySound.set(addr, value, mySystem->cycles());
       break;
     }
 
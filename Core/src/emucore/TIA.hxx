@@ -24,8 +24,11 @@ class Console;
 class Settings;
 class Sound;
 
+#include <vector>
+
 #include "bspf.hxx"
 #include "Device.hxx"
+#include "FrameInput.hxx"
 #include "System.hxx"
 #include "TIATables.hxx"
 
@@ -49,6 +52,9 @@ class TIA : public Device
     friend class TIADebug;
     friend class RiotDebug;
 
+    // The largest number of frames which may be kept (see frameBuffer())
+    enum { kMaxFrameBuffers = 16 };
+
     /**
       Create a new TIA for the specified console
 
@@ -116,6 +122,55 @@ class TIA : public Device
     */
     bool load(Serializer& in);
 
+    /**
+      The state saved by save(), as plain data (see ConsoleSnapshot).
+      Note that the state of the sound isn't included, and that unlike
+      load(), restoring a snapshot leaves the debugging options (ie, the
+      fixed colors) as they are.
+    */
+    struct Snapshot {
+      Int32 clockWhenFrameStarted, clockStartDisplay, clockStopDisplay;
+      Int32 clockAtLastUpdate, clocksToEndOfScanLine;
+      uInt32 scanlineCountForLastFrame;
+      Int32 VSYNCFinishClock;
+
+      uInt8 enabledObjects, disabledObjects;
+
+      uInt8 VSYNC, VBLANK, NUSIZ0, NUSIZ1;
+      uInt8 color[8];
+      uInt8 CTRLPF, playfieldPriorityAndScore;
+      bool REFP0, REFP1;
+      uInt32 PF;
+      uInt8 GRP0, GRP1, DGRP0, DGRP1;
+      bool ENAM0, ENAM1, ENABL, DENABL;
+      uInt8 HMP0, HMP1, HMM0, HMM1, HMBL;
+      bool VDELP0, VDELP1, VDELBL, RESMP0, RESMP1;
+      uInt16 collision;
+      uInt32 collisionEnabledMask;
+      uInt8 currentGRP0, currentGRP1;
+
+      bool dumpEnabled;
+      Int32 dumpDisabledCycle;
+
+      Int16 POSP0, POSP1, POSM0, POSM1, POSBL;
+      Int32 motionClockP0, motionClockP1, motionClockM0, motionClockM1,
+            motionClockBL;
+      Int32 startP0, startP1, startM0, startM1;
+      uInt8 suppressP0, suppressP1;
+      bool HMP0mmr, HMP1mmr, HMM0mmr, HMM1mmr, HMBLmmr;
+
+      Int32 currentHMOVEPos, previousHMOVEPos;
+      bool HMOVEBlankEnabled;
+
+      uInt32 frameCounter, PALFrameCounter;
+    };
+
+    /**
+      Copy the current state of this device to/from the given snapshot.
+    */
+    void saveSnapshot(Snapshot& s) const;
+    void loadSnapshot(const Snapshot& s);
+
     /**
       The following are very similar to save() and load(), except they
       do a 'deeper' save of the display data itself.
@@ -170,20 +225,114 @@ class TIA : public Device
     void update();
 
     /**
-      Answers the current frame buffer
+      Schedule a change of input within the next frame emulated by
+      update(), for studying input latency or for precise (ie, tool
+      assisted) input.  The input is applied (see Console::applyInput) at
+      the first instruction boundary at or after the given position, and
+      inputs scheduled for the same position are applied in the order in
+      which they were scheduled.  Inputs which the frame doesn't reach
+      are applied at its end; either way, the schedule is empty once the
+      frame is done.  Emulation only runs instruction by instruction
+      close to a scheduled input, and not at all differently when there's
+      none.
+
+      @param scanline  The scanline, counted as by scanlines()
+      @param cycle     The CPU cycle within the scanline (which may be
+                       beyond its 76 cycles, ie, to count the cycles of
+                       the whole frame with scanline 0)
+      @param input     The input to apply
+    */
+    void scheduleInput(uInt32 scanline, uInt32 cycle, const FrameInput& input);
+
+    /**
+      Remove all the inputs scheduled for the next frame.
+    */
+    void clearScheduledInputs() { myScheduledInputs.clear(); }
+
+    /**
+      Answers the number of inputs scheduled for the next frame.
+    */
+    uInt32 scheduledInputs() const { return myScheduledInputs.size(); }
+
+    /**
+      Answers the current frame buffer.  Only the visible part of the frame
+      is kept, so the buffer holds 'height' lines of 'width' pixels, the
+      first of which is scanline 'ystart'.
 
       @return Pointer to the current frame buffer
     */
-    uInt8* currentFrameBuffer() const
-      { return myCurrentFrameBuffer + myFramePointerOffset; }
+    uInt8* currentFrameBuffer() const { return myCurrentFrameBuffer; }
 
     /**
       Answers the previous frame buffer
 
       @return Pointer to the previous frame buffer
     */
-    uInt8* previousFrameBuffer() const
-      { return myPreviousFrameBuffer + myFramePointerOffset; }
+    uInt8* previousFrameBuffer() const { return myPreviousFrameBuffer; }
+
+    /**
+      Answers one of the most recent frames, which are kept in a ring of
+      frameBufferDepth() buffers.  Each new frame is drawn into the buffer
+      of the oldest one, so rather than copying a frame, a caller needing
+      it later (ie, for phosphor effects or capturing) can simply use it
+      until 'frameBufferDepth() - age - 1' more frames have been drawn.
+
+      @param age  0 for the current frame, 1 for the previous one, etc
+      @return Pointer to the frame buffer, or 0 if that frame isn't kept
+    */
+    const uInt8* frameBuffer(uInt32 age) const
+    {
+      return age < myNumFrameBuffers ? myFrameBuffers[
+        (myCurrentBuffer + myNumFrameBuffers - age) % myNumFrameBuffers] : 0;
+    }
+
+    /**
+      Answers the number of frames kept (see frameBuffer())
+    */
+    uInt32 frameBufferDepth() const { return myNumFrameBuffers; }
+
+    /**
+      Changes the number of frames kept (see frameBuffer()), between 2 and
+      kMaxFrameBuffers.  Note that this clears all the frame buffers.
+
+      @param depth  The number of frames to keep
+    */
+    void setFrameBufferDepth(uInt32 depth);
+
+    /**
+      Answers whether the given line of the current frame buffer differs
+      from the same line of the previous frame buffer.  Frontends which
+      present every frame can use this to convert and upload only the
+      lines that have changed; after anything else invalidates their
+      output (palette or mode changes, skipped frames, etc), they must
+      still redraw the entire frame.
+
+      @param line  The line, relative to currentFrameBuffer()
+      @return  True if the line has changed since the previous frame
+    */
+    bool isLineDirty(uInt32 line) const
+    {
+      return line < 320 && (myDirtyLines[line >> 5] & (1 << (line & 31)));
+    }
+
+    /**
+      Answers whether any line of the current frame (ie, within 'height'
+      lines of currentFrameBuffer()) differs from the previous frame.
+
+      @return  True if any visible line has changed since the previous frame
+    */
+    bool isFrameDirty() const;
+
+    /**
+      Find the next group of consecutive dirty lines (see isLineDirty())
+      within the current frame, starting from the given line.
+
+      @param line  On entry, the line to start searching from; on exit,
+                   the first dirty line found
+      @return  The number of consecutive dirty lines starting at 'line',
+               or 0 if there are no more dirty lines in the frame
+    */
+    uInt32 nextDirtyLines(uInt32& line) const;
 
     /**
       Answers the width and height of the frame buffer
@@ -208,6 +357,35 @@ class TIA : public Device
     */
     void enableAutoFrame(bool mode) { myAutoFrameEnabled = mode; }
 
+    /**
+      Enables/disables video output.  Emulation stays exact when video is
+      disabled: the objects are still tracked
+      and collisions detected (and only where two objects are enabled at
+      all), but no pixels are generated, and the frame buffers are left
+      untouched.  The ring of frame buffers doesn't move on either, so
+      frameBuffer(0) is still the last frame generated with video enabled.
+      This is meant for running frames whose output is never seen (ie,
+      skipped frames, or when autodetecting the display format), and
+      should only be changed between frames.
+
+      @param mode  Whether to enable or disable video output
+    */
+    void enableVideo(bool mode) { myVideoEnabled = mode; }
+    bool isVideoEnabled() const { return myVideoEnabled; }
+
+    /**
+      Enables/disables sound output.  While sound is disabled, writes to
+      the audio registers are still seen by the emulation, but aren't
+      passed on to the sound device, which is left exactly as it was
+      (even by load(), which then skips the state of the sound).
+      This is meant for running frames which are later undone (ie, when
+      running ahead), whose sound would otherwise be heard twice.
+
+      @param mode  Whether to enable or disable sound output
+    */
+    void enableSound(bool mode) { mySoundEnabled = mode; }
+    bool isSoundEnabled() const { return mySoundEnabled; }
+
     /**
       Enables/disables color-loss for PAL modes only.
 
@@ -369,15 +547,36 @@ class TIA : public Device
     // Reset horizontal sync counter
     void waitHorizontalRSync();
 
-    // Clear both internal TIA buffers to black (palette color 0)
+    // Clear all internal TIA buffers to black (palette color 0),
+    // reallocating them if the size of the frame has changed
     void clearBuffers();
 
+    // Allocate the ring of frame buffers for the current frame size
+    void allocateBuffers();
+
+    // Make the given buffer of the ring the current one
+    void setCurrentBuffer(uInt32 index);
+
+    // Mark the given lines of the frame buffer as changed
+    void setLinesDirty(uInt32 first, uInt32 count);
+
+    // Compare the frame buffer lines up to (but not including) 'end' which
+    // haven't already been checked against the previous frame, marking
+    // those that differ as dirty
+    void updateDirtyLines(uInt32 end);
+
     // Set up bookkeeping for the next frame
     void startFrame();
 
     // Update bookkeeping at end of frame
     void endFrame();
 
+    // Execute the frame, applying the scheduled inputs along the way
+    void executeScheduledInputs(uInt32 instructions);
+
+    // Answers the objects drawn at the given horizontal position
+    uInt8 objectsAt(uInt8 enabledObjects, uInt32 hpos) const;
+
     // Convert resistance from ports to dumped value
     uInt8 dumpedInputPort(int resistance);
 
@@ -404,19 +603,38 @@ class TIA : public Device
     // Settings object the TIA is associated with
     Settings& mySettings;
 
+    // The ring of frame buffers, each holding the visible part of a frame
+    // (myFrameBufferHeight lines); the current frame is myCurrentBuffer,
+    // and the frames before it come before it in the ring
+    uInt8* myFrameBuffers[kMaxFrameBuffers];
+    uInt32 myNumFrameBuffers;
+    uInt32 myCurrentBuffer;
+    uInt32 myFrameBufferHeight;
+
+    // The number of lines of each buffer which may have been drawn to;
+    // all the lines following them are black
+    uInt32 myFrameBufferLines[kMaxFrameBuffers];
+
     // Pointer to the current frame buffer
     uInt8* myCurrentFrameBuffer;
 
     // Pointer to the previous frame buffer
     uInt8* myPreviousFrameBuffer;
 
-    // Pointer to the next pixel that will be drawn in the current frame buffer
-    uInt8* myFramePointer;
+    // Receives the pixels of scanlines outside the visible part of the frame
+    uInt8 myDiscardedLine[160];
 
-    // Indicates offset used by the exported frame buffer
-    // (the exported frame buffer is a vertical 'sliding window' of the actual buffer)
+    // Indicates the number of color clocks (in the 160 pixel wide frame)
+    // before the first visible scanline
     uInt32 myFramePointerOffset;
 
+    // Bitmap of the frame buffer lines (one bit per line) which differ
+    // from the previous frame
+    uInt32 myDirtyLines[10];
+
+    // The first frame buffer line not yet compared to the previous frame
+    uInt32 myDirtyCheckLine;
+
     // Indicates the number of 'colour clocks' offset from the base
     // frame buffer pointer
     // (this is used when loading state files with a 'partial' frame)
@@ -612,6 +830,20 @@ class TIA : public Device
     // Automatic framerate correction based on number of scanlines
     bool myAutoFrameEnabled;
 
+    // Indicates whether pixels are generated, or only collisions
+    bool myVideoEnabled;
+
+    // Indicates whether the audio registers are passed on to the sound
+    bool mySoundEnabled;
+
+    // The inputs to apply during the next frame, in order, each with the
+    // color clock (relative to the start of the frame) at which it applies
+    struct ScheduledInput {
+      uInt32 clock;
+      FrameInput input;
+    };
+    vector<ScheduledInput> myScheduledInputs;
+
     // Number of total frames displayed by this TIA
     uInt32 myFrameCounter;
 
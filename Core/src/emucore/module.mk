@@ -2,6 +2,7 @@ MODULE := src/emucore
 
 MODULE_OBJS := \
 	src/emucore/AtariVox.o \
+	src/emucore/BatchRunner.o \
 	src/emucore/Booster.o \
 	src/emucore/Cart.o \
 	src/emucore/Cart0840.o \
@@ -36,6 +37,7 @@ MODULE_OBJS := \
 	src/emucore/CartFA2.o \
 	src/emucore/CartFE.o \
 	src/emucore/CartMC.o \
+	src/emucore/CartRAM.o \
 	src/emucore/CartSB.o \
 	src/emucore/CartUA.o \
 	src/emucore/CartX07.o \
@@ -51,6 +53,7 @@ MODULE_OBJS := \
 	src/emucore/Keyboard.o \
 	src/emucore/KidVid.o \
 	src/emucore/MindLink.o \
+	src/emucore/Movie.o \
 	src/emucore/M6502.o \
 	src/emucore/M6532.o \
 	src/emucore/MT24LC256.o \
@@ -61,6 +64,8 @@ MODULE_OBJS := \
 	src/emucore/Props.o \
 	src/emucore/PropsSet.o \
 	src/emucore/Random.o \
+	src/emucore/Replay.o \
+	src/emucore/RunAhead.o \
 	src/emucore/SaveKey.o \
 	src/emucore/Serializer.o \
 	src/emucore/Settings.o \
@@ -219,6 +219,12 @@ VideoDialog::VideoDialog(OSystem* osystem, DialogContainer* parent,
   wid.push_back(myFastSCBiosCheckbox);
   ypos += lineHeight + 4;
 
+  // Start SuperCharger loads directly, without running the BIOS at all
+  myFastSCLoadCheckbox = new CheckboxWidget(myTab, font, xpos, ypos,
+                                            "Fast SC/AR load");
+  wid.push_back(myFastSCLoadCheckbox);
+  ypos += lineHeight + 4;
+
   // Show UI messages onscreen
   myUIMessagesCheckbox = new CheckboxWidget(myTab, font, xpos, ypos,
                                             "Show UI messages");
@@ -470,6 +476,7 @@ void VideoDialog::loadConfig()
 
   // Fast loading of Supercharger BIOS
   myFastSCBiosCheckbox->setState(instance().settings().getBool("fastscbios"));
+  myFastSCLoadCheckbox->setState(instance().settings().getBool("fastscload"));
 
   // TV Mode
   myTVMode->setSelected(
@@ -552,6 +559,7 @@ void VideoDialog::saveConfig()
 
   // Fast loading of Supercharger BIOS
   instance().settings().setValue("fastscbios", myFastSCBiosCheckbox->getState());
+  instance().settings().setValue("fastscload", myFastSCLoadCheckbox->getState());
 
   // TV Mode
   instance().settings().setValue("tv_filter",
@@ -607,6 +615,7 @@ void VideoDialog::setDefaults()
       myUIMessagesCheckbox->setState(true);
       myCenterCheckbox->setState(false);
       myFastSCBiosCheckbox->setState(false);
+      myFastSCLoadCheckbox->setState(false);
       break;
     }
 
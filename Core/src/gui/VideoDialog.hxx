@@ -74,6 +74,7 @@ class VideoDialog : public Dialog
     CheckboxWidget*   myUIMessagesCheckbox;
     CheckboxWidget*   myCenterCheckbox;
     CheckboxWidget*   myFastSCBiosCheckbox;
+    CheckboxWidget*   myFastSCLoadCheckbox;
 
     // TV effects adjustables (custom mode)
     PopUpWidget*      myTVMode;
@@ -0,0 +1,100 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2014 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//
+// $Id$
+//============================================================================
+
+// The console of the core, as the tools load it.  A tool includes this once
+// (instead of the OpenEmu stubs), and gets the OSystem and settings of the
+// core along with them.  The palette the core would be given is recorded,
+// so a tool can check who changes it.
+
+#include <fstream>
+#include <iterator>
+#include <vector>
+
+#include "Console.hxx"
+#include "Cart.hxx"
+#include "Props.hxx"
+#include "PropsSet.hxx"
+#include "Paddles.hxx"
+#include "SerialPort.hxx"
+#include "Settings.hxx"
+#include "SoundSDL.hxx"
+
+static SoundSDL *vcsSound = 0;
+#include "Stubs.hh"
+
+static OSystem osystem;
+static Settings settings(&osystem);
+
+// The palette last given to the core, and how many times it was given
+static const uInt32* corePalette = 0;
+static uInt32 corePaletteCalls = 0;
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+void stellaOESetPalette(const uInt32* palette)
+{
+  corePalette = palette;
+  ++corePaletteCalls;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// Read the given ROM, answering whether it could be (and isn't empty)
+static bool readROM(const string& filename, vector<uInt8>& image)
+{
+  ifstream in(filename.c_str(), ios_base::binary);
+  image.assign(istreambuf_iterator<char>(in), istreambuf_iterator<char>());
+  if(image.empty())
+  {
+    cerr << "ERROR: couldn't read " << filename << endl;
+    return false;
+  }
+  return true;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// Load the given ROM as the core does (with the given cartridge type, or
+// the one of its properties), and make it the console of the core, with
+// its video and sound initialized.  Answers NULL if it couldn't be loaded.
+static Console* loadConsole(const string& filename, const string& type = "")
+{
+  vector<uInt8> image;
+  if(!readROM(filename, image))
+    return NULL;
+
+  Console* console =
+    Console::create(&osystem, settings, &image[0], image.size(), type);
+  if(console == NULL)
+  {
+    cerr << "ERROR: couldn't create the cartridge for " << filename << endl;
+    return NULL;
+  }
+
+  osystem.myConsole = console;
+  console->initializeVideo();
+  console->initializeAudio();
+
+  return console;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// Delete the console of the core
+static void unloadConsole()
+{
+  delete osystem.myConsole;
+  osystem.myConsole = 0;
+}
@@ -0,0 +1,103 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2014 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//
+// $Id$
+//============================================================================
+
+// Measures the cost of bankswitching: the time taken by Cartridge::bank()
+// when cycling through all the banks of a ROM (as games which switch banks
+// many times per frame do), and the speed of emulation of the ROM itself.
+// Build it with the core sources (those compiled by the Xcode project) and
+// the OpenEmu stubs, ie:
+//
+//   g++ -O2 -DHAVE_INTTYPES -DHAVE_GETTIMEOFDAY -DTHUMB_SUPPORT
+//       -DBSPF_MAC_OSX -DSOUND_SUPPORT -I../../stubs -I../emucore
+//       -I../common ... bankswitch.cxx <core objects> -lpthread -lz
+//       -o bankswitch
+//
+// Usage: bankswitch <rom> [-type T] [-switches N] [-frames N]
+
+#include <cstdlib>
+
+#include "TIA.hxx"
+
+#include "ToolConsole.hh"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+static int usage()
+{
+  cerr << "usage: bankswitch <rom> [-type T] [-switches N] [-frames N]"
+       << endl;
+  return 2;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+int main(int argc, char* argv[])
+{
+  if(argc < 2)
+    return usage();
+
+  uInt32 switches = 10000000, frames = 3000;
+  string type;
+  for(int i = 2; i < argc; ++i)
+  {
+    string arg = argv[i];
+    if(arg == "-type" && i + 1 < argc)
+      type = argv[++i];
+    else if(arg == "-switches" && i + 1 < argc)
+      switches = atoi(argv[++i]);
+    else if(arg == "-frames" && i + 1 < argc)
+      frames = atoi(argv[++i]);
+    else
+      return usage();
+  }
+
+  Console* console = loadConsole(argv[1], type);
+  if(console == NULL)
+    return 2;
+  Cartridge& cart = console->cartridge();
+
+  cout << "ROM:          " << argv[1] << " (" << Cartridge::about() << ")" << endl;
+
+  // Switch through every bank in turn
+  uInt16 banks = cart.bankCount(), start = cart.bank();
+  uInt64 startTime = osystem.getTicks();
+  for(uInt32 i = 0; i < switches; ++i)
+    cart.bank(i % banks);
+  double seconds = (osystem.getTicks() - startTime) / 1000000.0;
+  cart.bank(start);
+
+  cout << "banks:        " << banks << endl
+       << "switches:     " << switches << " in " << seconds << " s" << endl
+       << "per switch:   "
+       << (switches > 0 ? seconds * 1000000000.0 / switches : 0)
+       << " ns" << endl;
+
+  // Then emulate the ROM, which switches banks as it sees fit
+  TIA& tia = console->tia();
+  startTime = osystem.getTicks();
+  for(uInt32 i = 0; i < frames; ++i)
+    tia.update();
+  seconds = (osystem.getTicks() - startTime) / 1000000.0;
+
+  cout << "frames:       " << frames << " in " << seconds << " s" << endl
+       << "speed:        " << (seconds > 0 ? frames / seconds : 0)
+       << " frames/s" << endl;
+
+  unloadConsole();
+
+  return 0;
+}
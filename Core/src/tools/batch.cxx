@@ -0,0 +1,179 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2014 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//
+// $Id$
+//============================================================================
+
+// Measures how BatchRunner scales with the number of threads, and checks
+// that the results don't depend on it.  Build it with the core sources
+// (those compiled by the Xcode project) and the OpenEmu stubs, ie:
+//
+//   g++ -O2 -DHAVE_INTTYPES -DHAVE_GETTIMEOFDAY -DTHUMB_SUPPORT
+//       -DBSPF_MAC_OSX -DSOUND_SUPPORT -I../../stubs -I../emucore
+//       -I../common ... batch.cxx <core objects> -lpthread -lz -o batch
+//
+// Usage: batch [-consoles N] [-steps N] [-skip N] [-threads N] [-ram] <rom>
+//
+// A console is first loaded as the core would, and then the same steps
+// (with random actions) are taken by a BatchRunner with 0 up to the given
+// number of worker threads.  For each, this reports the frames emulated
+// per second over all the consoles, and the speedup over no workers; it
+// can only be as large as the number of CPUs allows.  The results of every
+// step must be the same for any number of threads, and the consoles of the
+// runners must leave the palette of the core alone.  The exit status is 0
+// when they do.
+
+#include <cstdlib>
+#include <iomanip>
+#include <unistd.h>
+
+#include "BatchRunner.hxx"
+
+#include "ToolConsole.hh"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+static int usage()
+{
+  cerr << "usage: batch [-consoles N] [-steps N] [-skip N] [-threads N] "
+          "[-ram] <rom>" << endl;
+  return 2;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// A simple generator, so the actions are the same for every run
+static uInt32 nextRandom(uInt32& seed)
+{
+  seed = seed * 1103515245 + 12345;
+  return seed >> 16;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// Take the given steps, answering a hash of the results of each one, and
+// the time taken in microseconds
+static vector<uInt32> run(BatchRunner& runner, uInt32 steps, uInt64& time)
+{
+  vector<uInt32> hashes;
+  vector<uInt8> actions(runner.consoles());
+  uInt32 seed = 1;
+
+  uInt64 start = osystem.getTicks();
+  for(uInt32 step = 0; step < steps; ++step)
+  {
+    for(uInt32 i = 0; i < actions.size(); ++i)
+      actions[i] = nextRandom(seed) &
+        (BatchRunner::kUp | BatchRunner::kDown | BatchRunner::kLeft |
+         BatchRunner::kRight | BatchRunner::kFire);
+    runner.step(&actions[0]);
+
+    const uInt8* buffer = runner.buffer();
+    uInt32 hash = 2166136261u;
+    for(uInt32 i = 0; i < runner.bufferSize(); ++i)
+      hash = (hash ^ buffer[i]) * 16777619u;
+    hashes.push_back(hash);
+  }
+  time = osystem.getTicks() - start;
+
+  return hashes;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+int main(int argc, char* argv[])
+{
+  uInt32 consoles = 16, steps = 200, skip = 4, threads = 3;
+  bool observe = true;
+  int i = 1;
+  for(; i < argc && argv[i][0] == '-'; ++i)
+  {
+    string arg = argv[i];
+    if(arg == "-consoles" && i + 1 < argc)
+      consoles = BSPF_max(atoi(argv[++i]), 1);
+    else if(arg == "-steps" && i + 1 < argc)
+      steps = atoi(argv[++i]);
+    else if(arg == "-skip" && i + 1 < argc)
+      skip = atoi(argv[++i]);
+    else if(arg == "-threads" && i + 1 < argc)
+      threads = atoi(argv[++i]);
+    else if(arg == "-ram")
+      observe = false;
+    else
+      return usage();
+  }
+  if(i != argc - 1)
+    return usage();
+
+  // The console played by the core, which owns its palette
+  vector<uInt8> image;
+  Console* console = loadConsole(argv[i]);
+  if(console == NULL || !readROM(argv[i], image))
+    return 1;
+  const uInt32* palette = corePalette;
+  uInt32 paletteCalls = corePaletteCalls;
+
+  cout << consoles << " consoles, " << steps << " steps of " << skip
+       << " frames, " << (observe ? "84x84 observations" : "RAM only")
+       << ", " << sysconf(_SC_NPROCESSORS_ONLN) << " CPUs" << endl
+       << "threads      frames/s   speedup" << endl;
+
+  vector<uInt32> seeds(consoles), expected;
+  for(uInt32 c = 0; c < consoles; ++c)
+    seeds[c] = c + 1;
+  double base = 0;
+  bool ok = true;
+  for(uInt32 t = 0; t <= threads; ++t)
+  {
+    BatchRunner runner(t);
+    if(!runner.load(&image[0], image.size(), consoles,
+                    observe ? 84 : 0, observe ? 84 : 0))
+    {
+      cerr << "ERROR: couldn't load " << argv[i] << endl;
+      return 1;
+    }
+    runner.setFrameSkip(skip);
+    runner.setMaxPool(observe);
+
+    // The random generators are seeded from the time, which would change
+    // the initial RAM of some carts (ie, E7) from one runner to the next
+    runner.reset(&seeds[0]);
+
+    uInt64 time;
+    vector<uInt32> hashes = run(runner, steps, time);
+    double rate = time > 0 ? 1e6 * consoles * steps * skip / time : 0;
+    if(t == 0)
+    {
+      expected = hashes;
+      base = rate;
+    }
+
+    cout << setw(7) << t << setw(14) << fixed << setprecision(0) << rate
+         << setw(9) << setprecision(2) << (base > 0 ? rate / base : 0);
+    if(hashes != expected)
+    {
+      cout << "   DIFFERS";
+      ok = false;
+    }
+    cout << endl;
+  }
+
+  if(corePalette != palette || corePaletteCalls != paletteCalls)
+  {
+    cout << "The runners changed the palette of the core" << endl;
+    ok = false;
+  }
+
+  unloadConsole();
+
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,175 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2014 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//
+// $Id$
+//============================================================================
+
+// Checks that the SIMD versions of the NTSC filter's blitters produce
+// exactly the same output as the portable ones, and measures the speed of
+// each.  Build it with the filter itself, ie:
+//
+//   gcc -O2 -c ../common/tv_filters/atari_ntsc.c
+//   g++ -O2 -I../common/tv_filters ntsc.cxx atari_ntsc.o -o ntsc
+//
+// Usage: ntsc [-frames N]
+//
+// Random frames are filtered with random palettes, for each of the filter
+// presets, with single and double blits and for several frame widths.  The
+// output of every version must match the portable version byte for byte;
+// the exit status is 0 when it does.  Then full frames are filtered to
+// measure the throughput of each version, in output pixels per second.
+
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+
+#include "atari_ntsc.h"
+
+using namespace std;
+
+static const int kHeight = 250;
+static const int kWidths[] = { 1, 2, 3, 4, 5, 8, 13, 63, 64, 159, 160 };
+static const char* const kVersions[] = { "portable", "SSE2", "AVX2" };
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+static int usage()
+{
+  cerr << "usage: ntsc [-frames N]" << endl;
+  return 2;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// A simple generator, so the data is the same on every platform
+static unsigned int nextRandom(unsigned int& seed)
+{
+  seed = seed * 1103515245 + 12345;
+  return seed >> 16;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// Filters one frame of the given width with the version currently selected,
+// single or double, into 'out' (which is only cleared when it's resized)
+static void filter(const atari_ntsc_t* ntsc, const vector<unsigned char>& frame1,
+                   const vector<unsigned char>& frame2, int width, bool twice,
+                   vector<unsigned int>& out)
+{
+  long pitch = ATARI_NTSC_OUT_WIDTH(width) * sizeof(unsigned int);
+  out.resize(ATARI_NTSC_OUT_WIDTH(width) * kHeight);
+  if(twice)
+    atari_ntsc_blit_double(ntsc, &frame1[0], &frame2[0], 160, width, kHeight,
+                           &out[0], pitch);
+  else
+    atari_ntsc_blit_single(ntsc, &frame1[0], 160, width, kHeight,
+                           &out[0], pitch);
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+int main(int argc, char* argv[])
+{
+  int frames = 500;
+  for(int i = 1; i < argc; ++i)
+  {
+    string arg = argv[i];
+    if(arg == "-frames" && i + 1 < argc)
+      frames = atoi(argv[++i]);
+    else
+      return usage();
+  }
+
+  // Find out which versions this CPU can run
+  int best = atari_ntsc_set_simd(atari_ntsc_simd_best);
+  cout << "Versions: ";
+  for(int v = atari_ntsc_simd_none; v <= best; ++v)
+    cout << kVersions[v] << (v < best ? ", " : "\n");
+
+  const atari_ntsc_setup_t* const setups[] = {
+    &atari_ntsc_composite, &atari_ntsc_svideo, &atari_ntsc_rgb, &atari_ntsc_bad
+  };
+  const char* const setupNames[] = { "composite", "svideo", "rgb", "bad" };
+
+  atari_ntsc_t* ntsc = new atari_ntsc_t;
+  vector<unsigned char> palette(atari_ntsc_palette_size * 3);
+  vector<unsigned char> frame1(160 * kHeight), frame2(160 * kHeight);
+  vector<unsigned int> expected, actual;
+  unsigned int seed = 1;
+  bool ok = true;
+
+  for(int s = 0; s < 4; ++s)
+  {
+    for(size_t i = 0; i < palette.size(); ++i)
+      palette[i] = nextRandom(seed);
+    for(size_t i = 0; i < frame1.size(); ++i)
+    {
+      frame1[i] = nextRandom(seed);
+      frame2[i] = nextRandom(seed);
+    }
+    atari_ntsc_init(ntsc, setups[s], &palette[0]);
+
+    unsigned int compared = 0, mismatched = 0;
+    for(int twice = 0; twice < 2; ++twice)
+    {
+      for(size_t w = 0; w < sizeof(kWidths) / sizeof(kWidths[0]); ++w)
+      {
+        atari_ntsc_set_simd(atari_ntsc_simd_none);
+        expected.clear();
+        filter(ntsc, frame1, frame2, kWidths[w], twice, expected);
+        for(int v = atari_ntsc_simd_sse2; v <= best; ++v)
+        {
+          atari_ntsc_set_simd(v);
+          actual.clear();
+          filter(ntsc, frame1, frame2, kWidths[w], twice, actual);
+          ++compared;
+          if(memcmp(&expected[0], &actual[0],
+                    expected.size() * sizeof(unsigned int)) != 0)
+          {
+            ++mismatched;
+            cout << "  " << kVersions[v] << " DIFFERS: " << setupNames[s]
+                 << (twice ? ", double" : ", single") << ", width "
+                 << kWidths[w] << endl;
+          }
+        }
+      }
+    }
+    cout << setw(10) << left << setupNames[s] << right << setw(4)
+         << (compared - mismatched) << "/" << compared << " identical" << endl;
+    ok = ok && mismatched == 0;
+  }
+
+  // Throughput for full-width frames
+  cout << endl << "version       single Mpix/s    double Mpix/s" << endl;
+  for(int v = atari_ntsc_simd_none; v <= best; ++v)
+  {
+    atari_ntsc_set_simd(v);
+    cout << setw(10) << left << kVersions[v] << right;
+    for(int twice = 0; twice < 2; ++twice)
+    {
+      clock_t start = clock();
+      for(int f = 0; f < frames; ++f)
+        filter(ntsc, frame1, frame2, 160, twice, actual);
+      double secs = double(clock() - start) / CLOCKS_PER_SEC;
+      double pixels = double(ATARI_NTSC_OUT_WIDTH(160)) * kHeight * frames;
+      cout << setw(17) << fixed << setprecision(1)
+           << (secs > 0 ? pixels / secs / 1e6 : 0);
+    }
+    cout << endl;
+  }
+
+  delete ntsc;
+  return ok ? 0 : 1;
+}
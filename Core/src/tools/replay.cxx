@@ -0,0 +1,100 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2014 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//
+// $Id$
+//============================================================================
+
+// Plays an input movie back headless, as fast as possible, and reports
+// the speed of emulation and whether the frames still match the movie.
+// Build it with the core sources (those compiled by the Xcode project) and
+// the OpenEmu stubs, ie:
+//
+//   g++ -O2 -DHAVE_INTTYPES -DHAVE_GETTIMEOFDAY -DTHUMB_SUPPORT
+//       -DBSPF_MAC_OSX -DSOUND_SUPPORT -I../../stubs -I../emucore
+//       -I../common ... replay.cxx <core objects> -lpthread -lz -o replay
+//
+// Usage: replay <rom> <movie> [-first N] [-count N] [-snap prefix interval]
+//
+// The exit status is 0 when every checkpoint matched.
+
+#include <cstdlib>
+
+#include "Replay.hxx"
+
+#include "ToolConsole.hh"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+static int usage()
+{
+  cerr << "usage: replay <rom> <movie> [-first N] [-count N] "
+          "[-snap prefix interval]" << endl;
+  return 2;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+int main(int argc, char* argv[])
+{
+  if(argc < 3)
+    return usage();
+
+  uInt32 first = 0, count = 0, interval = 0;
+  string prefix;
+  for(int i = 3; i < argc; ++i)
+  {
+    string arg = argv[i];
+    if(arg == "-first" && i + 1 < argc)
+      first = atoi(argv[++i]);
+    else if(arg == "-count" && i + 1 < argc)
+      count = atoi(argv[++i]);
+    else if(arg == "-snap" && i + 2 < argc)
+    {
+      prefix = argv[++i];
+      interval = atoi(argv[++i]);
+    }
+    else
+      return usage();
+  }
+
+  Console* console = loadConsole(argv[1]);
+  if(console == NULL)
+    return 2;
+
+  Replay replay(&osystem);
+  replay.setSnapshots(prefix, interval);
+
+  Replay::Stats stats;
+  if(!replay.run(argv[2], stats, first, count))
+  {
+    cerr << "ERROR: " << argv[2] << " can't be played with this ROM" << endl;
+    return 2;
+  }
+
+  double seconds = stats.time / 1000000.0;
+  cout << "frames:       " << stats.frames << endl
+       << "time:         " << seconds << " s" << endl
+       << "speed:        " << (seconds > 0 ? stats.frames / seconds : 0)
+       << " frames/s" << endl
+       << "snapshots:    " << stats.snapshots << endl
+       << "checkpoints:  " << stats.checkpoints << endl
+       << "mismatches:   " << stats.mismatches;
+  if(stats.firstMismatch >= 0)
+    cout << " (first at frame " << stats.firstMismatch << ")";
+  cout << endl;
+
+  unloadConsole();
+
+  return stats.mismatches == 0 ? 0 : 1;
+}
@@ -0,0 +1,182 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2014 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//
+// $Id$
+//============================================================================
+
+// Measures the cost of running ahead (see RunAhead), for 0 up to a given
+// number of frames, and checks that it doesn't change the emulation.
+// Build it with the core sources (those compiled by the Xcode project) and
+// the OpenEmu stubs, ie:
+//
+//   g++ -O2 -DHAVE_INTTYPES -DHAVE_GETTIMEOFDAY -DTHUMB_SUPPORT
+//       -DBSPF_MAC_OSX -DSOUND_SUPPORT -I../../stubs -I../emucore
+//       -I../common ... runahead.cxx <core objects> -lpthread -lz -o runahead
+//
+// Usage: runahead <rom> [-frames N] [-max N]
+//
+// The same frames (with the fire button pressed now and then) are emulated
+// for each number of frames run ahead.  For each, this reports the time
+// per host frame, and its overhead over not running ahead.  It also checks
+// that the state at the end is the same as without running ahead, that the
+// sound generated from the queued register writes is the same for every
+// frame (as the core takes it, with SoundSDL::processFragment()), and that
+// each frame shown is the one generated that many frames later (when the
+// input doesn't change in between).  The exit status is 0 when it is.
+
+#include <cstdlib>
+#include <iomanip>
+
+#include "FrameInput.hxx"
+#include "Movie.hxx"
+#include "Random.hxx"
+#include "RunAhead.hxx"
+#include "System.hxx"
+#include "TIA.hxx"
+
+#include "ToolConsole.hh"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+static int usage()
+{
+  cerr << "usage: runahead <rom> [-frames N] [-max N]" << endl;
+  return 2;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// The fire button is held for 10 frames out of every 45
+static bool fireAt(uInt32 frame)
+{
+  return frame % 45 < 10;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+int main(int argc, char* argv[])
+{
+  if(argc < 2)
+    return usage();
+
+  uInt32 frames = 3000, maxAhead = 4;
+  for(int i = 2; i < argc; ++i)
+  {
+    string arg = argv[i];
+    if(arg == "-frames" && i + 1 < argc)
+      frames = atoi(argv[++i]);
+    else if(arg == "-max" && i + 1 < argc)
+      maxAhead = BSPF_min(uInt32(atoi(argv[++i])), uInt32(RunAhead::kMaxFrames));
+    else
+      return usage();
+  }
+
+  Console* console = loadConsole(argv[1]);
+  if(console == NULL)
+    return 2;
+  TIA& tia = console->tia();
+
+  // Let the game start up, then remember where every run starts from
+  FrameInput input;
+  input.clear();
+  for(uInt32 i = 0; i < 60; ++i)
+  {
+    console->applyInput(input);
+    tia.update();
+  }
+  Serializer start;
+  console->save(start);
+  uInt32 random = console->system().randGenerator().state();
+
+  cout << "ROM:  " << argv[1] << " (" << Cartridge::about() << ")" << endl
+       << "ahead    us/frame    overhead    shown ok    state    sound" << endl;
+
+  RunAhead runAhead(*console);
+  vector< vector<uInt32> > hashes(maxAhead + 1, vector<uInt32>(frames));
+  vector< vector<uInt32> > sounds(maxAhead + 1, vector<uInt32>(frames));
+  uInt32 samplesPerFrame = uInt32(31400.0f / console->getFramerate());
+  vector<Int16> samples(samplesPerFrame * 2);
+  uInt32 heard = 0;
+  string endState;
+  bool ok = true;
+
+  for(uInt32 ahead = 0; ahead <= maxAhead; ++ahead)
+  {
+    // The sound generator itself isn't part of the state
+    osystem.sound().reset();
+    start.reset();
+    console->load(start);
+    console->system().randGenerator().setState(random);
+    runAhead.setFrames(ahead);
+
+    uInt64 startTime = osystem.getTicks();
+    for(uInt32 frame = 0; frame < frames; ++frame)
+    {
+      input.joystick[0] = fireAt(frame) ? FrameInput::kFire : 0;
+      console->applyInput(input);
+      runAhead.update();
+      hashes[ahead][frame] = Movie::frameHash(tia);
+
+      vcsSound->processFragment(&samples[0], samplesPerFrame);
+      uInt32 hash = 2166136261u;
+      for(uInt32 i = 0; i < samples.size(); ++i)
+        hash = (hash ^ uInt16(samples[i])) * 16777619u;
+      sounds[ahead][frame] = hash;
+      if(ahead == 0 && hash != sounds[0][0])
+        ++heard;
+    }
+    double perFrame = double(osystem.getTicks() - startTime) / frames;
+
+    // The state and the sound must be those without running ahead
+    Serializer end;
+    console->save(end);
+    bool sameState = ahead == 0 || end.data() == endState;
+    if(ahead == 0)
+      endState = end.data();
+    bool sameSound = sounds[ahead] == sounds[0];
+
+    // Each frame shown must be the one generated 'ahead' frames later,
+    // unless the input changed in between
+    uInt32 compared = 0, matched = 0;
+    for(uInt32 frame = 0; frame + ahead < frames; ++frame)
+    {
+      if(fireAt(frame) != fireAt(frame + ahead))
+        continue;
+      ++compared;
+      if(hashes[ahead][frame] == hashes[0][frame + ahead])
+        ++matched;
+    }
+
+    static double base = 0;
+    if(ahead == 0)
+      base = perFrame;
+
+    cout << setw(5) << ahead << setw(12) << fixed << setprecision(1)
+         << perFrame << setw(11) << setprecision(2)
+         << (base > 0 ? perFrame / base : 0) << "x" << setw(7) << matched
+         << "/" << setw(5) << left << compared << right << setw(8)
+         << (sameState ? "same" : "DIFFERS") << setw(9)
+         << (sameSound ? "same" : "DIFFERS")
+         << (ahead > 0 && !runAhead.usesSnapshots() ? "  (serializer)" : "")
+         << endl;
+
+    ok = ok && sameState && sameSound && matched == compared;
+  }
+  if(heard == 0)
+    cout << "The game made no sound, so the sound wasn't really checked"
+         << endl;
+
+  unloadConsole();
+
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,183 @@
+//============================================================================
+//
+//   SSSS    tt          lll  lll
+//  SS  SS   tt           ll   ll
+//  SS     tttttt  eeee   ll   ll   aaaa
+//   SSSS    tt   ee  ee  ll   ll      aa
+//      SS   tt   eeeeee  ll   ll   aaaaa  --  "An Atari 2600 VCS Emulator"
+//  SS  SS   tt   ee      ll   ll  aa  aa
+//   SSSS     ttt  eeeee llll llll  aaaaa
+//
+// Copyright (c) 1995-2014 by Bradford W. Mott, Stephen Anthony
+// and the Stella Team
+//
+// See the file "License.txt" for information on usage and redistribution of
+// this file, and for a DISCLAIMER OF ALL WARRANTIES.
+//
+// $Id$
+//============================================================================
+
+// Checks that restoring a ConsoleSnapshot gives exactly the same state as
+// restoring a Serializer, for each ROM given (ie, one per bankswitching
+// scheme).  Build it with the core sources (those compiled by the Xcode
+// project) and the OpenEmu stubs, ie:
+//
+//   g++ -O2 -DHAVE_INTTYPES -DHAVE_GETTIMEOFDAY -DTHUMB_SUPPORT
+//       -DBSPF_MAC_OSX -DSOUND_SUPPORT -I../../stubs -I../emucore
+//       -I../common ... snapshot.cxx <core objects> -lpthread -lz
+//       -o snapshot
+//
+// Usage: snapshot [-checks N] [-frames N] <rom> [<rom> ...]
+//
+// Each ROM is run with the fire button pressed now and then.  At each
+// check, the state is saved both as a snapshot and with Console::save(),
+// and then the following frames are emulated.  The snapshot is restored,
+// and Console::save() must then write exactly what it did before; the
+// same frames must then be emulated again.  The sound isn't part of a
+// snapshot, so it's restored separately, with its own Serializer.  The
+// same is done by loading the Serializer instead, as a reference.  The
+// exit status is 0 when every check passed (schemes without snapshots
+// only check the Serializer).
+
+#include <cstdlib>
+#include <iomanip>
+
+#include "ConsoleSnapshot.hxx"
+#include "FrameInput.hxx"
+#include "Movie.hxx"
+#include "Random.hxx"
+#include "System.hxx"
+#include "TIA.hxx"
+
+#include "ToolConsole.hh"
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+static int usage()
+{
+  cerr << "usage: snapshot [-checks N] [-frames N] <rom> [<rom> ...]" << endl;
+  return 2;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// The fire button is held for 10 frames out of every 45
+static bool fireAt(uInt32 frame)
+{
+  return frame % 45 < 10;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// Emulate the given frames, returning the hash of each one
+static vector<uInt32> runFrames(Console& console, uInt32 first, uInt32 count)
+{
+  vector<uInt32> hashes;
+  FrameInput input;
+  input.clear();
+  for(uInt32 frame = first; frame < first + count; ++frame)
+  {
+    input.joystick[0] = fireAt(frame) ? FrameInput::kFire : 0;
+    console.applyInput(input);
+    console.tia().update();
+    hashes.push_back(Movie::frameHash(console.tia()));
+  }
+  return hashes;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// The state written by Console::save()
+static string savedState(Console& console)
+{
+  Serializer out;
+  console.save(out);
+  return out.data();
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+// Run the checks on one ROM, answering whether they all passed
+static bool checkROM(const char* filename, uInt32 checks, uInt32 frames)
+{
+  Console* console = loadConsole(filename);
+  if(console == NULL)
+    return false;
+  Random& random = console->system().randGenerator();
+
+  uInt32 frame = 0, snapshotOK = 0, serializerOK = 0;
+  bool snapshots = true;
+  ConsoleSnapshot snapshot;
+  for(uInt32 check = 0; check < checks; ++check)
+  {
+    // Vary the distance between checks, so they fall on different
+    // points of the input pattern
+    vector<uInt32> skipped = runFrames(*console, frame, 17 + check * 7);
+    frame += skipped.size();
+
+    snapshots = console->saveSnapshot(snapshot);
+    Serializer state;
+    console->save(state);
+    string expected = state.data();
+    uInt32 randomState = random.state();
+    Serializer sound;
+    osystem.sound().save(sound);
+    vector<uInt32> expectedFrames = runFrames(*console, frame, frames);
+
+    if(snapshots)
+    {
+      console->loadSnapshot(snapshot);
+      sound.reset();
+      osystem.sound().load(sound);
+      if(savedState(*console) == expected &&
+         runFrames(*console, frame, frames) == expectedFrames)
+        ++snapshotOK;
+    }
+
+    // The Serializer doesn't hold the state of the random generator
+    state.reset();
+    console->load(state);
+    random.setState(randomState);
+    if(savedState(*console) == expected &&
+       runFrames(*console, frame, frames) == expectedFrames)
+      ++serializerOK;
+
+    frame += frames;
+  }
+
+  // The scheme, from the class name (ie, "F8" for CartridgeF8)
+  string scheme = console->cartridge().name();
+  if(scheme.compare(0, 9, "Cartridge") == 0)
+    scheme.erase(0, 9);
+  cout << setw(20) << left << filename << setw(8) << scheme << right;
+  if(snapshots)
+    cout << setw(7) << snapshotOK << "/" << setw(3) << left << checks << right;
+  else
+    cout << setw(11) << "(none)";
+  cout << setw(7) << serializerOK << "/" << checks << endl;
+
+  unloadConsole();
+
+  return (!snapshots || snapshotOK == checks) && serializerOK == checks;
+}
+
+// - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+int main(int argc, char* argv[])
+{
+  uInt32 checks = 20, frames = 10;
+  int i = 1;
+  for(; i < argc && argv[i][0] == '-'; ++i)
+  {
+    string arg = argv[i];
+    if(arg == "-checks" && i + 1 < argc)
+      checks = atoi(argv[++i]);
+    else if(arg == "-frames" && i + 1 < argc)
+      frames = atoi(argv[++i]);
+    else
+      return usage();
+  }
+  if(i == argc)
+    return usage();
+
+  cout << "ROM                 type    snapshot  serializer" << endl;
+  bool ok = true;
+  for(; i < argc; ++i)
+    ok = checkROM(argv[i], checks, frames) && ok;
+
+  return ok ? 0 : 1;
+}
@@ -28,13 +28,25 @@
 #include <sys/time.h>
 #include "OSystem.hxx"
 
+// The core receives the palette of the console being played
+extern void stellaOESetPalette(const uInt32* palette);
+
+// The frame buffer of the first OSystem, which feeds the core
+static FrameBuffer *vcsFrameBuffer = 0;
+
 OSystem::OSystem()
 {
     myNVRamDir = ".";
     mySettings = 0;
     myFrameBuffer = new FrameBuffer();
-    vcsSound = new SoundSDL(this);
-    mySound = vcsSound;
+    mySound = new SoundSDL(this);
+    // Only the first OSystem (the one played by the core) feeds vcsSound
+    // and the palette; any other one (ie, those of a BatchRunner) keeps
+    // its sound and palette to itself
+    if(vcsSound == 0)
+        vcsSound = static_cast<SoundSDL*>(mySound);
+    if(vcsFrameBuffer == 0)
+        vcsFrameBuffer = myFrameBuffer;
     mySerialPort = new SerialPort();
     myEventHandler = new EventHandler(this);
     myPropSet = new PropertiesSet(this);
@@ -113,6 +125,8 @@ void FrameBuffer::showFrameStats(bool enable) { }
 
 // 0 to <counts> - 1, i_s caches the value of counts
 //#define iterateTimes(counts, i) for(unsigned int i = 0, i ## _s = counts; i < (i ## _s); i++)
-//void FrameBuffer::setTIAPalette(const uInt32* palette)
-//{
-//}
+void FrameBuffer::setTIAPalette(const uInt32* palette)
+{
+    if(this == vcsFrameBuffer)
+        stellaOESetPalette(palette);
+}
@@ -32,4 +32,18 @@
 
 OE_EXPORTED_CLASS
 @interface StellaGameCore : OEGameCore
+
+// When YES, frames are no longer converted to BGRA: the video buffer holds
+// the TIA's palette indices (one byte per pixel, reported as GL_RED /
+// GL_UNSIGNED_BYTE), and the host maps them through videoPalette itself.
+// The phosphor effect is not applied in this mode.
+@property (nonatomic) BOOL usesIndexedVideo;
+
+// The palette indices of the last frame, straight from the TIA (160 bytes
+// per line, screenRect.size.height lines); valid until the next frame.
+@property (nonatomic, readonly) const uint8_t *indexedVideoBuffer;
+
+// The 256 colors of the active palette, as 0x00RRGGBB.
+@property (nonatomic, readonly) const uint32_t *videoPalette;
+
 @end
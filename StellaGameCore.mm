@@ -42,6 +42,9 @@
 #include "PropsSet.hxx"
 #include "Paddles.hxx"
 #include "SoundSDL.hxx"
+#include "PaletteExpand.hxx"
+#include "PhosphorBlend.hxx"
+#include "RunAhead.hxx"
 
 static SoundSDL *vcsSound = 0;
 #include "Stubs.hh"
@@ -51,6 +54,7 @@ static Settings *settings = 0;
 static OSystem osystem;
 static StateManager stateManager(&osystem);
 const uint32_t *Palette;
+static uint32_t PaletteGeneration;
 
 #define OptionDefault(_NAME_, _PREFKEY_) @{ OEGameCoreDisplayModeNameKey : _NAME_, OEGameCoreDisplayModePrefKeyNameKey : _PREFKEY_, OEGameCoreDisplayModeStateKey : @YES, }
 #define Option(_NAME_, _PREFKEY_) @{ OEGameCoreDisplayModeNameKey : _NAME_, OEGameCoreDisplayModePrefKeyNameKey : _PREFKEY_, OEGameCoreDisplayModeStateKey : @NO, }
@@ -60,10 +64,13 @@ const uint32_t *Palette;
 #define Label(_NAME_) @{ OEGameCoreDisplayModeLabelKey : _NAME_, }
 #define SeparatorItem() @{ OEGameCoreDisplayModeSeparatorItemKey : @"",}
 
-// Set the palette for the current Stella instance
+// Set the palette for the current Stella instance; its contents may have
+// changed even if the pointer hasn't (ie, a palette regenerated in place),
+// so every call counts as a new palette
 void stellaOESetPalette(const uInt32 *palette)
 {
     Palette = palette;
+    PaletteGeneration++;
 }
 
 @interface StellaGameCore () <OE2600SystemResponderClient>
@@ -72,6 +79,12 @@ void stellaOESetPalette(const uInt32 *palette)
     uint32_t *_activeVideoBuffer;
     int16_t *_sampleBuffer;
     int _videoWidth, _videoHeight;
+    const uint32_t *_lastVideoBuffer;
+    uint32_t _lastPaletteGeneration;
+    int _lastVideoHeight;
+    Common::PhosphorBlend *_phosphor;
+    RunAhead *_runAhead;
+    BOOL _usesIndexedVideo;
     NSMutableArray <NSMutableDictionary <NSString *, id> *> *_availableDisplayModes;
 }
 
@@ -99,6 +112,10 @@ void stellaOESetPalette(const uInt32 *palette)
     _videoBuffer = nil;
     free(_sampleBuffer);
     _sampleBuffer = nil;
+    delete _phosphor;
+    _phosphor = nullptr;
+    delete _runAhead;
+    _runAhead = nullptr;
     
     if (console) {
         delete console;
@@ -115,8 +132,8 @@ void stellaOESetPalette(const uInt32 *palette)
 
 - (BOOL)loadFileAtPath:(NSString *)path error:(NSError **)error
 {
-    // Load ROM to memory
-    NSData *dataObj = [NSData dataWithContentsOfFile:path.stringByStandardizingPath];
+    // Map the ROM into memory; the cart keeps its own (shared) copy of the image
+    NSData *dataObj = [NSData dataWithContentsOfFile:path.stringByStandardizingPath options:NSDataReadingMappedIfSafe error:error];
     if(dataObj == nil) return NO;
     const void *data = dataObj.bytes;
     NSUInteger size = dataObj.length;
@@ -141,6 +158,18 @@ void stellaOESetPalette(const uInt32 *palette)
     console = new Console(&osystem, cartridge, props);
     osystem.myConsole = console;
 
+    // Games which flicker objects on alternate frames are blended
+    if(props.get(Display_Phosphor) == "YES")
+    {
+        _phosphor = new Common::PhosphorBlend();
+        _phosphor->setBlend(atoi(props.get(Display_PPBlend).c_str()));
+        _phosphor->setMode(Common::PhosphorBlend::modeFromString(settings->getString("tv_phosphor")));
+    }
+
+    // Frames may be run ahead of the real one, to hide the input latency
+    _runAhead = new RunAhead(*console);
+    _runAhead->setFrames(settings->getInt("runahead"));
+
     //tia.enableAutoFrame(false);
     console->initializeVideo();
     console->initializeAudio();
@@ -162,19 +191,56 @@ void stellaOESetPalette(const uInt32 *palette)
 {
     uint32_t tiaSamplesPerFrame = 31400.0f/console->getFramerate();
 
+    // Record the input of this frame, or replace it with the recorded input
+    if (stateManager.isActive())
+        stateManager.update();
+
     console->controller(Controller::Left).update();
     console->controller(Controller::Right).update();
     console->switches().update();
 
     TIA &tia = console->tia();
-    tia.update();
+    _runAhead->update();
 
     // Video
     _videoWidth = tia.width();
     _videoHeight = tia.height();
 
-    for (unsigned int i = 0; i < _videoHeight * _videoWidth; ++i)
-        _activeVideoBuffer[i] = Palette[tia.currentFrameBuffer()[i]];
+    if (_phosphor && !_usesIndexedVideo)
+    {
+        // Every pixel may fade, so the whole frame is converted and then
+        // blended with the previous ones
+        Common::PaletteExpand::expand(_activeVideoBuffer, _videoWidth,
+                                      tia.currentFrameBuffer(), _videoWidth,
+                                      _videoWidth, _videoHeight, Palette);
+        _phosphor->blend(_activeVideoBuffer, _videoWidth, _videoWidth, _videoHeight);
+    }
+    else
+    {
+        // When the previous frame was converted into this same buffer, only
+        // the lines that have changed since then need to be converted again
+        uInt32 line = 0, count;
+        if (_activeVideoBuffer != _lastVideoBuffer || PaletteGeneration != _lastPaletteGeneration ||
+            _videoHeight != _lastVideoHeight)
+            count = _videoHeight;
+        else
+            count = tia.nextDirtyLines(line);
+
+        for (; count > 0; line += count, count = tia.nextDirtyLines(line))
+        {
+            if (_usesIndexedVideo)
+                memcpy((uint8_t *)_activeVideoBuffer + line * _videoWidth,
+                       tia.currentFrameBuffer() + line * _videoWidth, count * _videoWidth);
+            else
+                Common::PaletteExpand::expand(_activeVideoBuffer + line * _videoWidth, _videoWidth,
+                                              tia.currentFrameBuffer() + line * _videoWidth, _videoWidth,
+                                              _videoWidth, count, Palette);
+        }
+    }
+
+    _lastVideoBuffer = _activeVideoBuffer;
+    _lastPaletteGeneration = PaletteGeneration;
+    _lastVideoHeight = _videoHeight;
 
     // Audio
     vcsSound->processFragment(_sampleBuffer, tiaSamplesPerFrame);
@@ -227,12 +293,38 @@ void stellaOESetPalette(const uInt32 *palette)
 
 - (GLenum)pixelFormat
 {
-    return GL_BGRA;
+    return _usesIndexedVideo ? GL_RED : GL_BGRA;
 }
 
 - (GLenum)pixelType
 {
-    return GL_UNSIGNED_INT_8_8_8_8_REV;
+    return _usesIndexedVideo ? GL_UNSIGNED_BYTE : GL_UNSIGNED_INT_8_8_8_8_REV;
+}
+
+- (BOOL)usesIndexedVideo
+{
+    return _usesIndexedVideo;
+}
+
+- (void)setUsesIndexedVideo:(BOOL)usesIndexedVideo
+{
+    _usesIndexedVideo = usesIndexedVideo;
+
+    // The buffer now holds the other format, so the next frame is converted
+    // in full, and the phosphor history (if any) starts over
+    _lastVideoBuffer = nullptr;
+    if (_phosphor)
+        _phosphor->reset();
+}
+
+- (const uint8_t *)indexedVideoBuffer
+{
+    return console ? console->tia().currentFrameBuffer() : nullptr;
+}
+
+- (const uint32_t *)videoPalette
+{
+    return console ? console->currentPalette() : nullptr;
 }
 
 # pragma mark - Audio
@@ -436,6 +528,13 @@ void stellaOESetPalette(const uInt32 *palette)
           isPAL ? Option(@"NTSC50", @"format") : Option(@"NTSC", @"format"),
           isPAL ? Option(@"PAL", @"format")    : Option(@"PAL60", @"format"),
           isPAL ? Option(@"SECAM", @"format")  : Option(@"SECAM60", @"format"),
+          SeparatorItem(),
+          Label(@"Run-Ahead"),
+          OptionDefault(@"Off", @"runAhead"),
+          Option(@"1 Frame", @"runAhead"),
+          Option(@"2 Frames", @"runAhead"),
+          Option(@"3 Frames", @"runAhead"),
+          Option(@"4 Frames", @"runAhead"),
           ];
 
         // Deep mutable copy
@@ -450,23 +549,24 @@ void stellaOESetPalette(const uInt32 *palette)
     if (_availableDisplayModes.count == 0)
         [self displayModes];
 
-    // First check if 'displayMode' is valid
-    BOOL isValidDisplayMode = NO;
+    // First check if 'displayMode' is valid, and find its group
+    NSString *prefKey = nil;
 
     for (NSDictionary *modeDict in _availableDisplayModes) {
         if ([modeDict[OEGameCoreDisplayModeNameKey] isEqualToString:displayMode]) {
-            isValidDisplayMode = YES;
+            prefKey = modeDict[OEGameCoreDisplayModePrefKeyNameKey];
             break;
         }
     }
 
     // Disallow a 'displayMode' not found in _availableDisplayModes
-    if (!isValidDisplayMode)
+    if (!prefKey)
         return;
 
-    // Handle option state changes
+    // Handle option state changes, within the group of the option
     for (NSMutableDictionary *optionDict in _availableDisplayModes) {
-        if (!optionDict[OEGameCoreDisplayModeNameKey])
+        if (!optionDict[OEGameCoreDisplayModeNameKey] ||
+            ![optionDict[OEGameCoreDisplayModePrefKeyNameKey] isEqualToString:prefKey])
             continue;
         // Mutually exclusive option state change
         else if ([optionDict[OEGameCoreDisplayModeNameKey] isEqualToString:displayMode])
@@ -476,7 +576,9 @@ void stellaOESetPalette(const uInt32 *palette)
             optionDict[OEGameCoreDisplayModeStateKey] = @NO;
     }
 
-    if ([displayMode isEqualToString:@"Auto"])
+    if ([prefKey isEqualToString:@"runAhead"])
+        _runAhead->setFrames(displayMode.intValue);   // "Off" is 0
+    else if ([displayMode isEqualToString:@"Auto"])
         console->setFormat(0);
     else if ([displayMode isEqualToString:@"NTSC"])
         console->setFormat(1);
@@ -499,6 +601,12 @@ void stellaOESetPalette(const uInt32 *palette)
     if (lastFormat && ![lastFormat isEqualToString:@"Auto"]) {
         [self changeDisplayWithMode:lastFormat];
     }
+
+    // Restore run-ahead
+    NSString *lastRunAhead = self.displayModeInfo[@"runAhead"];
+    if (lastRunAhead && ![lastRunAhead isEqualToString:@"Off"]) {
+        [self changeDisplayWithMode:lastRunAhead];
+    }
 }
 
 @end